@@ -125,6 +125,10 @@ void Config::ReadValues() {
     Settings::values.use_disk_shader_cache =
         sdl2_config->GetBoolean("Renderer", "use_disk_shader_cache", true);
     Settings::values.use_vsync_new = sdl2_config->GetBoolean("Renderer", "use_vsync_new", true);
+    Settings::values.frames_in_flight =
+        static_cast<u16>(sdl2_config->GetInteger("Renderer", "frames_in_flight", 4));
+    Settings::values.vram_budget =
+        static_cast<u16>(sdl2_config->GetInteger("Renderer", "vram_budget", 80));
 
     // Work around to map Android setting for enabling the frame limiter to the format Citra expects
     if (sdl2_config->GetBoolean("Renderer", "use_frame_limit", true)) {
@@ -196,6 +200,13 @@ void Config::ReadValues() {
     // Data Storage
     Settings::values.use_virtual_sd =
         sdl2_config->GetBoolean("Data Storage", "use_virtual_sd", true);
+    Settings::values.incremental_save_states =
+        sdl2_config->GetBoolean("Data Storage", "incremental_save_states", false);
+    Settings::values.enable_rewind = sdl2_config->GetBoolean("Data Storage", "enable_rewind", false);
+    Settings::values.rewind_interval =
+        static_cast<u32>(sdl2_config->GetInteger("Data Storage", "rewind_interval", 30));
+    Settings::values.rewind_buffer_size =
+        static_cast<u32>(sdl2_config->GetInteger("Data Storage", "rewind_buffer_size", 512));
 
     // System
     Settings::values.is_new_3ds = sdl2_config->GetBoolean("System", "is_new_3ds", true);
@@ -247,6 +258,7 @@ void Config::ReadValues() {
 
     // Miscellaneous
     Settings::values.log_filter = sdl2_config->GetString("Miscellaneous", "log_filter", "*:Info");
+    Settings::values.binary_log = sdl2_config->GetBoolean("Miscellaneous", "binary_log", false);
 
     // Debugging
     Settings::values.record_frame_times =
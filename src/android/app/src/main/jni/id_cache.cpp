@@ -160,8 +160,13 @@ jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     Log::SetGlobalFilter(log_filter);
     Log::AddBackend(std::make_unique<Log::LogcatBackend>());
     FileUtil::CreateFullPath(FileUtil::GetUserPath(FileUtil::UserPath::LogDir));
-    Log::AddBackend(std::make_unique<Log::FileBackend>(
-        FileUtil::GetUserPath(FileUtil::UserPath::LogDir) + LOG_FILE));
+    if (Settings::values.binary_log) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(
+            FileUtil::GetUserPath(FileUtil::UserPath::LogDir) + BINARY_LOG_FILE));
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(
+            FileUtil::GetUserPath(FileUtil::UserPath::LogDir) + LOG_FILE));
+    }
     LOG_INFO(Frontend, "Logging backend initialised");
 
     // Initialize misc classes
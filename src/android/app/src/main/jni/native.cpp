@@ -126,7 +126,11 @@ static void TryShutdown() {
     }
 
     window->DoneCurrent();
-    Core::System::GetInstance().Shutdown();
+    try {
+        Core::System::GetInstance().Shutdown();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Frontend, "Error saving: {}", e.what());
+    }
     window.reset();
     InputManager::Shutdown();
     MicroProfileShutdown();
@@ -0,0 +1,141 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <fmt/format.h>
+#include "citra/benchmark.h"
+#include "common/microprofile.h"
+#include "common/scm_rev.h"
+
+namespace Benchmark {
+
+namespace {
+
+/// Escapes the characters that cannot appear verbatim in a JSON string
+std::string EscapeJson(const std::string& str) {
+    std::string escaped;
+    escaped.reserve(str.size());
+    for (const char c : str) {
+        switch (c) {
+        case '"':
+            escaped += "\\\"";
+            break;
+        case '\\':
+            escaped += "\\\\";
+            break;
+        case '\n':
+            escaped += "\\n";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                escaped += fmt::format("\\u{:04x}", static_cast<int>(c));
+            } else {
+                escaped += c;
+            }
+            break;
+        }
+    }
+    return escaped;
+}
+
+/// Returns the nearest-rank percentile of a sorted sample set
+double Percentile(const std::vector<double>& sorted, double percent) {
+    if (sorted.empty()) {
+        return 0.0;
+    }
+
+    const auto rank = static_cast<std::size_t>(std::ceil(percent / 100.0 * sorted.size()));
+    return sorted[std::clamp<std::size_t>(rank, 1, sorted.size()) - 1];
+}
+
+std::string FormatProfile() {
+#if MICROPROFILE_ENABLED
+    MicroProfile& profile = *MicroProfileGet();
+    const float ticks_to_ms = MicroProfileTickToMsMultiplier(MicroProfileTicksPerSecondCpu());
+
+    struct GroupTotal {
+        double time_ms = 0.0;
+        u64 count = 0;
+    };
+
+    std::vector<GroupTotal> totals(profile.nGroupCount);
+    for (u32 i = 0; i < profile.nTotalTimers; i++) {
+        const u32 group = profile.TimerInfo[i].nGroupIndex;
+        if (group < totals.size()) {
+            totals[group].time_ms += profile.AggregateTimers[i].nTicks * ticks_to_ms;
+            totals[group].count += profile.AggregateTimers[i].nCount;
+        }
+    }
+
+    std::string groups;
+    for (u32 i = 0; i < totals.size(); i++) {
+        if (totals[i].count == 0) {
+            continue;
+        }
+
+        groups += fmt::format("{}\n    \"{}\": {{\"total_ms\": {:.3f}, \"count\": {}}}",
+                              groups.empty() ? "" : ",", EscapeJson(profile.GroupInfo[i].pName),
+                              totals[i].time_ms, totals[i].count);
+    }
+
+    return groups.empty() ? "{}" : fmt::format("{{{}\n  }}", groups);
+#else
+    return "{}";
+#endif
+}
+
+} // Anonymous namespace
+
+void BeginProfiling() {
+#if MICROPROFILE_ENABLED
+    MicroProfileSetForceEnable(true);
+    MicroProfileSetEnableAllGroups(true);
+    // Keep accumulating for the whole run, this also clears the current totals
+    MicroProfileSetAggregateFrames(std::numeric_limits<int>::max());
+#endif
+}
+
+std::string FormatReport(const Results& results) {
+    std::vector<double> sorted = results.frametimes;
+    std::sort(sorted.begin(), sorted.end());
+
+    const double mean =
+        sorted.empty() ? 0.0
+                       : std::accumulate(sorted.begin(), sorted.end(), 0.0) / sorted.size();
+    const double speed =
+        results.wall_time > 0.0 ? results.emulated_time / results.wall_time : 0.0;
+
+    return fmt::format(
+        "{{\n"
+        "  \"version\": \"{}-{}\",\n"
+        "  \"title\": \"{}\",\n"
+        "  \"movie\": \"{}\",\n"
+        "  \"frames\": {},\n"
+        "  \"ticks\": {},\n"
+        "  \"wall_time_s\": {:.3f},\n"
+        "  \"emulated_time_s\": {:.3f},\n"
+        "  \"emulation_speed\": {:.4f},\n"
+        "  \"frametime_ms\": {{\n"
+        "    \"samples\": {},\n"
+        "    \"mean\": {:.3f},\n"
+        "    \"min\": {:.3f},\n"
+        "    \"p50\": {:.3f},\n"
+        "    \"p90\": {:.3f},\n"
+        "    \"p95\": {:.3f},\n"
+        "    \"p99\": {:.3f},\n"
+        "    \"max\": {:.3f}\n"
+        "  }},\n"
+        "  \"microprofile\": {}\n"
+        "}}\n",
+        Common::g_scm_branch, Common::g_scm_desc, EscapeJson(results.title),
+        EscapeJson(results.movie), results.frames, results.ticks, results.wall_time,
+        results.emulated_time, speed, sorted.size(), mean, sorted.empty() ? 0.0 : sorted.front(),
+        Percentile(sorted, 50), Percentile(sorted, 90), Percentile(sorted, 95),
+        Percentile(sorted, 99), sorted.empty() ? 0.0 : sorted.back(), FormatProfile());
+}
+
+} // namespace Benchmark
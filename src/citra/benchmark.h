@@ -0,0 +1,30 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Benchmark {
+
+/// Measurements of a headless benchmark run
+struct Results {
+    std::string title;              ///< Path of the benchmarked application
+    std::string movie;              ///< Path of the movie driving the inputs, empty if none
+    u64 frames = 0;                 ///< System frames emulated during the run
+    s64 ticks = 0;                  ///< Emulated CPU ticks during the run
+    double wall_time = 0.0;         ///< Walltime of the run in seconds
+    double emulated_time = 0.0;     ///< Emulated time of the run in seconds
+    std::vector<double> frametimes; ///< Walltime per system frame in milliseconds
+};
+
+/// Enables microprofile timers and clears their totals so they only cover the benchmark run
+void BeginProfiling();
+
+/// Formats the results and the microprofile group totals as a JSON document
+std::string FormatReport(const Results& results);
+
+} // namespace Benchmark
@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <chrono>
+#include <fstream>
 #include <iostream>
 #include <memory>
 #include <regex>
@@ -18,6 +20,7 @@
 #include <shellapi.h>
 #endif
 
+#include "citra/benchmark.h"
 #include "citra/config.h"
 #include "citra/emu_window/emu_window_sdl2.h"
 #include "citra/lodepng_image_interface.h"
@@ -68,6 +71,11 @@ static void PrintHelp(const char* argv0) {
                  "-a, --movie-record-author=AUTHOR Sets the author of the movie to be recorded\n"
                  "-p, --movie-play=[file]    Playback the movie (game inputs) from the given file\n"
                  "-d, --dump-video=[file]    Dumps audio and video to the given video file\n"
+                 "-b, --benchmark=FRAMES     Run headless and unthrottled for the given number of "
+                 "frames and print a JSON performance report\n"
+                 "--benchmark-ticks=TICKS    Run the benchmark for the given number of emulated "
+                 "CPU ticks instead\n"
+                 "--benchmark-report=[file]  Write the benchmark report to the given file\n"
                  "-f, --fullscreen     Start in fullscreen mode\n"
                  "-h, --help           Display this help and exit\n"
                  "-v, --version        Output version information and exit\n";
@@ -178,7 +186,11 @@ static void InitializeLogging() {
 
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
-    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.binary_log) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(log_dir + BINARY_LOG_FILE));
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -195,6 +207,9 @@ int main(int argc, char** argv) {
     std::string movie_record_author;
     std::string movie_play;
     std::string dump_video;
+    u64 benchmark_frames = 0;
+    u64 benchmark_ticks = 0;
+    std::string benchmark_report;
 
     InitializeLogging();
 
@@ -225,6 +240,9 @@ int main(int argc, char** argv) {
         {"movie-record-author", required_argument, 0, 'a'},
         {"movie-play", required_argument, 0, 'p'},
         {"dump-video", required_argument, 0, 'd'},
+        {"benchmark", required_argument, 0, 'b'},
+        {"benchmark-ticks", required_argument, 0, 't'},
+        {"benchmark-report", required_argument, 0, 'o'},
         {"fullscreen", no_argument, 0, 'f'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
@@ -232,7 +250,7 @@ int main(int argc, char** argv) {
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "g:i:m:r:p:fhv", long_options, &option_index);
+        int arg = getopt_long(argc, argv, "g:i:m:r:p:b:fhv", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'g':
@@ -301,6 +319,26 @@ int main(int argc, char** argv) {
             case 'd':
                 dump_video = optarg;
                 break;
+            case 'b':
+            case 't': {
+                errno = 0;
+                const u64 budget = strtoull(optarg, &endarg, 0);
+                if (endarg == optarg || budget == 0)
+                    errno = EINVAL;
+                if (errno != 0) {
+                    perror(arg == 'b' ? "--benchmark" : "--benchmark-ticks");
+                    exit(1);
+                }
+                if (arg == 'b') {
+                    benchmark_frames = budget;
+                } else {
+                    benchmark_ticks = budget;
+                }
+                break;
+            }
+            case 'o':
+                benchmark_report = optarg;
+                break;
             case 'f':
                 fullscreen = true;
                 LOG_INFO(Frontend, "Starting in fullscreen mode...");
@@ -346,9 +384,20 @@ int main(int argc, char** argv) {
         Core::Movie::GetInstance().PrepareForPlayback(movie_play);
     }
 
+    const bool benchmark = benchmark_frames != 0 || benchmark_ticks != 0;
+    if (benchmark && movie_play.empty()) {
+        LOG_WARNING(Frontend, "Benchmarking without --movie-play, inputs are not deterministic");
+    }
+
     // Apply the command line arguments
     Settings::values.gdbstub_port = gdb_port;
     Settings::values.use_gdbstub = use_gdbstub;
+    if (benchmark) {
+        // Measure how fast the emulator can go, not how well it keeps up with the display
+        Settings::values.use_frame_limit_alternate = false;
+        Settings::values.frame_limit = 0;
+        Settings::values.use_vsync_new = false;
+    }
     Settings::Apply();
 
     // Register frontend applets
@@ -357,7 +406,8 @@ int main(int argc, char** argv) {
     // Register generic image interface
     Core::System::GetInstance().RegisterImageInterface(std::make_shared<LodePNGImageInterface>());
 
-    std::unique_ptr<EmuWindow_SDL2> emu_window{std::make_unique<EmuWindow_SDL2>(fullscreen)};
+    std::unique_ptr<EmuWindow_SDL2> emu_window{
+        std::make_unique<EmuWindow_SDL2>(fullscreen, benchmark)};
     const auto scope = emu_window->Acquire();
     Core::System& system = Core::System::GetInstance();
 
@@ -438,9 +488,35 @@ int main(int argc, char** argv) {
                       total);
         });
 
+    // The benchmark ends when its budget is exhausted or the movie runs out of inputs
+    std::atomic_bool movie_finished = false;
+    if (benchmark && !movie_play.empty()) {
+        Core::Movie::GetInstance().SetPlaybackCompletionCallback(
+            [&movie_finished] { movie_finished = true; });
+    }
+
+    using Clock = std::chrono::steady_clock;
+    const auto benchmark_begin = Clock::now();
+    const auto system_time_begin = system.CoreTiming().GetGlobalTimeUs();
+    const s64 ticks_begin = system.CoreTiming().GetGlobalTicks();
+    const u64 frames_begin = system.perf_stats->GetSystemFrameCount();
+    if (benchmark) {
+        Benchmark::BeginProfiling();
+    }
+
     while (emu_window->IsOpen()) {
         const auto result = system.RunLoop();
 
+        if (benchmark) {
+            const u64 frames = system.perf_stats->GetSystemFrameCount() - frames_begin;
+            const s64 ticks = system.CoreTiming().GetGlobalTicks() - ticks_begin;
+            if ((benchmark_frames != 0 && frames >= benchmark_frames) ||
+                (benchmark_ticks != 0 && static_cast<u64>(ticks) >= benchmark_ticks) ||
+                movie_finished) {
+                emu_window->RequestClose();
+            }
+        }
+
         switch (result) {
         case Core::System::ResultStatus::ShutdownRequested:
             emu_window->RequestClose();
@@ -454,12 +530,39 @@ int main(int argc, char** argv) {
     }
     render_thread.join();
 
+    if (benchmark) {
+        const Benchmark::Results results = {
+            .title = filepath,
+            .movie = movie_play,
+            .frames = system.perf_stats->GetSystemFrameCount() - frames_begin,
+            .ticks = system.CoreTiming().GetGlobalTicks() - ticks_begin,
+            .wall_time = std::chrono::duration<double>(Clock::now() - benchmark_begin).count(),
+            .emulated_time = std::chrono::duration<double>(
+                                 system.CoreTiming().GetGlobalTimeUs() - system_time_begin)
+                                 .count(),
+            .frametimes = system.perf_stats->GetFrametimeHistory(),
+        };
+
+        const std::string report = Benchmark::FormatReport(results);
+        if (benchmark_report.empty()) {
+            std::cout << report;
+        } else if (std::ofstream file{benchmark_report}; file) {
+            file << report;
+        } else {
+            LOG_ERROR(Frontend, "Could not write benchmark report to {}", benchmark_report);
+        }
+    }
+
     Core::Movie::GetInstance().Shutdown();
     if (system.VideoDumper().IsDumping()) {
         system.VideoDumper().StopDumping();
     }
 
-    system.Shutdown();
+    try {
+        system.Shutdown();
+    } catch (const std::exception& e) {
+        LOG_ERROR(Frontend, "Error saving: {}", e.what());
+    }
 
     detached_tasks.WaitForAllTasks();
     return 0;
@@ -135,6 +135,10 @@ void Config::ReadValues() {
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "frame_limit_alternate", 200));
     Settings::values.use_vsync_new =
         static_cast<u16>(sdl2_config->GetInteger("Renderer", "use_vsync_new", 1));
+    Settings::values.frames_in_flight =
+        static_cast<u16>(sdl2_config->GetInteger("Renderer", "frames_in_flight", 4));
+    Settings::values.vram_budget =
+        static_cast<u16>(sdl2_config->GetInteger("Renderer", "vram_budget", 80));
     Settings::values.texture_filter_name =
         sdl2_config->GetString("Renderer", "texture_filter_name", "none");
 
@@ -203,6 +207,13 @@ void Config::ReadValues() {
     // Data Storage
     Settings::values.use_virtual_sd =
         sdl2_config->GetBoolean("Data Storage", "use_virtual_sd", true);
+    Settings::values.incremental_save_states =
+        sdl2_config->GetBoolean("Data Storage", "incremental_save_states", false);
+    Settings::values.enable_rewind = sdl2_config->GetBoolean("Data Storage", "enable_rewind", false);
+    Settings::values.rewind_interval =
+        static_cast<u32>(sdl2_config->GetInteger("Data Storage", "rewind_interval", 30));
+    Settings::values.rewind_buffer_size =
+        static_cast<u32>(sdl2_config->GetInteger("Data Storage", "rewind_buffer_size", 512));
 
     const std::string default_nand_dir = FileUtil::GetDefaultUserPath(FileUtil::UserPath::NANDDir);
     FileUtil::UpdateUserPath(
@@ -263,6 +274,7 @@ void Config::ReadValues() {
 
     // Miscellaneous
     Settings::values.log_filter = sdl2_config->GetString("Miscellaneous", "log_filter", "*:Info");
+    Settings::values.binary_log = sdl2_config->GetBoolean("Miscellaneous", "binary_log", false);
 
     // Debugging
     Settings::values.record_frame_times =
@@ -127,6 +127,16 @@ use_shader_jit =
 # 0: Off, 1 (default): On
 use_vsync_new =
 
+# Number of frames the CPU may record ahead of the GPU with the Vulkan renderer. Lower values
+# reduce input latency, higher values keep the GPU busier.
+# 1 - 4 (default: 4)
+frames_in_flight =
+
+# Percentage of the device memory budget the texture cache may use with the Vulkan renderer.
+# Surfaces that have not been used recently are evicted when it is exceeded.
+# 10 - 100 (default: 80)
+vram_budget =
+
 # Reduce stuttering by storing and loading generated shaders to disk
 # 0: Off, 1 (default. On)
 use_disk_shader_cache =
@@ -250,6 +260,22 @@ volume =
 # 1 (default): Yes, 0: No
 use_virtual_sd =
 
+# Whether save states only store the memory pages that changed since a shared base snapshot
+# 0 (default): No, 1: Yes
+incremental_save_states =
+
+# Whether to keep in-memory snapshots that emulation can be rewound to
+# 0 (default): No, 1: Yes
+enable_rewind =
+
+# How many emulated frames pass between two rewind snapshots
+# 1 - 600: Frames. Default 30 (half a second)
+rewind_interval =
+
+# How much memory the rewind snapshots may take up, the oldest ones are dropped past it
+# 16 - 16384: MiB. Default 512
+rewind_buffer_size =
+
 # The path of the virtual SD card directory.
 # empty (default) will use the user_path
 sdmc_directory =
@@ -303,6 +329,10 @@ camera_inner_flip =
 # Examples: *:Debug Kernel.SVC:Trace Service.*:Critical
 log_filter = *:Info
 
+# Writes a binary log instead of a text log, which is much cheaper with verbose log filters.
+# Convert it to text with citra-log-dump. 0 (default): Off, 1: On
+binary_log =
+
 [Debugging]
 # Record frame time data, can be found in the log directory. Boolean value
 record_frame_times =
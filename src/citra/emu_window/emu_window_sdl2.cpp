@@ -135,7 +135,7 @@ void EmuWindow_SDL2::Fullscreen() {
     SDL_MaximizeWindow(render_window);
 }
 
-EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
+EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen, bool headless) : headless{headless} {
     // Initialize the window
     if (SDL_Init(SDL_INIT_VIDEO | SDL_INIT_GAMECONTROLLER) < 0) {
         LOG_CRITICAL(Frontend, "Failed to initialize SDL2: {}! Exiting...", SDL_GetError());
@@ -166,7 +166,7 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
     // Enable context sharing for the shared context
     SDL_GL_SetAttribute(SDL_GL_SHARE_WITH_CURRENT_CONTEXT, 1);
     // Enable vsync
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(headless ? 0 : 1);
 
     std::string window_title = fmt::format("Citra {} | {}-{}", Common::g_build_fullname,
                                            Common::g_scm_branch, Common::g_scm_desc);
@@ -175,7 +175,8 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
                          SDL_WINDOWPOS_UNDEFINED, // x position
                          SDL_WINDOWPOS_UNDEFINED, // y position
                          Core::kScreenTopWidth, Core::kScreenTopHeight + Core::kScreenBottomHeight,
-                         SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI);
+                         SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE | SDL_WINDOW_ALLOW_HIGHDPI |
+                             (headless ? SDL_WINDOW_HIDDEN : 0));
 
     if (render_window == nullptr) {
         LOG_CRITICAL(Frontend, "Failed to create SDL2 window: {}", SDL_GetError());
@@ -185,7 +186,7 @@ EmuWindow_SDL2::EmuWindow_SDL2(bool fullscreen) {
     dummy_window = SDL_CreateWindow(NULL, SDL_WINDOWPOS_UNDEFINED, SDL_WINDOWPOS_UNDEFINED, 0, 0,
                                     SDL_WINDOW_HIDDEN | SDL_WINDOW_OPENGL);
 
-    if (fullscreen) {
+    if (fullscreen && !headless) {
         Fullscreen();
     }
 
@@ -239,7 +240,7 @@ void EmuWindow_SDL2::RestoreContext() {
 
 void EmuWindow_SDL2::Present() {
     SDL_GL_MakeCurrent(render_window, window_context);
-    SDL_GL_SetSwapInterval(1);
+    SDL_GL_SetSwapInterval(headless ? 0 : 1);
     while (IsOpen()) {
         VideoCore::g_renderer->TryPresent(100);
         SDL_GL_SwapWindow(render_window);
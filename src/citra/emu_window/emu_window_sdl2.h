@@ -29,7 +29,8 @@ private:
 
 class EmuWindow_SDL2 : public Frontend::EmuWindow {
 public:
-    explicit EmuWindow_SDL2(bool fullscreen);
+    /// Creates the render window. A headless window stays hidden and presents without vsync
+    explicit EmuWindow_SDL2(bool fullscreen, bool headless = false);
     ~EmuWindow_SDL2();
 
     void Present();
@@ -91,6 +92,9 @@ private:
     /// Is the window still open?
     bool is_open = true;
 
+    /// Whether the window is hidden and presents without vsync
+    bool headless = false;
+
     /// Internal SDL2 render window
     SDL_Window* render_window;
 
@@ -107,7 +107,11 @@ void EmuThread::run() {
     }
 
     // Shutdown the core emulation
-    system.Shutdown();
+    try {
+        system.Shutdown();
+    } catch (const std::exception& e) {
+        emit ErrorThrown(Core::System::ResultStatus::ErrorSavestate, e.what());
+    }
 
 #if MICROPROFILE_ENABLED
     MicroProfileOnThreadExit();
@@ -58,7 +58,7 @@ const std::array<std::array<int, 5>, Settings::NativeAnalog::NumAnalogs> Config:
 // This must be in alphabetical order according to action name as it must have the same order as
 // UISetting::values.shortcuts, which is alphabetically ordered.
 // clang-format off
-const std::array<UISettings::Shortcut, 23> default_hotkeys{
+const std::array<UISettings::Shortcut, 24> default_hotkeys{
     {{QStringLiteral("Advance Frame"),            QStringLiteral("Main Window"), {QStringLiteral("\\"), Qt::ApplicationShortcut}},
      {QStringLiteral("Capture Screenshot"),       QStringLiteral("Main Window"), {QStringLiteral("Ctrl+P"), Qt::ApplicationShortcut}},
      {QStringLiteral("Continue/Pause Emulation"), QStringLiteral("Main Window"), {QStringLiteral("F4"), Qt::WindowShortcut}},
@@ -72,6 +72,7 @@ const std::array<UISettings::Shortcut, 23> default_hotkeys{
      {QStringLiteral("Load from Newest Slot"),    QStringLiteral("Main Window"), {QStringLiteral("Ctrl+V"), Qt::WindowShortcut}},
      {QStringLiteral("Remove Amiibo"),            QStringLiteral("Main Window"), {QStringLiteral("F3"), Qt::ApplicationShortcut}},
      {QStringLiteral("Restart Emulation"),        QStringLiteral("Main Window"), {QStringLiteral("F6"), Qt::WindowShortcut}},
+     {QStringLiteral("Rewind"),                   QStringLiteral("Main Window"), {QStringLiteral("Backspace"), Qt::WindowShortcut}},
      {QStringLiteral("Rotate Screens Upright"),   QStringLiteral("Main Window"), {QStringLiteral("F8"), Qt::WindowShortcut}},
      {QStringLiteral("Save to Oldest Slot"),      QStringLiteral("Main Window"), {QStringLiteral("Ctrl+C"), Qt::WindowShortcut}},
      {QStringLiteral("Stop Emulation"),           QStringLiteral("Main Window"), {QStringLiteral("F5"), Qt::WindowShortcut}},
@@ -303,6 +304,12 @@ void Config::ReadDataStorageValues() {
     qt_config->beginGroup(QStringLiteral("Data Storage"));
 
     Settings::values.use_virtual_sd = ReadSetting(QStringLiteral("use_virtual_sd"), true).toBool();
+    Settings::values.incremental_save_states =
+        ReadSetting(QStringLiteral("incremental_save_states"), false).toBool();
+    Settings::values.enable_rewind = ReadSetting(QStringLiteral("enable_rewind"), false).toBool();
+    Settings::values.rewind_interval = ReadSetting(QStringLiteral("rewind_interval"), 30).toUInt();
+    Settings::values.rewind_buffer_size =
+        ReadSetting(QStringLiteral("rewind_buffer_size"), 512).toUInt();
 
     const std::string nand_dir =
         ReadSetting(
@@ -386,6 +393,7 @@ void Config::ReadMiscellaneousValues() {
         ReadSetting(QStringLiteral("log_filter"), QStringLiteral("*:Info"))
             .toString()
             .toStdString();
+    Settings::values.binary_log = ReadSetting(QStringLiteral("binary_log"), false).toBool();
 
     qt_config->endGroup();
 }
@@ -498,6 +506,10 @@ void Config::ReadRendererValues() {
     Settings::values.use_disk_shader_cache =
         ReadSetting(QStringLiteral("use_disk_shader_cache"), true).toBool();
     Settings::values.use_vsync_new = ReadSetting(QStringLiteral("use_vsync_new"), true).toBool();
+    Settings::values.frames_in_flight =
+        static_cast<u16>(ReadSetting(QStringLiteral("frames_in_flight"), 4).toInt());
+    Settings::values.vram_budget =
+        static_cast<u16>(ReadSetting(QStringLiteral("vram_budget"), 80).toInt());
     Settings::values.resolution_factor =
         static_cast<u16>(ReadSetting(QStringLiteral("resolution_factor"), 1).toInt());
     Settings::values.frame_limit = ReadSetting(QStringLiteral("frame_limit"), 100).toInt();
@@ -869,6 +881,11 @@ void Config::SaveDataStorageValues() {
     qt_config->beginGroup(QStringLiteral("Data Storage"));
 
     WriteSetting(QStringLiteral("use_virtual_sd"), Settings::values.use_virtual_sd, true);
+    WriteSetting(QStringLiteral("incremental_save_states"),
+                 Settings::values.incremental_save_states, false);
+    WriteSetting(QStringLiteral("enable_rewind"), Settings::values.enable_rewind, false);
+    WriteSetting(QStringLiteral("rewind_interval"), Settings::values.rewind_interval, 30);
+    WriteSetting(QStringLiteral("rewind_buffer_size"), Settings::values.rewind_buffer_size, 512);
     WriteSetting(QStringLiteral("nand_directory"),
                  QString::fromStdString(FileUtil::GetUserPath(FileUtil::UserPath::NANDDir)),
                  QString::fromStdString(FileUtil::GetDefaultUserPath(FileUtil::UserPath::NANDDir)));
@@ -929,6 +946,7 @@ void Config::SaveMiscellaneousValues() {
 
     WriteSetting(QStringLiteral("log_filter"), QString::fromStdString(Settings::values.log_filter),
                  QStringLiteral("*:Info"));
+    WriteSetting(QStringLiteral("binary_log"), Settings::values.binary_log, false);
 
     qt_config->endGroup();
 }
@@ -1007,6 +1025,8 @@ void Config::SaveRendererValues() {
     WriteSetting(QStringLiteral("use_disk_shader_cache"), Settings::values.use_disk_shader_cache,
                  true);
     WriteSetting(QStringLiteral("use_vsync_new"), Settings::values.use_vsync_new, true);
+    WriteSetting(QStringLiteral("frames_in_flight"), Settings::values.frames_in_flight, 4);
+    WriteSetting(QStringLiteral("vram_budget"), Settings::values.vram_budget, 80);
     WriteSetting(QStringLiteral("resolution_factor"), Settings::values.resolution_factor, 1);
     WriteSetting(QStringLiteral("frame_limit"), Settings::values.frame_limit, 100);
     WriteSetting(QStringLiteral("use_frame_limit_alternate"),
@@ -145,7 +145,11 @@ static void InitializeLogging() {
 
     const std::string& log_dir = FileUtil::GetUserPath(FileUtil::UserPath::LogDir);
     FileUtil::CreateFullPath(log_dir);
-    Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    if (Settings::values.binary_log) {
+        Log::AddBackend(std::make_unique<Log::BinaryFileBackend>(log_dir + BINARY_LOG_FILE));
+    } else {
+        Log::AddBackend(std::make_unique<Log::FileBackend>(log_dir + LOG_FILE));
+    }
 #ifdef _WIN32
     Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
 #endif
@@ -180,6 +184,11 @@ GMainWindow::GMainWindow()
     Core::Movie::GetInstance().SetPlaybackCompletionCallback([this] {
         QMetaObject::invokeMethod(this, "OnMoviePlaybackCompleted", Qt::BlockingQueuedConnection);
     });
+    // Not blocking, as shutting down waits for the save state to be written
+    Core::System::GetInstance().SetSaveStateCallback([this](u32 slot, bool success) {
+        QMetaObject::invokeMethod(this, "OnSaveStateCompleted", Qt::QueuedConnection,
+                                  Q_ARG(quint32, slot), Q_ARG(bool, success));
+    });
 
     InitializeWidgets();
     InitializeDebugWidgets();
@@ -302,8 +311,11 @@ void GMainWindow::InitializeWidgets() {
     emu_frametime_label->setToolTip(
         tr("Time taken to emulate a 3DS frame, not counting framelimiting or v-sync. For "
            "full-speed emulation this should be at most 16.67 ms."));
+    rewind_label = new QLabel();
+    texture_cache_label = new QLabel();
 
-    for (auto& label : {emu_speed_label, game_fps_label, emu_frametime_label}) {
+    for (auto& label : {rewind_label, texture_cache_label, emu_speed_label, game_fps_label,
+                        emu_frametime_label}) {
         label->setVisible(false);
         label->setFrameStyle(QFrame::NoFrame);
         label->setContentsMargins(4, 0, 4, 0);
@@ -596,6 +608,13 @@ void GMainWindow::InitializeHotkeys() {
             &QShortcut::activated, ui->action_Load_from_Newest_Slot, &QAction::trigger);
     connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Save to Oldest Slot"), this),
             &QShortcut::activated, ui->action_Save_to_Oldest_Slot, &QAction::trigger);
+    connect(hotkey_registry.GetHotkey(main_window, QStringLiteral("Rewind"), this),
+            &QShortcut::activated, this, [&] {
+                if (emulation_running && Settings::values.enable_rewind) {
+                    Core::System::GetInstance().SendSignal(Core::System::Signal::Rewind);
+                    Core::System::GetInstance().frame_limiter.AdvanceFrame();
+                }
+            });
 }
 
 void GMainWindow::ShowUpdaterWidgets() {
@@ -1197,6 +1216,8 @@ void GMainWindow::ShutdownGame() {
     emu_speed_label->setVisible(false);
     game_fps_label->setVisible(false);
     emu_frametime_label->setVisible(false);
+    rewind_label->setVisible(false);
+    texture_cache_label->setVisible(false);
 
     UpdateSaveStates();
 
@@ -2075,6 +2096,36 @@ void GMainWindow::UpdateStatusBar() {
     emu_speed_label->setVisible(true);
     game_fps_label->setVisible(true);
     emu_frametime_label->setVisible(true);
+
+    if (const auto rewind = Core::System::GetInstance().GetRewindStats()) {
+        constexpr double MiB = 1024.0 * 1024.0;
+        rewind_label->setText(tr("Rewind: %1 s").arg(rewind->seconds_covered, 0, 'f', 0));
+        rewind_label->setToolTip(
+            tr("%1 snapshots taking up %2 / %3 MiB, plus %4 MiB for the uncompressed memory.\n"
+               "Capturing stopped emulation for %5 ms, compressing took %6 ms.")
+                .arg(rewind->num_snapshots)
+                .arg(rewind->memory_used / MiB, 0, 'f', 1)
+                .arg(rewind->memory_limit / MiB, 0, 'f', 0)
+                .arg(rewind->ram_copy_size / MiB, 0, 'f', 0)
+                .arg(rewind->capture_time, 0, 'f', 2)
+                .arg(rewind->compression_time, 0, 'f', 2));
+        rewind_label->setVisible(true);
+    } else {
+        rewind_label->setVisible(false);
+    }
+
+    if (results.resident_surfaces != 0) {
+        constexpr double MiB = 1024.0 * 1024.0;
+        texture_cache_label->setText(
+            tr("VRAM: %1 MiB").arg(results.resident_surface_bytes / MiB, 0, 'f', 0));
+        texture_cache_label->setToolTip(
+            tr("%1 surfaces resident in the texture cache, %2 evicted per second.")
+                .arg(results.resident_surfaces)
+                .arg(results.surface_evictions, 0, 'f', 1));
+        texture_cache_label->setVisible(true);
+    } else {
+        texture_cache_label->setVisible(false);
+    }
 }
 
 void GMainWindow::HideMouseCursor() {
@@ -2344,6 +2395,14 @@ void GMainWindow::OnMoviePlaybackCompleted() {
     QMessageBox::information(this, tr("Playback Completed"), tr("Movie playback completed."));
 }
 
+void GMainWindow::OnSaveStateCompleted(quint32 slot, bool success) {
+    // Failures are reported by the emulation thread
+    if (success) {
+        statusBar()->showMessage(tr("Saved to slot %1").arg(slot), 3000);
+    }
+    UpdateSaveStates();
+}
+
 void GMainWindow::UpdateWindowTitle() {
     const QString full_name = QString::fromUtf8(Common::g_build_fullname);
 
@@ -226,6 +226,7 @@ private slots:
 
 private:
     Q_INVOKABLE void OnMoviePlaybackCompleted();
+    Q_INVOKABLE void OnSaveStateCompleted(quint32 slot, bool success);
     void UpdateStatusBar();
     void LoadTranslation();
     void UpdateWindowTitle();
@@ -248,6 +249,8 @@ private:
     QLabel* emu_speed_label = nullptr;
     QLabel* game_fps_label = nullptr;
     QLabel* emu_frametime_label = nullptr;
+    QLabel* rewind_label = nullptr;
+    QLabel* texture_cache_label = nullptr;
     QTimer status_bar_update_timer;
     bool message_label_used_for_movie = false;
 
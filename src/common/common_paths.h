@@ -52,6 +52,7 @@
 // Filenames
 // Files in the directory returned by GetUserPath(UserPath::LogDir)
 #define LOG_FILE "citra_log.txt"
+#define BINARY_LOG_FILE "citra_log.bin"
 
 // Files in the directory returned by GetUserPath(UserPath::ConfigDir)
 #define EMU_CONFIG "emu.ini"
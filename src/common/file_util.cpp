@@ -12,6 +12,7 @@
 #include "common/common_paths.h"
 #include "common/file_util.h"
 #include "common/logging/log.h"
+#include "common/zstd_seekable.h"
 
 #ifdef _WIN32
 #include <windows.h>
@@ -46,6 +47,7 @@
 #include <cstring>
 #include <dirent.h>
 #include <pwd.h>
+#include <sys/mman.h>
 #include <unistd.h>
 #endif
 
@@ -265,6 +267,23 @@ bool Rename(const std::string& srcFilename, const std::string& destFilename) {
     return false;
 }
 
+bool Replace(const std::string& srcFilename, const std::string& destFilename) {
+    LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
+#ifdef _WIN32
+    if (MoveFileExW(Common::UTF8ToUTF16W(srcFilename).c_str(),
+                    Common::UTF8ToUTF16W(destFilename).c_str(),
+                    MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+        return true;
+#else
+    // rename replaces the destination atomically
+    if (rename(srcFilename.c_str(), destFilename.c_str()) == 0)
+        return true;
+#endif
+    LOG_ERROR(Common_Filesystem, "failed {} --> {}: {}", srcFilename, destFilename,
+              GetLastErrorMsg());
+    return false;
+}
+
 bool Copy(const std::string& srcFilename, const std::string& destFilename) {
     LOG_TRACE(Common_Filesystem, "{} --> {}", srcFilename, destFilename);
 #ifdef _WIN32
@@ -963,6 +982,8 @@ void IOFile::Swap(IOFile& other) noexcept {
     std::swap(filename, other.filename);
     std::swap(openmode, other.openmode);
     std::swap(flags, other.flags);
+    std::swap(decompressor, other.decompressor);
+    std::swap(decompressed_position, other.decompressed_position);
 }
 
 bool IOFile::Open() {
@@ -982,6 +1003,24 @@ bool IOFile::Open() {
     m_good = m_file != nullptr;
 #endif
 
+    if (m_good && openmode == "rb") {
+        // The reader gets the FILE pointer rather than this, which changes when the IOFile is
+        // moved
+        std::FILE* file = m_file;
+        decompressor = Common::Compression::SeekableZstdReader::Open(
+            [file](u64 offset, void* buffer, std::size_t length) -> std::size_t {
+                if (fseeko(file, static_cast<s64>(offset), SEEK_SET) != 0) {
+                    return 0;
+                }
+                return std::fread(buffer, 1, length, file);
+            },
+            FileUtil::GetSize(m_file));
+        decompressed_position = 0;
+        if (!decompressor) {
+            fseeko(m_file, 0, SEEK_SET);
+        }
+    }
+
     return m_good;
 }
 
@@ -990,10 +1029,13 @@ bool IOFile::Close() {
         m_good = false;
 
     m_file = nullptr;
+    decompressor.reset();
     return m_good;
 }
 
 u64 IOFile::GetSize() const {
+    if (decompressor)
+        return decompressor->GetSize();
     if (IsOpen())
         return FileUtil::GetSize(m_file);
 
@@ -1001,6 +1043,21 @@ u64 IOFile::GetSize() const {
 }
 
 bool IOFile::Seek(s64 off, int origin) {
+    if (decompressor) {
+        s64 base = 0;
+        if (origin == SEEK_CUR) {
+            base = static_cast<s64>(decompressed_position);
+        } else if (origin == SEEK_END) {
+            base = static_cast<s64>(decompressor->GetSize());
+        }
+        if (base + off < 0) {
+            m_good = false;
+        } else {
+            decompressed_position = static_cast<u64>(base + off);
+        }
+        return m_good;
+    }
+
     if (!IsOpen() || 0 != fseeko(m_file, off, origin))
         m_good = false;
 
@@ -1008,6 +1065,8 @@ bool IOFile::Seek(s64 off, int origin) {
 }
 
 u64 IOFile::Tell() const {
+    if (decompressor)
+        return decompressed_position;
     if (IsOpen())
         return ftello(m_file);
 
@@ -1033,6 +1092,13 @@ std::size_t IOFile::ReadImpl(void* data, std::size_t length, std::size_t data_si
 
     DEBUG_ASSERT(data != nullptr);
 
+    if (decompressor) {
+        const std::size_t read =
+            decompressor->Read(decompressed_position, data, length * data_size);
+        decompressed_position += read;
+        return read / data_size;
+    }
+
     return std::fread(data, data_size, length, m_file);
 }
 
@@ -1067,4 +1133,84 @@ bool IOFile::Resize(u64 size) {
     return m_good;
 }
 
+MappedFile::MappedFile(const IOFile& file) {
+    // Compressed files have nothing worth mapping, their readers fall back to regular reads
+    if (!file.IsOpen() || file.decompressor) {
+        return;
+    }
+
+    const u64 file_size = file.GetSize();
+    if (file_size == 0 || file_size > std::numeric_limits<std::size_t>::max()) {
+        return;
+    }
+
+#ifdef _WIN32
+    const HANDLE file_handle = reinterpret_cast<HANDLE>(_get_osfhandle(_fileno(file.m_file)));
+    if (file_handle == INVALID_HANDLE_VALUE) {
+        return;
+    }
+    mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_handle == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to create mapping for {}: {}", file.filename,
+                  GetLastErrorMsg());
+        return;
+    }
+    void* view = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+    if (view == nullptr) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}: {}", file.filename, GetLastErrorMsg());
+        CloseHandle(mapping_handle);
+        mapping_handle = nullptr;
+        return;
+    }
+#else
+    void* view = mmap(nullptr, static_cast<std::size_t>(file_size), PROT_READ, MAP_SHARED,
+                      fileno(file.m_file), 0);
+    if (view == MAP_FAILED) {
+        LOG_ERROR(Common_Filesystem, "Failed to map {}: {}", file.filename, GetLastErrorMsg());
+        return;
+    }
+#endif
+
+    data = static_cast<u8*>(view);
+    size = file_size;
+}
+
+MappedFile::~MappedFile() {
+    Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept {
+    Swap(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+    Swap(other);
+    return *this;
+}
+
+void MappedFile::Swap(MappedFile& other) noexcept {
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#ifdef _WIN32
+    std::swap(mapping_handle, other.mapping_handle);
+#endif
+}
+
+void MappedFile::Unmap() {
+    if (data == nullptr) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(data);
+    CloseHandle(mapping_handle);
+    mapping_handle = nullptr;
+#else
+    munmap(data, static_cast<std::size_t>(size));
+#endif
+
+    data = nullptr;
+    size = 0;
+}
+
 } // namespace FileUtil
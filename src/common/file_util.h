@@ -9,6 +9,7 @@
 #include <fstream>
 #include <functional>
 #include <limits>
+#include <memory>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -22,6 +23,10 @@
 #include "common/string_util.h"
 #endif
 
+namespace Common::Compression {
+class SeekableZstdReader;
+}
+
 namespace FileUtil {
 
 // User paths for GetUserPath
@@ -121,6 +126,10 @@ bool DeleteDir(const std::string& filename);
 // renames file srcFilename to destFilename, returns true on success
 bool Rename(const std::string& srcFilename, const std::string& destFilename);
 
+// renames file srcFilename to destFilename, atomically replacing destFilename if it exists.
+// Returns true on success
+bool Replace(const std::string& srcFilename, const std::string& destFilename);
+
 // copies file srcFilename to destFilename, returns true on success
 bool Copy(const std::string& srcFilename, const std::string& destFilename);
 
@@ -264,6 +273,9 @@ enum class DirectorySeparator {
 // simple wrapper for cstdlib file functions to
 // hopefully will make error checking easier
 // and make forgetting an fclose() harder
+//
+// Files opened with "rb" that are seekable zstd archives (see common/zstd_seekable.h) are read as
+// if they were the data they contain: reads, seeks and the size refer to the decompressed data.
 class IOFile : public NonCopyable {
 public:
     IOFile();
@@ -361,6 +373,10 @@ private:
     std::FILE* m_file = nullptr;
     bool m_good = true;
 
+    // Set when the file is a seekable zstd archive, the position is then in the decompressed data
+    std::unique_ptr<Common::Compression::SeekableZstdReader> decompressor;
+    u64 decompressed_position = 0;
+
     std::string filename;
     std::string openmode;
     u32 flags;
@@ -381,6 +397,45 @@ private:
         }
     }
     friend class boost::serialization::access;
+    friend class MappedFile;
+};
+
+// Read-only memory mapping of the whole contents of an open IOFile. The mapping stays valid
+// independently of the IOFile it was created from.
+class MappedFile : public NonCopyable {
+public:
+    MappedFile() = default;
+    explicit MappedFile(const IOFile& file);
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    void Swap(MappedFile& other) noexcept;
+
+    void Unmap();
+
+    // Returns false if the file could not be mapped, e.g. if it is empty or the host is out of
+    // address space. Callers are expected to fall back to regular reads in that case.
+    [[nodiscard]] bool IsMapped() const {
+        return data != nullptr;
+    }
+
+    [[nodiscard]] const u8* Data() const {
+        return data;
+    }
+
+    [[nodiscard]] u64 Size() const {
+        return size;
+    }
+
+private:
+    u8* data = nullptr;
+    u64 size = 0;
+#ifdef _WIN32
+    void* mapping_handle = nullptr;
+#endif
 };
 
 } // namespace FileUtil
@@ -6,6 +6,7 @@
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
+#include <cstring>
 #include <memory>
 #include <mutex>
 #include <regex>
@@ -17,12 +18,13 @@
 #else
 #define _SH_DENYWR 0
 #endif
+#include "common/alignment.h"
 #include "common/assert.h"
 #include "common/logging/backend.h"
 #include "common/logging/log.h"
+#include "common/logging/record_ring.h"
 #include "common/logging/text_formatter.h"
 #include "common/string_util.h"
-#include "common/threadsafe_queue.h"
 
 namespace Log {
 
@@ -32,6 +34,9 @@ void SetGlobalFilter(const Filter& f) {
 }
 /**
  * Static state as a singleton.
+ *
+ * Messages are passed to the logging thread through a ring of records, which formats them and
+ * writes them to the backends.
  */
 class Impl {
 public:
@@ -43,10 +48,16 @@ public:
     Impl(Impl const&) = delete;
     const Impl& operator=(Impl const&) = delete;
 
-    void PushEntry(Class log_class, Level log_level, const char* filename, unsigned int line_num,
-                   const char* function, std::string message) {
-        message_queue.Push(
-            CreateEntry(log_class, log_level, filename, line_num, function, std::move(message)));
+    RecordHeader* ReserveRecord(std::size_t size, Level log_level) {
+        return ring.Reserve(size, log_level);
+    }
+
+    void CommitRecord(RecordHeader* header, std::size_t size) {
+        ring.Commit(header, size);
+    }
+
+    void SetDropWhenFull(bool enabled) {
+        ring.SetDropWhenFull(enabled);
     }
 
     void AddBackend(std::unique_ptr<Backend> backend) {
@@ -72,64 +83,37 @@ public:
     }
 
 private:
-    Impl() {
-        backend_thread = std::thread([&] {
-            Entry entry;
-            auto write_logs = [&](Entry& e) {
-                std::lock_guard lock{writing_mutex};
-                for (const auto& backend : backends) {
-                    backend->Write(e);
-                }
-            };
-            while (true) {
-                entry = message_queue.PopWait();
-                if (entry.final_entry) {
-                    break;
-                }
-                write_logs(entry);
-            }
-
-            // Drain the logging queue. Only writes out up to MAX_LOGS_TO_WRITE to prevent a case
-            // where a system is repeatedly spamming logs even on close.
-            constexpr int MAX_LOGS_TO_WRITE = 100;
-            int logs_written = 0;
-            while (logs_written++ < MAX_LOGS_TO_WRITE && message_queue.Pop(entry)) {
-                write_logs(entry);
-            }
-        });
-    }
+    /// Size of the ring in bytes, room for tens of thousands of messages
+    static constexpr std::size_t RING_SIZE = 4 * 1024 * 1024;
 
-    ~Impl() {
-        Entry entry;
-        entry.final_entry = true;
-        message_queue.Push(entry);
-        backend_thread.join();
-    }
-
-    Entry CreateEntry(Class log_class, Level log_level, const char* filename, unsigned int line_nr,
-                      const char* function, std::string message) const {
-        using std::chrono::duration_cast;
-        using std::chrono::steady_clock;
+    Impl() = default;
 
+    void WriteRecord(const RecordHeader& header, u32 size) {
+        const auto* const record = reinterpret_cast<const u8*>(&header);
         Entry entry;
-        entry.timestamp =
-            duration_cast<std::chrono::microseconds>(steady_clock::now() - time_origin);
-        entry.log_class = log_class;
-        entry.log_level = log_level;
-        entry.filename = filename;
-        entry.line_num = line_nr;
-        entry.function = function;
-        entry.message = std::move(message);
-
-        return entry;
+        entry.timestamp = std::chrono::microseconds{header.timestamp};
+        entry.log_class = header.log_class;
+        entry.log_level = header.log_level;
+        entry.filename = reinterpret_cast<const char*>(header.filename);
+        entry.line_num = header.line_num;
+        entry.function = reinterpret_cast<const char*>(header.function);
+        entry.message = FormatRecordMessage(reinterpret_cast<const char*>(header.format),
+                                            header.num_args,
+                                            {record + sizeof(header), size - sizeof(header)});
+
+        std::lock_guard lock{writing_mutex};
+        for (const auto& backend : backends) {
+            backend->WriteRecord({record, size});
+            backend->Write(entry);
+        }
     }
 
     std::mutex writing_mutex;
-    std::thread backend_thread;
     std::vector<std::unique_ptr<Backend>> backends;
-    Common::MPSCQueue<Log::Entry> message_queue;
     Filter filter;
-    std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+    /// Declared last so that the logging thread stops before the backends are destroyed
+    RecordRing ring{RING_SIZE,
+                    [this](const RecordHeader& header, u32 size) { WriteRecord(header, size); }};
 };
 
 void ConsoleBackend::Write(const Entry& entry) {
@@ -170,6 +154,53 @@ void FileBackend::Write(const Entry& entry) {
     }
 }
 
+BinaryFileBackend::BinaryFileBackend(const std::string& filename) : bytes_written(0) {
+    if (FileUtil::Exists(filename + ".old")) {
+        FileUtil::Delete(filename + ".old");
+    }
+    if (FileUtil::Exists(filename)) {
+        FileUtil::Rename(filename, filename + ".old");
+    }
+
+    file = FileUtil::IOFile(filename, "wb", _SH_DENYWR);
+    const BinaryLogHeader header{BINARY_LOG_MAGIC, BINARY_LOG_VERSION};
+    bytes_written += file.WriteObject(header);
+}
+
+void BinaryFileBackend::Write(const Entry& entry) {
+    // The record was written already, make sure errors make it to the disk in case of a crash
+    if (entry.log_level >= Level::Error) {
+        file.Flush();
+    }
+}
+
+void BinaryFileBackend::WriteRecord(std::span<const u8> record) {
+    constexpr std::size_t MAX_BYTES_WRITTEN = 50 * 1024L * 1024L;
+    if (!file.IsOpen() || bytes_written > MAX_BYTES_WRITTEN) {
+        return;
+    }
+    RecordHeader header;
+    std::memcpy(&header, record.data(), sizeof(header));
+    WriteString(header.filename);
+    WriteString(header.function);
+    WriteString(header.format);
+    bytes_written += file.WriteBytes(record.data(), record.size());
+}
+
+void BinaryFileBackend::WriteString(u64 address) {
+    if (!written_strings.insert(address).second) {
+        return;
+    }
+    const std::string_view string{reinterpret_cast<const char*>(address)};
+    const std::size_t size =
+        Common::AlignUp(sizeof(StringHeader) + string.size(), RECORD_ALIGNMENT);
+    const StringHeader header{static_cast<u32>(size), Class::Count, {}, address};
+    constexpr std::array<u8, RECORD_ALIGNMENT> padding{};
+    bytes_written += file.WriteObject(header);
+    bytes_written += file.WriteBytes(string.data(), string.size());
+    bytes_written += file.WriteBytes(padding.data(), size - sizeof(header) - string.size());
+}
+
 void DebuggerBackend::Write(const Entry& entry) {
 #ifdef _WIN32
     ::OutputDebugStringW(Common::UTF8ToUTF16W(FormatLogMessage(entry).append(1, '\n')).c_str());
@@ -296,11 +327,22 @@ Backend* GetBackend(std::string_view backend_name) {
     return Impl::Instance().GetBackend(backend_name);
 }
 
+RecordHeader* ReserveRecord(std::size_t size, Level log_level) {
+    return Impl::Instance().ReserveRecord(size, log_level);
+}
+
+void CommitRecord(RecordHeader* header, std::size_t size) {
+    Impl::Instance().CommitRecord(header, size);
+}
+
+void SetDropWhenFull(bool enabled) {
+    Impl::Instance().SetDropWhenFull(enabled);
+}
+
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args) {
-    auto& instance = Impl::Instance();
-    instance.PushEntry(log_class, log_level, filename, line_num, function,
+    Detail::PushRecord(log_class, log_level, filename, line_num, function, "{}",
                        fmt::vformat(format, args));
 }
 } // namespace Log
@@ -6,8 +6,10 @@
 
 #include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <string_view>
+#include <unordered_set>
 #include "common/file_util.h"
 #include "common/logging/filter.h"
 #include "common/logging/log.h"
@@ -26,7 +28,6 @@ struct Entry {
     unsigned int line_num;
     std::string function;
     std::string message;
-    bool final_entry = false;
 
     Entry() = default;
     Entry(Entry&& o) = default;
@@ -48,6 +49,9 @@ public:
     virtual const char* GetName() const = 0;
     virtual void Write(const Entry& entry) = 0;
 
+    /// Receives each message as the record it was logged as, before it is passed to Write
+    virtual void WriteRecord([[maybe_unused]] std::span<const u8> record) {}
+
 private:
     Filter filter;
 };
@@ -118,6 +122,35 @@ private:
     std::size_t bytes_written;
 };
 
+/**
+ * Backend that writes the records of the messages to a file passed into the constructor, without
+ * formatting them. citra-log-dump converts the file to text, even when the log ends abruptly.
+ */
+class BinaryFileBackend : public Backend {
+public:
+    explicit BinaryFileBackend(const std::string& filename);
+
+    static const char* Name() {
+        return "binary_file";
+    }
+
+    const char* GetName() const override {
+        return Name();
+    }
+
+    void Write(const Entry& entry) override;
+
+    void WriteRecord(std::span<const u8> record) override;
+
+private:
+    /// Writes the string at the given address, unless it was written before
+    void WriteString(u64 address);
+
+    FileUtil::IOFile file;
+    std::size_t bytes_written;
+    std::unordered_set<u64> written_strings;
+};
+
 /**
  * Backend that writes to Visual Studio's output window
  */
@@ -138,6 +171,12 @@ void RemoveBackend(std::string_view backend_name);
 
 Backend* GetBackend(std::string_view backend_name);
 
+/**
+ * Sets whether messages below Error are dropped when the logging thread falls behind, instead of
+ * stopping the threads logging them until it catches up. The number of dropped messages is logged.
+ */
+void SetDropWhenFull(bool enabled);
+
 /**
  * Returns the name of the passed log class as a C-string. Subclasses are separated by periods
  * instead of underscores as in the enumeration.
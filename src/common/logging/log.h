@@ -8,6 +8,7 @@
 #include <array>
 #include "common/common_types.h"
 #include "common/logging/formatter.h"
+#include "common/logging/record.h"
 
 namespace Log {
 
@@ -157,7 +158,7 @@ extern Filter filter;
 
 void SetGlobalFilter(const Filter& f);
 
-/// Logs a message to the global logger, using fmt
+/// Formats a message and logs it to the global logger, for arguments that can not be packed
 void FmtLogMessageImpl(Class log_class, Level log_level, const char* filename,
                        unsigned int line_num, const char* function, const char* format,
                        const fmt::format_args& args);
@@ -168,8 +169,13 @@ void FmtLogMessage(Class log_class, Level log_level, const char* filename, unsig
     if (!filter.CheckMessage(log_class, log_level))
         return;
 
-    FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
-                      fmt::make_format_args(args...));
+    // Leave the formatting to the logging thread when possible
+    if constexpr ((Detail::IsPackable<Detail::ArgType_t<Args>> && ...)) {
+        Detail::PushRecord(log_class, log_level, filename, line_num, function, format, args...);
+    } else {
+        FmtLogMessageImpl(log_class, log_level, filename, line_num, function, format,
+                          fmt::make_format_args(args...));
+    }
 }
 
 } // namespace Log
@@ -0,0 +1,88 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <fmt/args.h>
+#include <fmt/format.h>
+#include "common/logging/record.h"
+
+namespace Log {
+
+std::string FormatRecordMessage(std::string_view format, std::size_t num_args,
+                                std::span<const u8> args) {
+    fmt::dynamic_format_arg_store<fmt::format_context> store;
+    store.reserve(num_args, 0);
+
+    std::size_t offset = 0;
+    const auto Read = [&args, &offset](void* value, std::size_t size) {
+        if (args.size() - offset < size) {
+            return false;
+        }
+        std::memcpy(value, args.data() + offset, size);
+        offset += size;
+        return true;
+    };
+
+    for (std::size_t i = 0; i < num_args; i++) {
+        u8 type;
+        if (!Read(&type, sizeof(type))) {
+            return fmt::format("<truncated log record: {}>", format);
+        }
+
+        if (static_cast<ArgType>(type) == ArgType::String) {
+            u32 length;
+            if (!Read(&length, sizeof(length)) || args.size() - offset < length) {
+                return fmt::format("<truncated log record: {}>", format);
+            }
+            // Strings are referenced rather than copied, the record outlives the formatting
+            store.push_back(
+                std::string_view{reinterpret_cast<const char*>(args.data() + offset), length});
+            offset += length;
+            continue;
+        }
+
+        u64 value;
+        if (!Read(&value, sizeof(value))) {
+            return fmt::format("<truncated log record: {}>", format);
+        }
+        switch (static_cast<ArgType>(type)) {
+        case ArgType::Signed:
+            store.push_back(static_cast<s64>(value));
+            break;
+        case ArgType::Unsigned:
+            store.push_back(value);
+            break;
+        case ArgType::Float: {
+            float float_value;
+            std::memcpy(&float_value, &value, sizeof(float_value));
+            store.push_back(float_value);
+            break;
+        }
+        case ArgType::Double: {
+            double double_value;
+            std::memcpy(&double_value, &value, sizeof(double_value));
+            store.push_back(double_value);
+            break;
+        }
+        case ArgType::Bool:
+            store.push_back(value != 0);
+            break;
+        case ArgType::Char:
+            store.push_back(static_cast<char>(value));
+            break;
+        case ArgType::Pointer:
+            store.push_back(reinterpret_cast<const void*>(static_cast<uintptr_t>(value)));
+            break;
+        default:
+            return fmt::format("<corrupted log record: {}>", format);
+        }
+    }
+
+    try {
+        return fmt::vformat(format, store);
+    } catch (const fmt::format_error& e) {
+        return fmt::format("<invalid log message '{}': {}>", format, e.what());
+    }
+}
+
+} // namespace Log
@@ -0,0 +1,209 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include "common/common_types.h"
+
+namespace Log {
+
+enum class Class : u8;
+enum class Level : u8;
+
+/**
+ * Log messages are passed to the logging thread as records: the address of the format string
+ * followed by the arguments packed in binary form. Logging a message then only copies its
+ * arguments, formatting it is left to the logging thread. Binary log files store the records
+ * as they are, along with the strings their addresses refer to.
+ *
+ * Every argument is stored as its type followed by its value in 8 bytes, except strings, which
+ * are copied as their length followed by their characters. Records are aligned to 8 bytes.
+ */
+
+/// Type of an argument packed into a record
+enum class ArgType : u8 {
+    Signed,
+    Unsigned,
+    Float,
+    Double,
+    Bool,
+    Char,
+    Pointer,
+    String,
+};
+
+constexpr std::size_t RECORD_ALIGNMENT = 8;
+
+struct RecordHeader {
+    u32 size; ///< Size of the record in bytes including padding, 0 until the record is complete
+    Class log_class; ///< Class::Count for records not holding a message
+    Level log_level;
+    u16 num_args;
+    u32 line_num;
+    u32 reserved;
+    s64 timestamp; ///< Microseconds since logging started
+    u64 filename;  ///< Address of the file name
+    u64 function;  ///< Address of the function name
+    u64 format;    ///< Address of the format string
+};
+static_assert(sizeof(RecordHeader) == 48 && sizeof(RecordHeader) % RECORD_ALIGNMENT == 0);
+
+/**
+ * Header of a binary log file, followed by the records. Every record is preceded by the strings
+ * it refers to that were not written yet, each stored as a StringHeader with log_class set to
+ * Class::Count followed by the characters.
+ */
+struct BinaryLogHeader {
+    std::array<u8, 4> magic;
+    u32 version;
+};
+
+struct StringHeader {
+    u32 size; ///< Size of the header and the characters in bytes, including padding
+    Class marker;
+    std::array<u8, 3> reserved;
+    u64 address;
+};
+static_assert(sizeof(StringHeader) % RECORD_ALIGNMENT == 0);
+
+constexpr std::array<u8, 4> BINARY_LOG_MAGIC{{'C', 'L', 'B', 0x1B}};
+constexpr u32 BINARY_LOG_VERSION = 1;
+
+/**
+ * Reserves space for a record in the log ring, waiting for space when the ring is full. Messages
+ * below Error are dropped instead if SetDropWhenFull was enabled.
+ * @param size the size of the record in bytes, including the header.
+ * @return the record to fill in, with its timestamp set, or nullptr if the message was dropped.
+ */
+RecordHeader* ReserveRecord(std::size_t size, Level log_level);
+
+/// Hands a record filled after ReserveRecord over to the logging thread
+void CommitRecord(RecordHeader* header, std::size_t size);
+
+/**
+ * Formats the message of a record.
+ * @param args the arguments packed after the header.
+ * @return the message, or a description of the error if it can not be formatted.
+ */
+std::string FormatRecordMessage(std::string_view format, std::size_t num_args,
+                                std::span<const u8> args);
+
+namespace Detail {
+
+/// Type an argument is packed as, character arrays are packed as strings
+template <typename T>
+using ArgType_t = std::decay_t<const T>;
+
+template <typename T>
+constexpr bool IsStringArg = std::is_same_v<T, const char*> || std::is_same_v<T, char*> ||
+                             std::is_same_v<T, std::string> || std::is_same_v<T, std::string_view>;
+
+template <typename T>
+constexpr bool IsIntegerArg = std::is_integral_v<T> && sizeof(T) <= sizeof(u64) &&
+                              !std::is_same_v<T, bool> && !std::is_same_v<T, char> &&
+                              !std::is_same_v<T, wchar_t> && !std::is_same_v<T, char8_t> &&
+                              !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+/**
+ * Whether an argument can be packed into a record. Anything fmt formats through a formatter of
+ * its own, enumerations included, is formatted before it is logged instead.
+ */
+template <typename T>
+constexpr bool IsPackable = IsStringArg<T> || IsIntegerArg<T> || std::is_same_v<T, bool> ||
+                            std::is_same_v<T, char> || std::is_same_v<T, float> ||
+                            std::is_same_v<T, double> || std::is_same_v<T, const void*> ||
+                            std::is_same_v<T, void*>;
+
+template <typename T>
+std::string_view ToStringView(const T& arg) {
+    if constexpr (std::is_pointer_v<T>) {
+        return arg ? std::string_view{arg} : std::string_view{};
+    } else {
+        return arg;
+    }
+}
+
+template <typename T>
+std::size_t PackedArgSize(const T& arg) {
+    if constexpr (IsStringArg<T>) {
+        return 1 + sizeof(u32) + ToStringView(arg).size();
+    } else {
+        return 1 + sizeof(u64);
+    }
+}
+
+template <typename T>
+u8* PackArg(u8* out, const T& arg) {
+    const auto Store = [&out](ArgType type, const void* value, std::size_t size) {
+        *out++ = static_cast<u8>(type);
+        std::memcpy(out, value, size);
+        out += size;
+    };
+
+    if constexpr (IsStringArg<T>) {
+        const std::string_view string = ToStringView(arg);
+        const u32 length = static_cast<u32>(string.size());
+        Store(ArgType::String, &length, sizeof(length));
+        std::memcpy(out, string.data(), string.size());
+        return out + string.size();
+    } else {
+        u64 value = 0;
+        if constexpr (std::is_same_v<T, bool>) {
+            value = arg;
+            Store(ArgType::Bool, &value, sizeof(value));
+        } else if constexpr (std::is_same_v<T, char>) {
+            value = static_cast<u8>(arg);
+            Store(ArgType::Char, &value, sizeof(value));
+        } else if constexpr (std::is_same_v<T, float> || std::is_same_v<T, double>) {
+            std::memcpy(&value, &arg, sizeof(arg));
+            Store(std::is_same_v<T, float> ? ArgType::Float : ArgType::Double, &value,
+                  sizeof(value));
+        } else if constexpr (std::is_pointer_v<T>) {
+            value = reinterpret_cast<uintptr_t>(arg);
+            Store(ArgType::Pointer, &value, sizeof(value));
+        } else if constexpr (std::is_signed_v<T>) {
+            const s64 signed_value = arg;
+            Store(ArgType::Signed, &signed_value, sizeof(signed_value));
+        } else {
+            value = arg;
+            Store(ArgType::Unsigned, &value, sizeof(value));
+        }
+        return out;
+    }
+}
+
+/// Packs a message into a record in the log ring
+template <typename... Args>
+void PushRecord(Class log_class, Level log_level, const char* filename, unsigned int line_num,
+                const char* function, const char* format, const Args&... args) {
+    const std::size_t size =
+        sizeof(RecordHeader) + (PackedArgSize<ArgType_t<Args>>(args) + ... + 0);
+    RecordHeader* const header = ReserveRecord(size, log_level);
+    if (!header) {
+        return;
+    }
+    header->log_class = log_class;
+    header->log_level = log_level;
+    header->num_args = static_cast<u16>(sizeof...(Args));
+    header->line_num = line_num;
+    header->reserved = 0;
+    header->filename = reinterpret_cast<uintptr_t>(filename);
+    header->function = reinterpret_cast<uintptr_t>(function);
+    header->format = reinterpret_cast<uintptr_t>(format);
+
+    [[maybe_unused]] u8* out = reinterpret_cast<u8*>(header + 1);
+    ((out = PackArg<ArgType_t<Args>>(out, args)), ...);
+    CommitRecord(header, size);
+}
+
+} // namespace Detail
+
+} // namespace Log
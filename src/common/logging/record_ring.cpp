@@ -0,0 +1,147 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <array>
+#include <cstring>
+#include <optional>
+#include "common/alignment.h"
+#include "common/logging/log.h"
+#include "common/logging/record_ring.h"
+
+namespace Log {
+
+RecordRing::RecordRing(std::size_t size, Writer writer)
+    : ring_size{size}, ring_storage(size / sizeof(u64)),
+      ring{reinterpret_cast<u8*>(ring_storage.data())}, writer{std::move(writer)} {
+    writer_thread = std::thread([this] { Run(); });
+}
+
+RecordRing::~RecordRing() {
+    stop = true;
+    WakeWriter();
+    writer_thread.join();
+}
+
+RecordHeader* RecordRing::Reserve(std::size_t size, Level log_level) {
+    const u64 record_size = Common::AlignUp(size, RECORD_ALIGNMENT);
+    if (record_size > ring_size / 2) {
+        dropped_messages.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    u64 position = write_position.load(std::memory_order_relaxed);
+    while (true) {
+        const u64 offset = position % ring_size;
+        const u64 padding = offset + record_size > ring_size ? ring_size - offset : 0;
+        if (position + padding + record_size - read_position.load(std::memory_order_acquire) >
+            ring_size) {
+            // The writer thread can not make room while it waits for itself
+            if ((log_level < Level::Error && drop_when_full.load(std::memory_order_relaxed)) ||
+                std::this_thread::get_id() == writer_thread.get_id()) {
+                dropped_messages.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            WakeWriter();
+            std::this_thread::yield();
+            position = write_position.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (!write_position.compare_exchange_weak(position, position + padding + record_size,
+                                                  std::memory_order_relaxed)) {
+            continue;
+        }
+
+        if (padding != 0) {
+            // Only the size and class fit into the smallest padding
+            auto* const padding_header = reinterpret_cast<RecordHeader*>(&ring[offset]);
+            padding_header->log_class = Class::Count;
+            std::atomic_ref<u32>{padding_header->size}.store(static_cast<u32>(padding));
+        }
+        const u64 record_offset = (offset + padding) % ring_size;
+        auto* const header = reinterpret_cast<RecordHeader*>(&ring[record_offset]);
+        header->timestamp = Now();
+        return header;
+    }
+}
+
+void RecordRing::Commit(RecordHeader* header, std::size_t size) {
+    std::atomic_ref<u32>{header->size}.store(
+        static_cast<u32>(Common::AlignUp(size, RECORD_ALIGNMENT)));
+    if (writer_waiting.load()) {
+        WakeWriter();
+    }
+}
+
+void RecordRing::Run() {
+    std::optional<u64> stop_position;
+    while (true) {
+        const u64 position = read_position.load(std::memory_order_relaxed);
+        if (!stop_position && stop.load()) {
+            // Only write what was logged until now, in case a thread keeps on logging
+            stop_position = write_position.load();
+        }
+        if (stop_position && position >= *stop_position) {
+            break;
+        }
+
+        auto* const header = reinterpret_cast<RecordHeader*>(&ring[position % ring_size]);
+        const u32 size = std::atomic_ref<u32>{header->size}.load();
+        if (size == 0) {
+            if (stop_position) {
+                // The record was never completed
+                break;
+            }
+            WaitForRecords(*header);
+            continue;
+        }
+
+        if (header->log_class != Class::Count) {
+            writer(*header, size);
+            WriteDroppedRecord();
+        }
+        std::memset(header, 0, size);
+        read_position.store(position + size, std::memory_order_release);
+    }
+    WriteDroppedRecord();
+}
+
+void RecordRing::WaitForRecords(RecordHeader& next_record) {
+    std::unique_lock lock{wait_mutex};
+    writer_waiting = true;
+    wait_cv.wait_for(lock, std::chrono::milliseconds(100), [this, &next_record] {
+        return std::atomic_ref<u32>{next_record.size}.load() != 0 || stop.load();
+    });
+    writer_waiting = false;
+}
+
+void RecordRing::WakeWriter() {
+    std::lock_guard lock{wait_mutex};
+    wait_cv.notify_one();
+}
+
+void RecordRing::WriteDroppedRecord() {
+    const u64 dropped = dropped_messages.exchange(0, std::memory_order_relaxed);
+    if (dropped == 0) {
+        return;
+    }
+
+    // The strings need addresses of their own for binary logs
+    static constexpr char filename[] = "";
+    static constexpr char function[] = "";
+    constexpr std::size_t size = sizeof(RecordHeader) + 1 + sizeof(u64);
+    std::array<u64, Common::AlignUp(size, RECORD_ALIGNMENT) / sizeof(u64)> record{};
+    auto* const header = reinterpret_cast<RecordHeader*>(record.data());
+    header->size = static_cast<u32>(record.size() * sizeof(u64));
+    header->log_class = Class::Log;
+    header->log_level = Level::Warning;
+    header->num_args = 1;
+    header->timestamp = Now();
+    header->filename = reinterpret_cast<uintptr_t>(filename);
+    header->function = reinterpret_cast<uintptr_t>(function);
+    header->format = reinterpret_cast<uintptr_t>(DROPPED_FORMAT);
+    Detail::PackArg<u64>(reinterpret_cast<u8*>(header + 1), dropped);
+    writer(*header, header->size);
+}
+
+} // namespace Log
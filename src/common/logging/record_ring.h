@@ -0,0 +1,99 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "common/logging/record.h"
+
+namespace Log {
+
+/**
+ * Passes records from the logging threads to a writer thread.
+ *
+ * Logging threads reserve space for a record by advancing the write position, fill it in and then
+ * set its size to hand it over. The writer thread passes the records to the writer in order and
+ * clears them before advancing the read position, so that the size of a record is 0 until it is
+ * complete. Records never wrap around, the end of the ring is skipped with padding instead.
+ *
+ * When the ring is full, logging threads wait for the writer thread to make room. Messages below
+ * Error can be dropped instead with SetDropWhenFull, the writer then receives a record telling
+ * how many were dropped.
+ */
+class RecordRing {
+public:
+    /// Receives a complete record and its size in bytes, including padding
+    using Writer = std::function<void(const RecordHeader& header, u32 size)>;
+
+    /// Format of the record written after messages were dropped, with the count as argument
+    static constexpr const char* DROPPED_FORMAT = "{} log messages were dropped";
+
+    /**
+     * Starts the writer thread.
+     * @param size the size of the ring in bytes, a multiple of RECORD_ALIGNMENT.
+     */
+    RecordRing(std::size_t size, Writer writer);
+
+    /// Writes the records committed until now and stops the writer thread
+    ~RecordRing();
+
+    RecordRing(const RecordRing&) = delete;
+    RecordRing& operator=(const RecordRing&) = delete;
+
+    /**
+     * Reserves space for a record, see Log::ReserveRecord.
+     * @return the record to fill in, with its timestamp set, or nullptr if the message was dropped.
+     */
+    RecordHeader* Reserve(std::size_t size, Level log_level);
+
+    /// Hands a record filled after Reserve over to the writer thread
+    void Commit(RecordHeader* header, std::size_t size);
+
+    /// Sets whether messages below Error are dropped instead of waiting when the ring is full
+    void SetDropWhenFull(bool enabled) {
+        drop_when_full.store(enabled, std::memory_order_relaxed);
+    }
+
+private:
+    void Run();
+    void WaitForRecords(RecordHeader& next_record);
+    void WakeWriter();
+
+    /// Passes a record with the number of messages dropped since the last call, if any
+    void WriteDroppedRecord();
+
+    s64 Now() const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+                   std::chrono::steady_clock::now() - time_origin)
+            .count();
+    }
+
+    const std::size_t ring_size;
+    std::vector<u64> ring_storage;
+    u8* const ring;
+    Writer writer;
+
+    alignas(64) std::atomic<u64> write_position{0};
+    alignas(64) std::atomic<u64> read_position{0};
+    std::atomic<u64> dropped_messages{0};
+    std::atomic<bool> drop_when_full{false};
+
+    std::mutex wait_mutex;
+    std::condition_variable wait_cv;
+    std::atomic<bool> writer_waiting{false};
+    std::atomic<bool> stop{false};
+
+    std::chrono::steady_clock::time_point time_origin{std::chrono::steady_clock::now()};
+    std::thread writer_thread;
+};
+
+} // namespace Log
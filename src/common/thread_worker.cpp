@@ -0,0 +1,71 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include "common/thread.h"
+#include "common/thread_worker.h"
+
+namespace Common {
+
+ThreadWorker::ThreadWorker(std::size_t num_threads, std::string name_) : name(std::move(name_)) {
+    if (num_threads == 0) {
+        num_threads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    threads.reserve(num_threads);
+    for (std::size_t i = 0; i < num_threads; ++i) {
+        threads.emplace_back([this] { WorkerLoop(); });
+    }
+}
+
+ThreadWorker::~ThreadWorker() {
+    {
+        std::scoped_lock lock{queue_mutex};
+        stop = true;
+    }
+    work_available.notify_all();
+    for (auto& thread : threads) {
+        thread.join();
+    }
+}
+
+void ThreadWorker::QueueWork(std::function<void()> work) {
+    {
+        std::scoped_lock lock{queue_mutex};
+        requests.push(std::move(work));
+        ++active_requests;
+    }
+    work_available.notify_one();
+}
+
+void ThreadWorker::WaitForRequests() {
+    std::unique_lock lock{queue_mutex};
+    work_done.wait(lock, [this] { return active_requests == 0; });
+}
+
+void ThreadWorker::WorkerLoop() {
+    SetCurrentThreadName(name.c_str());
+    while (true) {
+        std::function<void()> work;
+        {
+            std::unique_lock lock{queue_mutex};
+            work_available.wait(lock, [this] { return stop || !requests.empty(); });
+            // Queued work is always finished before stopping
+            if (requests.empty()) {
+                return;
+            }
+            work = std::move(requests.front());
+            requests.pop();
+        }
+
+        work();
+
+        {
+            std::scoped_lock lock{queue_mutex};
+            --active_requests;
+        }
+        work_done.notify_all();
+    }
+}
+
+} // namespace Common
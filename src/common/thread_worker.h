@@ -0,0 +1,62 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace Common {
+
+/**
+ * A fixed-size pool of background threads executing queued work. With a single thread the work is
+ * executed in the order it was queued, which is relied upon by users that need serialized access
+ * to a resource that is not thread-safe.
+ */
+class ThreadWorker {
+public:
+    /**
+     * Starts the worker threads.
+     * @param num_threads Number of threads. Zero selects the number of hardware threads.
+     * @param name Name given to the threads, for debugging purposes.
+     */
+    explicit ThreadWorker(std::size_t num_threads, std::string name);
+
+    /// Finishes all queued work and stops the threads.
+    ~ThreadWorker();
+
+    ThreadWorker(const ThreadWorker&) = delete;
+    ThreadWorker& operator=(const ThreadWorker&) = delete;
+
+    /// Queues work to be executed by one of the threads.
+    void QueueWork(std::function<void()> work);
+
+    /// Blocks until all queued work has finished executing.
+    void WaitForRequests();
+
+    /// Returns the number of threads in the pool.
+    std::size_t NumThreads() const {
+        return threads.size();
+    }
+
+private:
+    void WorkerLoop();
+
+    std::string name;
+    std::vector<std::thread> threads;
+    std::queue<std::function<void()>> requests;
+    std::mutex queue_mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_done;
+    std::size_t active_requests = 0;
+    bool stop = false;
+};
+
+} // namespace Common
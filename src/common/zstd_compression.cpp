@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <cstring>
 #include <zstd.h>
 
 #include "common/assert.h"
+#include "common/file_util.h"
 #include "common/zstd_compression.h"
 
 namespace Common::Compression {
@@ -29,8 +31,10 @@ std::vector<u8> CompressDataZSTD(const u8* source, std::size_t source_size, s32
     return compressed;
 }
 
+static_assert(ZSTD_DEFAULT_COMPRESSION_LEVEL == ZSTD_CLEVEL_DEFAULT);
+
 std::vector<u8> CompressDataZSTDDefault(const u8* source, std::size_t source_size) {
-    return CompressDataZSTD(source, source_size, ZSTD_CLEVEL_DEFAULT);
+    return CompressDataZSTD(source, source_size, ZSTD_DEFAULT_COMPRESSION_LEVEL);
 }
 
 std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
@@ -48,4 +52,149 @@ std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed) {
     return decompressed;
 }
 
+struct ZstdCompressStreamBuffer::Context {
+    ~Context() {
+        ZSTD_freeCCtx(cctx);
+    }
+
+    ZSTD_CCtx* cctx = ZSTD_createCCtx();
+};
+
+ZstdCompressStreamBuffer::ZstdCompressStreamBuffer(FileUtil::IOFile& file_,
+                                                   s32 compression_level, u32 num_workers)
+    : file{file_}, context{std::make_unique<Context>()}, input(ZSTD_CStreamInSize()),
+      output(ZSTD_CStreamOutSize()) {
+    compression_level = std::clamp(compression_level, ZSTD_minCLevel(), ZSTD_maxCLevel());
+    ZSTD_CCtx_setParameter(context->cctx, ZSTD_c_compressionLevel, compression_level);
+    // Fails when zstd was built without threading, compressing on this thread works all the same
+    ZSTD_CCtx_setParameter(context->cctx, ZSTD_c_nbWorkers, static_cast<int>(num_workers));
+    setp(input.data(), input.data() + input.size());
+}
+
+ZstdCompressStreamBuffer::~ZstdCompressStreamBuffer() = default;
+
+bool ZstdCompressStreamBuffer::Finish() {
+    return Compress(nullptr, 0, true);
+}
+
+ZstdCompressStreamBuffer::int_type ZstdCompressStreamBuffer::overflow(int_type ch) {
+    if (!Compress(nullptr, 0, false)) {
+        return traits_type::eof();
+    }
+    if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+    }
+    return traits_type::not_eof(ch);
+}
+
+std::streamsize ZstdCompressStreamBuffer::xsputn(const char* data, std::streamsize count) {
+    const auto length = static_cast<std::size_t>(count);
+    if (static_cast<std::size_t>(epptr() - pptr()) >= length) {
+        std::memcpy(pptr(), data, length);
+        pbump(static_cast<int>(count));
+        return count;
+    }
+    // Feed large writes to zstd directly instead of copying them through the buffer
+    return Compress(data, length, false) ? count : 0;
+}
+
+bool ZstdCompressStreamBuffer::Compress(const char* data, std::size_t length, bool end) {
+    const auto CompressInput = [this](const void* source, std::size_t size,
+                                      ZSTD_EndDirective mode) {
+        ZSTD_inBuffer in{source, size, 0};
+        while (true) {
+            ZSTD_outBuffer out{output.data(), output.size(), 0};
+            const std::size_t remaining = ZSTD_compressStream2(context->cctx, &out, &in, mode);
+            if (ZSTD_isError(remaining) || file.WriteBytes(output.data(), out.pos) != out.pos) {
+                return false;
+            }
+            const bool done = mode == ZSTD_e_end ? remaining == 0 : in.pos == in.size;
+            if (done) {
+                return true;
+            }
+        }
+    };
+
+    if (failed) {
+        return false;
+    }
+    const std::size_t buffered = static_cast<std::size_t>(pptr() - pbase());
+    setp(input.data(), input.data() + input.size());
+    failed = !CompressInput(input.data(), buffered, data || !end ? ZSTD_e_continue : ZSTD_e_end) ||
+             (data && !CompressInput(data, length, end ? ZSTD_e_end : ZSTD_e_continue));
+    return !failed;
+}
+
+struct ZstdDecompressStreamBuffer::Context {
+    ~Context() {
+        ZSTD_freeDCtx(dctx);
+    }
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+};
+
+ZstdDecompressStreamBuffer::ZstdDecompressStreamBuffer(FileUtil::IOFile& file_,
+                                                       u64 compressed_size)
+    : file{file_}, compressed_remaining{compressed_size}, context{std::make_unique<Context>()},
+      input(ZSTD_DStreamInSize()), output(ZSTD_DStreamOutSize()) {}
+
+ZstdDecompressStreamBuffer::~ZstdDecompressStreamBuffer() = default;
+
+ZstdDecompressStreamBuffer::int_type ZstdDecompressStreamBuffer::underflow() {
+    if (gptr() < egptr()) {
+        return traits_type::to_int_type(*gptr());
+    }
+    const std::size_t length = Decompress(output.data(), output.size());
+    if (length == 0) {
+        return traits_type::eof();
+    }
+    setg(output.data(), output.data(), output.data() + length);
+    return traits_type::to_int_type(*gptr());
+}
+
+std::streamsize ZstdDecompressStreamBuffer::xsgetn(char* data, std::streamsize count) {
+    auto length = static_cast<std::size_t>(count);
+    const std::size_t buffered = std::min(length, static_cast<std::size_t>(egptr() - gptr()));
+    std::memcpy(data, gptr(), buffered);
+    gbump(static_cast<int>(buffered));
+
+    // Decompress large reads straight into the destination instead of through the buffer
+    std::size_t copied = buffered;
+    while (copied < length) {
+        const std::size_t decompressed = Decompress(data + copied, length - copied);
+        if (decompressed == 0) {
+            break;
+        }
+        copied += decompressed;
+    }
+    return static_cast<std::streamsize>(copied);
+}
+
+std::size_t ZstdDecompressStreamBuffer::Decompress(char* data, std::size_t length) {
+    ZSTD_outBuffer out{data, length, 0};
+    while (out.pos == 0 && !frame_finished) {
+        if (input_position == input_size && compressed_remaining != 0) {
+            const auto read_size =
+                static_cast<std::size_t>(std::min<u64>(input.size(), compressed_remaining));
+            input_size = file.ReadBytes(input.data(), read_size);
+            input_position = 0;
+            // Stop reading at the first failure, the data then ends up truncated
+            compressed_remaining = input_size == read_size ? compressed_remaining - read_size : 0;
+        }
+
+        // zstd may still hold back output once all the input is consumed, so keep calling it
+        // until it makes no more progress
+        ZSTD_inBuffer in{input.data(), input_size, input_position};
+        const std::size_t result = ZSTD_decompressStream(context->dctx, &out, &in);
+        const bool progress = in.pos != input_position || out.pos != 0;
+        input_position = in.pos;
+        if (ZSTD_isError(result) || (!progress && compressed_remaining == 0)) {
+            break;
+        }
+        frame_finished = result == 0;
+    }
+    return out.pos;
+}
+
 } // namespace Common::Compression
@@ -4,12 +4,21 @@
 
 #pragma once
 
+#include <memory>
+#include <streambuf>
 #include <vector>
 
 #include "common/common_types.h"
 
+namespace FileUtil {
+class IOFile;
+}
+
 namespace Common::Compression {
 
+/// Compression level used by CompressDataZSTDDefault, the same as zstd's own default
+constexpr s32 ZSTD_DEFAULT_COMPRESSION_LEVEL = 3;
+
 /**
  * Compresses a source memory region with Zstandard and returns the compressed data in a vector.
  *
@@ -42,4 +51,75 @@ namespace Common::Compression {
  */
 [[nodiscard]] std::vector<u8> DecompressDataZSTD(const std::vector<u8>& compressed);
 
+/**
+ * Stream buffer compressing everything written to it into a single Zstandard frame, which is
+ * written to a file as it goes. Large inputs are compressed on several worker threads. Only a
+ * small constant amount of data is buffered, however large the input is.
+ */
+class ZstdCompressStreamBuffer final : public std::streambuf {
+public:
+    /**
+     * @param file the file the compressed data is written to, from its current position on.
+     * @param compression_level the used compression level. Should be between 1 and 22.
+     * @param num_workers the number of worker threads, 0 compresses on the calling thread.
+     */
+    ZstdCompressStreamBuffer(FileUtil::IOFile& file, s32 compression_level, u32 num_workers);
+    ~ZstdCompressStreamBuffer() override;
+
+    /**
+     * Compresses the remaining data and ends the frame.
+     * @return false if compressing or writing failed at any point.
+     */
+    [[nodiscard]] bool Finish();
+
+protected:
+    int_type overflow(int_type ch) override;
+    std::streamsize xsputn(const char* data, std::streamsize count) override;
+
+private:
+    struct Context;
+
+    /// Compresses the buffered data and then the given data
+    bool Compress(const char* data, std::size_t length, bool end);
+
+    FileUtil::IOFile& file;
+    std::unique_ptr<Context> context;
+    std::vector<char> input;
+    std::vector<u8> output;
+    bool failed = false;
+};
+
+/**
+ * Stream buffer decompressing a Zstandard frame read from a file as it goes. Large reads are
+ * decompressed straight into the destination.
+ */
+class ZstdDecompressStreamBuffer final : public std::streambuf {
+public:
+    /**
+     * @param file the file the compressed data is read from, from its current position on.
+     * @param compressed_size the size of the compressed data, nothing past it is read.
+     */
+    ZstdDecompressStreamBuffer(FileUtil::IOFile& file, u64 compressed_size);
+    ~ZstdDecompressStreamBuffer() override;
+
+protected:
+    int_type underflow() override;
+    std::streamsize xsgetn(char* data, std::streamsize count) override;
+
+private:
+    struct Context;
+
+    /// Decompresses up to length bytes into the destination, returns the amount decompressed
+    std::size_t Decompress(char* data, std::size_t length);
+
+    FileUtil::IOFile& file;
+    u64 compressed_remaining;
+    std::unique_ptr<Context> context;
+    std::vector<u8> input;
+    std::size_t input_position = 0;
+    std::size_t input_size = 0;
+    std::vector<char> output;
+    bool frame_finished = false;
+};
+
 } // namespace Common::Compression
@@ -0,0 +1,223 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <zstd.h>
+#include "common/zstd_compression.h"
+#include "common/zstd_seekable.h"
+
+namespace Common::Compression {
+
+// Layout from contrib/seekable_format/zstd_seekable_compression_format.md in the zstd sources
+constexpr u32 SKIPPABLE_FRAME_MAGIC = 0x184D2A5E;
+constexpr u32 SEEKABLE_MAGIC = 0x8F92EAB1;
+constexpr std::size_t SKIPPABLE_HEADER_SIZE = 8;
+constexpr std::size_t SEEK_TABLE_FOOTER_SIZE = 9;
+constexpr std::size_t SEEK_TABLE_ENTRY_SIZE = 8;
+constexpr std::size_t SEEK_TABLE_CHECKSUM_SIZE = 4;
+constexpr u8 SEEK_TABLE_CHECKSUM_FLAG = 0x80;
+constexpr u8 SEEK_TABLE_RESERVED_BITS = 0x7C;
+
+static void WriteLE32(std::vector<u8>& out, u32 value) {
+    for (int i = 0; i < 4; i++) {
+        out.push_back(static_cast<u8>(value >> (i * 8)));
+    }
+}
+
+static u32 ReadLE32(const u8* data) {
+    return data[0] | (data[1] << 8) | (data[2] << 16) | (static_cast<u32>(data[3]) << 24);
+}
+
+std::vector<u8> CompressSeekableZstdFrame(const u8* source, std::size_t source_size,
+                                          s32 compression_level) {
+    if (source_size > SEEKABLE_ZSTD_MAX_FRAME_SIZE) {
+        return {};
+    }
+    return CompressDataZSTD(source, source_size, compression_level);
+}
+
+std::vector<u8> BuildSeekableZstdSeekTable(const std::vector<SeekableZstdFrame>& frames) {
+    std::vector<u8> table;
+    table.reserve(SKIPPABLE_HEADER_SIZE + frames.size() * SEEK_TABLE_ENTRY_SIZE +
+                  SEEK_TABLE_FOOTER_SIZE);
+
+    WriteLE32(table, SKIPPABLE_FRAME_MAGIC);
+    WriteLE32(table,
+              static_cast<u32>(frames.size() * SEEK_TABLE_ENTRY_SIZE + SEEK_TABLE_FOOTER_SIZE));
+    for (const auto& frame : frames) {
+        WriteLE32(table, frame.compressed_size);
+        WriteLE32(table, frame.decompressed_size);
+    }
+    WriteLE32(table, static_cast<u32>(frames.size()));
+    table.push_back(0); // No checksums
+    WriteLE32(table, SEEKABLE_MAGIC);
+    return table;
+}
+
+struct SeekableZstdReader::DecompressionContext {
+    ~DecompressionContext() {
+        ZSTD_freeDCtx(dctx);
+    }
+
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+};
+
+SeekableZstdReader::~SeekableZstdReader() = default;
+
+std::unique_ptr<SeekableZstdReader> SeekableZstdReader::Open(ReadFunction read,
+                                                             u64 compressed_size) {
+    if (compressed_size < SKIPPABLE_HEADER_SIZE + SEEK_TABLE_FOOTER_SIZE) {
+        return nullptr;
+    }
+
+    std::array<u8, SEEK_TABLE_FOOTER_SIZE> footer;
+    if (read(compressed_size - footer.size(), footer.data(), footer.size()) != footer.size() ||
+        ReadLE32(footer.data() + 5) != SEEKABLE_MAGIC) {
+        return nullptr;
+    }
+
+    const u32 frame_count = ReadLE32(footer.data());
+    const u8 descriptor = footer[4];
+    if ((descriptor & SEEK_TABLE_RESERVED_BITS) != 0) {
+        return nullptr;
+    }
+    const std::size_t entry_size = (descriptor & SEEK_TABLE_CHECKSUM_FLAG) != 0
+                                       ? SEEK_TABLE_ENTRY_SIZE + SEEK_TABLE_CHECKSUM_SIZE
+                                       : SEEK_TABLE_ENTRY_SIZE;
+    const u64 table_size =
+        SKIPPABLE_HEADER_SIZE + u64{frame_count} * entry_size + SEEK_TABLE_FOOTER_SIZE;
+    if (table_size > compressed_size) {
+        return nullptr;
+    }
+
+    std::vector<u8> table(static_cast<std::size_t>(table_size));
+    if (read(compressed_size - table_size, table.data(), table.size()) != table.size() ||
+        ReadLE32(table.data()) != SKIPPABLE_FRAME_MAGIC ||
+        ReadLE32(table.data() + 4) != table_size - SKIPPABLE_HEADER_SIZE) {
+        return nullptr;
+    }
+
+    std::unique_ptr<SeekableZstdReader> reader{new SeekableZstdReader()};
+    reader->frames.resize(frame_count);
+    reader->compressed_offsets.resize(frame_count);
+    reader->frame_offsets.resize(frame_count + 1);
+
+    u64 compressed_offset = 0;
+    u64 decompressed_offset = 0;
+    std::size_t max_compressed_size = 0;
+    for (u32 i = 0; i < frame_count; i++) {
+        const u8* entry = table.data() + SKIPPABLE_HEADER_SIZE + i * entry_size;
+        auto& frame = reader->frames[i];
+        frame.compressed_size = ReadLE32(entry);
+        frame.decompressed_size = ReadLE32(entry + 4);
+        if (frame.decompressed_size > SEEKABLE_ZSTD_MAX_FRAME_SIZE ||
+            frame.compressed_size > ZSTD_compressBound(SEEKABLE_ZSTD_MAX_FRAME_SIZE)) {
+            return nullptr;
+        }
+
+        reader->compressed_offsets[i] = compressed_offset;
+        reader->frame_offsets[i] = decompressed_offset;
+        compressed_offset += frame.compressed_size;
+        decompressed_offset += frame.decompressed_size;
+        max_compressed_size = std::max<std::size_t>(max_compressed_size, frame.compressed_size);
+    }
+    reader->frame_offsets[frame_count] = decompressed_offset;
+
+    // The frames have to fill everything in front of the seek table
+    if (compressed_offset != compressed_size - table_size) {
+        return nullptr;
+    }
+
+    reader->read = std::move(read);
+    reader->context = std::make_unique<DecompressionContext>();
+    reader->compressed_buffer.resize(max_compressed_size);
+    return reader;
+}
+
+std::size_t SeekableZstdReader::Read(u64 offset, void* buffer, std::size_t length) {
+    const u64 size = GetSize();
+    if (length == 0 || offset >= size) {
+        return 0;
+    }
+    length = static_cast<std::size_t>(std::min<u64>(length, size - offset));
+
+    // Index of the last frame starting at or before offset
+    std::size_t index = static_cast<std::size_t>(
+        std::upper_bound(frame_offsets.begin(), frame_offsets.end() - 1, offset) -
+        frame_offsets.begin() - 1);
+
+    auto* out = static_cast<u8*>(buffer);
+    std::size_t copied = 0;
+    for (; copied < length; index++) {
+        const u64 position = offset + copied;
+        const std::size_t frame_offset = static_cast<std::size_t>(position - frame_offsets[index]);
+        const std::size_t frame_size = frames[index].decompressed_size;
+        const std::size_t copy_length = std::min(length - copied, frame_size - frame_offset);
+
+        // Reading a whole frame would only flush the cache, decompress it straight into the
+        // destination instead
+        if (frame_offset == 0 && copy_length == frame_size) {
+            if (!DecompressFrame(index, out + copied)) {
+                break;
+            }
+        } else {
+            const CachedFrame* frame = GetCachedFrame(index);
+            if (!frame) {
+                break;
+            }
+            std::memcpy(out + copied, frame->data.data() + frame_offset, copy_length);
+        }
+        copied += copy_length;
+    }
+    return copied;
+}
+
+bool SeekableZstdReader::DecompressFrame(std::size_t index, u8* buffer) {
+    const SeekableZstdFrame& frame = frames[index];
+    if (read(compressed_offsets[index], compressed_buffer.data(), frame.compressed_size) !=
+        frame.compressed_size) {
+        return false;
+    }
+
+    const std::size_t result =
+        ZSTD_decompressDCtx(context->dctx, buffer, frame.decompressed_size,
+                            compressed_buffer.data(), frame.compressed_size);
+    return !ZSTD_isError(result) && result == frame.decompressed_size;
+}
+
+const SeekableZstdReader::CachedFrame* SeekableZstdReader::GetCachedFrame(std::size_t index) {
+    ++cache_tick;
+
+    auto it = std::find_if(cache.begin(), cache.end(),
+                           [index](const CachedFrame& frame) { return frame.index == index; });
+    if (it != cache.end()) {
+        it->last_use = cache_tick;
+        return &*it;
+    }
+
+    CachedFrame* frame;
+    if (cache.size() < CACHE_FRAME_COUNT) {
+        frame = &cache.emplace_back();
+    } else {
+        frame = &*std::min_element(cache.begin(), cache.end(),
+                                   [](const CachedFrame& a, const CachedFrame& b) {
+                                       return a.last_use < b.last_use;
+                                   });
+    }
+
+    frame->data.resize(frames[index].decompressed_size);
+    if (!DecompressFrame(index, frame->data.data())) {
+        // Never keep a failed frame around, the next access should retry it
+        frame->index = ~std::size_t{0};
+        frame->last_use = 0;
+        return nullptr;
+    }
+    frame->index = index;
+    frame->last_use = cache_tick;
+    return frame;
+}
+
+} // namespace Common::Compression
@@ -0,0 +1,111 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Common::Compression {
+
+/**
+ * Support for the zstd seekable format. The data is split in frames that are compressed
+ * independently and followed by a skippable frame holding the compressed and decompressed size of
+ * every frame. The result is still a regular zstd stream that the zstd command line tool can
+ * decompress, but any part of it can be read by only decompressing the frames covering it.
+ */
+
+/// Default decompressed size of a frame, large enough to compress well while keeping small
+/// reads cheap
+constexpr std::size_t SEEKABLE_ZSTD_DEFAULT_FRAME_SIZE = 0x20000;
+
+/// Largest decompressed frame size accepted when reading
+constexpr std::size_t SEEKABLE_ZSTD_MAX_FRAME_SIZE = 0x1000000;
+
+struct SeekableZstdFrame {
+    u32 compressed_size;
+    u32 decompressed_size;
+};
+
+/**
+ * Compresses a frame of a seekable archive.
+ * @param source the uncompressed data, at most SEEKABLE_ZSTD_MAX_FRAME_SIZE bytes.
+ * @param source_size the size in bytes of the uncompressed data.
+ * @param compression_level the used compression level. Should be between 1 and 22.
+ * @return the compressed frame, empty if compression failed.
+ */
+[[nodiscard]] std::vector<u8> CompressSeekableZstdFrame(const u8* source, std::size_t source_size,
+                                                        s32 compression_level);
+
+/**
+ * Builds the seek table that has to follow the frames of a seekable archive.
+ * @param frames the sizes of the frames, in the order they are stored in.
+ * @return the seek table.
+ */
+[[nodiscard]] std::vector<u8> BuildSeekableZstdSeekTable(
+    const std::vector<SeekableZstdFrame>& frames);
+
+/**
+ * Random access reader for seekable archives. Recently decompressed frames are kept in a small
+ * cache, reads covering whole frames are decompressed straight into the destination.
+ */
+class SeekableZstdReader {
+public:
+    /// Reads compressed data from the given offset of the archive, returns the bytes read
+    using ReadFunction = std::function<std::size_t(u64 offset, void* buffer, std::size_t length)>;
+
+    ~SeekableZstdReader();
+
+    /**
+     * Parses the seek table of an archive.
+     * @param read function reading the compressed data.
+     * @param compressed_size the size of the archive.
+     * @return the reader, or nullptr if the data is not a valid seekable archive.
+     */
+    [[nodiscard]] static std::unique_ptr<SeekableZstdReader> Open(ReadFunction read,
+                                                                  u64 compressed_size);
+
+    /// Returns the decompressed size of the archive
+    [[nodiscard]] u64 GetSize() const {
+        return frame_offsets.back();
+    }
+
+    /**
+     * Reads decompressed data.
+     * @return the bytes read, less than length at the end of the data or on errors.
+     */
+    std::size_t Read(u64 offset, void* buffer, std::size_t length);
+
+private:
+    static constexpr std::size_t CACHE_FRAME_COUNT = 8;
+
+    struct DecompressionContext;
+
+    struct CachedFrame {
+        std::size_t index = 0;
+        u64 last_use = 0;
+        std::vector<u8> data;
+    };
+
+    SeekableZstdReader() = default;
+
+    /// Decompresses a frame into the buffer, returns false on errors
+    bool DecompressFrame(std::size_t index, u8* buffer);
+
+    const CachedFrame* GetCachedFrame(std::size_t index);
+
+    ReadFunction read;
+    std::vector<SeekableZstdFrame> frames;
+    std::vector<u64> compressed_offsets; ///< Offset of each frame in the archive
+    std::vector<u64> frame_offsets;      ///< Decompressed offset of each frame, plus the end
+
+    std::unique_ptr<DecompressionContext> context;
+    std::vector<u8> compressed_buffer;
+    std::vector<CachedFrame> cache;
+    u64 cache_tick = 0;
+};
+
+} // namespace Common::Compression
@@ -0,0 +1,276 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/scm_rev.h"
+#include "common/zstd_seekable.h"
+#include "core/file_sys/romfs_reader.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <input> <output>\n"
+                 "       "
+              << argv0
+              << " --benchmark <image>...\n"
+                 "Converts a 3DS, CCI, CXI or CIA image to a seekable zstd archive that Citra can\n"
+                 "load and install directly. Archives can keep the extension of the image.\n\n"
+                 "-l, --level=N       The compression level from 1 to 22, defaults to 19\n"
+                 "-f, --frame-size=KB The decompressed size of each frame, defaults to 128\n"
+                 "-j, --jobs=N        Number of worker threads, defaults to all cores\n"
+                 "-d, --decompress    Write the decompressed image instead\n"
+                 "-b, --benchmark     Measure the read throughput of each image\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra compression tool " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+namespace {
+
+constexpr std::size_t MiB = 1024 * 1024;
+
+/// Compresses the input into a seekable archive, compressing the frames of a batch in parallel
+bool Compress(FileUtil::IOFile& input, FileUtil::IOFile& output, s32 level,
+              std::size_t frame_size, std::size_t num_workers) {
+    const std::size_t frames_per_batch = num_workers * 4;
+    std::vector<u8> batch(frames_per_batch * frame_size);
+    std::vector<std::vector<u8>> compressed(frames_per_batch);
+    std::vector<Common::Compression::SeekableZstdFrame> frames;
+
+    const u64 input_size = input.GetSize();
+    for (u64 position = 0; position < input_size;) {
+        const auto batch_size =
+            static_cast<std::size_t>(std::min<u64>(batch.size(), input_size - position));
+        if (input.ReadBytes(batch.data(), batch_size) != batch_size) {
+            std::cout << "Failed to read the input\n";
+            return false;
+        }
+
+        const std::size_t num_frames = (batch_size + frame_size - 1) / frame_size;
+        std::atomic<std::size_t> next_frame = 0;
+        const auto CompressFrames = [&] {
+            for (std::size_t i = next_frame++; i < num_frames; i = next_frame++) {
+                const std::size_t offset = i * frame_size;
+                compressed[i] = Common::Compression::CompressSeekableZstdFrame(
+                    batch.data() + offset, std::min(frame_size, batch_size - offset), level);
+            }
+        };
+
+        std::vector<std::thread> threads(std::min(num_workers, num_frames));
+        for (auto& thread : threads) {
+            thread = std::thread(CompressFrames);
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (std::size_t i = 0; i < num_frames; i++) {
+            if (compressed[i].empty() ||
+                output.WriteBytes(compressed[i].data(), compressed[i].size()) !=
+                    compressed[i].size()) {
+                std::cout << "Failed to compress or write frame " << frames.size() << "\n";
+                return false;
+            }
+            frames.push_back({static_cast<u32>(compressed[i].size()),
+                              static_cast<u32>(std::min(frame_size, batch_size - i * frame_size))});
+        }
+
+        position += batch_size;
+        std::cout << "\r" << position / MiB << " / " << input_size / MiB << " MiB" << std::flush;
+    }
+    std::cout << "\n";
+
+    const auto seek_table = Common::Compression::BuildSeekableZstdSeekTable(frames);
+    return output.WriteBytes(seek_table.data(), seek_table.size()) == seek_table.size();
+}
+
+/// Copies the input, which IOFile decompresses if it is an archive
+bool Decompress(FileUtil::IOFile& input, FileUtil::IOFile& output) {
+    std::vector<u8> buffer(4 * MiB);
+    const u64 input_size = input.GetSize();
+    for (u64 position = 0; position < input_size;) {
+        const auto length =
+            static_cast<std::size_t>(std::min<u64>(buffer.size(), input_size - position));
+        if (input.ReadBytes(buffer.data(), length) != length ||
+            output.WriteBytes(buffer.data(), length) != length) {
+            std::cout << "Failed to decompress the input\n";
+            return false;
+        }
+        position += length;
+    }
+    return true;
+}
+
+/// Reads the whole image through a RomFS reader, the path games read their files through
+void Benchmark(const std::string& path) {
+    FileUtil::IOFile file(path, "rb");
+    if (!file.IsOpen()) {
+        std::cout << "Failed to open " << path << "\n";
+        return;
+    }
+    const u64 compressed_size = FileUtil::GetSize(path);
+    const auto size = static_cast<std::size_t>(file.GetSize());
+    if (size == 0) {
+        std::cout << path << " is empty\n";
+        return;
+    }
+    FileSys::DirectRomFSReader reader(std::move(file), 0, size);
+
+    std::vector<u8> buffer(MiB);
+    const auto MeasureRandom = [&](std::size_t read_size, std::size_t num_reads) {
+        std::mt19937_64 rng{0};
+        std::uniform_int_distribution<std::size_t> distribution(0, size - read_size);
+        const auto start = std::chrono::steady_clock::now();
+        for (std::size_t i = 0; i < num_reads; i++) {
+            reader.ReadFile(distribution(rng), read_size, buffer.data());
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        return num_reads / elapsed.count();
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (std::size_t offset = 0; offset < size; offset += buffer.size()) {
+        reader.ReadFile(offset, buffer.size(), buffer.data());
+    }
+    const std::chrono::duration<double> sequential = std::chrono::steady_clock::now() - start;
+
+    std::cout << fmt::format("{}\n"
+                             "  size:              {:.1f} MiB ({:.1f}% of {:.1f} MiB)\n"
+                             "  sequential 1 MiB:  {:.1f} MiB/s\n"
+                             "  random 4 KiB:      {:.0f} reads/s\n"
+                             "  random 64 KiB:     {:.0f} reads/s\n",
+                             path, static_cast<double>(compressed_size) / MiB,
+                             100.0 * compressed_size / std::max<std::size_t>(size, 1),
+                             static_cast<double>(size) / MiB, size / sequential.count() / MiB,
+                             size < 0x1000 ? 0.0 : MeasureRandom(0x1000, 20000),
+                             size < 0x10000 ? 0.0 : MeasureRandom(0x10000, 5000));
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    s32 level = 19;
+    std::size_t frame_size = Common::Compression::SEEKABLE_ZSTD_DEFAULT_FRAME_SIZE;
+    std::size_t num_workers = std::max(1U, std::thread::hardware_concurrency());
+    bool decompress = false;
+    bool benchmark = false;
+
+    static struct option long_options[] = {
+        {"level", required_argument, 0, 'l'},
+        {"frame-size", required_argument, 0, 'f'},
+        {"jobs", required_argument, 0, 'j'},
+        {"decompress", no_argument, 0, 'd'},
+        {"benchmark", no_argument, 0, 'b'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    std::vector<std::string> paths;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "l:f:j:dbhv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'l':
+                level = static_cast<s32>(strtol(optarg, &endarg, 0));
+                break;
+            case 'f':
+                frame_size = strtoul(optarg, &endarg, 0) * 1024;
+                break;
+            case 'j':
+                num_workers = std::max<std::size_t>(1, strtoul(optarg, &endarg, 0));
+                break;
+            case 'd':
+                decompress = true;
+                break;
+            case 'b':
+                benchmark = true;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            paths.emplace_back(argv[optind]);
+            optind++;
+        }
+    }
+
+    if (benchmark) {
+        if (paths.empty()) {
+            PrintHelp(argv[0]);
+            return -1;
+        }
+        for (const auto& path : paths) {
+            Benchmark(path);
+        }
+        return 0;
+    }
+
+    if (paths.size() != 2) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+    if (frame_size == 0 || frame_size > Common::Compression::SEEKABLE_ZSTD_MAX_FRAME_SIZE) {
+        std::cout << "frame-size needs to be in the range 1 - "
+                  << Common::Compression::SEEKABLE_ZSTD_MAX_FRAME_SIZE / 1024 << "!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    FileUtil::IOFile input(paths[0], "rb");
+    if (!input.IsOpen()) {
+        std::cout << "Failed to open " << paths[0] << "\n";
+        return -1;
+    }
+    FileUtil::IOFile output(paths[1], "wb");
+    if (!output.IsOpen()) {
+        std::cout << "Failed to create " << paths[1] << "\n";
+        return -1;
+    }
+
+    const auto start_time = std::chrono::steady_clock::now();
+    const bool success = decompress ? Decompress(input, output)
+                                    : Compress(input, output, level, frame_size, num_workers);
+    output.Close();
+    if (!success) {
+        FileUtil::Delete(paths[1]);
+        return 1;
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    const u64 input_size = input.GetSize();
+    const u64 output_size = FileUtil::GetSize(paths[1]);
+    std::cout << fmt::format("{} -> {} bytes ({:.1f}%) in {:.1f}s\n", input_size, output_size,
+                             100.0 * output_size / std::max<u64>(input_size, 1),
+                             elapsed.count());
+    return 0;
+}
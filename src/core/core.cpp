@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <exception>
 #include <fstream>
 #include <memory>
 #include <stdexcept>
@@ -107,7 +108,13 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
     }
     switch (signal) {
     case Signal::Reset:
-        Reset();
+        try {
+            Reset();
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error saving: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
         return ResultStatus::Success;
     case Signal::Shutdown:
         return ResultStatus::ShutdownRequested;
@@ -127,8 +134,8 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
     case Signal::Save: {
         LOG_INFO(Core, "Begin save");
         try {
-            System::SaveState(param);
-            LOG_INFO(Core, "Save completed");
+            System::StartSaveState(param);
+            LOG_INFO(Core, "Save captured, writing it in the background");
         } catch (const std::exception& e) {
             LOG_ERROR(Core, "Error saving: {}", e.what());
             status_details = e.what();
@@ -137,10 +144,38 @@ System::ResultStatus System::RunLoop(bool tight_loop) {
         frame_limiter.WaitOnce();
         return ResultStatus::Success;
     }
+    case Signal::Rewind: {
+        try {
+            if (!System::Rewind()) {
+                LOG_INFO(Core, "No rewind snapshot left");
+            }
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error rewinding: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+        frame_limiter.WaitOnce();
+        return ResultStatus::Success;
+    }
     default:
         break;
     }
 
+    // Report the errors of a background save as soon as it is done
+    if (IsSaveStateFinished()) {
+        try {
+            FinishSaveState();
+        } catch (const std::exception& e) {
+            LOG_ERROR(Core, "Error saving: {}", e.what());
+            status_details = e.what();
+            return ResultStatus::ErrorSavestate;
+        }
+    }
+
+    if (rewind_buffer && rewind_buffer->IsCaptureDue(timing->GetGlobalTicks())) {
+        CaptureRewindSnapshot();
+    }
+
     // All cores should have executed the same amount of ticks. If this is not the case an event was
     // scheduled with a cycles_into_future smaller then the current downcount.
     // So we have to get those cores to the same global time first
@@ -310,6 +345,11 @@ System::ResultStatus System::Load(Frontend::EmuWindow& emu_window, const std::st
     }
     perf_stats = std::make_unique<PerfStats>(title_id);
     custom_tex_cache = std::make_unique<Core::CustomTexCache>();
+    if (Settings::values.enable_rewind) {
+        rewind_buffer = std::make_unique<RewindBuffer>(
+            Settings::values.rewind_interval,
+            static_cast<std::size_t>(Settings::values.rewind_buffer_size) * 1024 * 1024);
+    }
 
     if (Settings::values.custom_textures) {
         const u64 program_id = Kernel().GetCurrentProcess()->codeset->program_id;
@@ -515,6 +555,16 @@ void System::RegisterImageInterface(std::shared_ptr<Frontend::ImageInterface> im
 }
 
 void System::Shutdown(bool is_deserializing) {
+    // Let the background save finish, loading a save state has waited for it already
+    std::exception_ptr save_state_error;
+    if (!is_deserializing) {
+        try {
+            FinishSaveState();
+        } catch (...) {
+            save_state_error = std::current_exception();
+        }
+    }
+
     // Log last frame performance stats
     const auto perf_results = GetAndResetPerfStats();
     constexpr auto performance = Common::Telemetry::FieldType::Performance;
@@ -532,6 +582,7 @@ void System::Shutdown(bool is_deserializing) {
         GDBStub::Shutdown();
         perf_stats.reset();
         cheat_engine.reset();
+        rewind_buffer.reset();
         app_loader.reset();
     }
     telemetry_session.reset();
@@ -555,6 +606,10 @@ void System::Shutdown(bool is_deserializing) {
     memory.reset();
 
     LOG_DEBUG(Core, "Shutdown OK");
+
+    if (save_state_error) {
+        std::rethrow_exception(save_state_error);
+    }
 }
 
 void System::Reset() {
@@ -562,6 +617,9 @@ void System::Reset() {
     // reloading.
     // TODO: Properly implement the reset
 
+    // Report a failed background save while the system is still running
+    FinishSaveState();
+
     // Since the system is completely reinitialized, we'll have to store the deliver arg manually.
     boost::optional<Service::APT::AppletManager::DeliverArg> deliver_arg;
     if (auto apt = Service::APT::GetModule(*this)) {
@@ -600,9 +658,12 @@ void System::serialize(Archive& ar, const unsigned int file_version) {
             Init(*m_emu_window, *system_mode.first, *n3ds_mode.first, num_cores);
     }
 
-    // flush on save, don't flush on load
-    bool should_flush = !Archive::is_loading::value;
-    Memory::RasterizerClearAll(should_flush);
+    if (Archive::is_saving::value) {
+        // Write the surfaces back to RAM but keep them cached, loading uncaches their pages
+        Memory::RasterizerFlushRegion(0x0, 0xFFFFFFFF);
+    } else {
+        Memory::RasterizerClearAll(false);
+    }
     ar&* timing.get();
     for (u32 i = 0; i < num_cores; i++) {
         ar&* cpu_cores[i].get();
@@ -4,8 +4,11 @@
 
 #pragma once
 
+#include <functional>
+#include <future>
 #include <memory>
 #include <mutex>
+#include <optional>
 #include <string>
 #include <boost/serialization/version.hpp>
 #include "common/common_types.h"
@@ -16,6 +19,7 @@
 #include "core/loader/loader.h"
 #include "core/memory.h"
 #include "core/perf_stats.h"
+#include "core/rewind_buffer.h"
 #include "core/telemetry_session.h"
 
 class ARM_Interface;
@@ -112,13 +116,18 @@ public:
      */
     [[nodiscard]] ResultStatus SingleStep();
 
-    /// Shutdown the emulated system.
+    /**
+     * Shutdown the emulated system. Errors of the background save state write are rethrown once
+     * the system is shut down.
+     * @param is_deserializing Whether a save state is about to be loaded, which has waited for the
+     * background save state write already
+     */
     void Shutdown(bool is_deserializing = false);
 
-    /// Shutdown and then load again
+    /// Shutdown and then load again, rethrows the errors of the background save state write first
     void Reset();
 
-    enum class Signal : u32 { None, Shutdown, Reset, Save, Load };
+    enum class Signal : u32 { None, Shutdown, Reset, Save, Load, Rewind };
 
     bool SendSignal(Signal signal, u32 param = 0);
 
@@ -299,10 +308,37 @@ public:
         return registered_image_interface;
     }
 
-    void SaveState(u32 slot) const;
+    /**
+     * Copies the system and writes it to a save state slot on a background thread, only stopping
+     * emulation for the copy. Errors of the previous background save are rethrown.
+     */
+    void StartSaveState(u32 slot);
+
+    /// Waits for the background save state write to finish and rethrows its errors
+    void FinishSaveState();
+
+    /// Whether no background save state write is running
+    [[nodiscard]] bool IsSaveStateFinished() const;
+
+    /**
+     * Sets the function called when a background save state write finishes. It is called from
+     * the writing thread.
+     */
+    void SetSaveStateCallback(std::function<void(u32 slot, bool success)> callback);
 
     void LoadState(u32 slot);
 
+    /// Restores the newest rewind snapshot, returns false if there is none
+    bool Rewind();
+
+    /// Gets the statistics of the rewind buffer, if rewinding is enabled
+    [[nodiscard]] std::optional<RewindBuffer::Stats> GetRewindStats() const {
+        if (!rewind_buffer) {
+            return std::nullopt;
+        }
+        return rewind_buffer->GetStats();
+    }
+
 private:
     /**
      * Initialize the emulated system.
@@ -317,6 +353,9 @@ private:
     /// Reschedule the core emulation
     void Reschedule();
 
+    /// Hands a snapshot of the system to the rewind buffer
+    void CaptureRewindSnapshot();
+
     /// AppLoader used to load the current executing application
     std::unique_ptr<Loader::AppLoader> app_loader;
 
@@ -357,6 +396,13 @@ private:
 
     std::unique_ptr<Service::FS::ArchiveManager> archive_manager;
 
+    /// Snapshots to rewind to, only present while rewinding is enabled
+    std::unique_ptr<RewindBuffer> rewind_buffer;
+
+    /// Save state being written in the background
+    std::future<void> save_state_task;
+    std::function<void(u32 slot, bool success)> save_state_callback = [](u32, bool) {};
+
     std::unique_ptr<Memory::MemorySystem> memory;
     std::unique_ptr<Kernel::KernelSystem> kernel;
     std::unique_ptr<Timing> timing;
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <bit>
 #include <cinttypes>
 #include <tuple>
 #include "common/assert.h"
@@ -47,10 +48,11 @@ TimingEventType* Timing::RegisterEvent(const std::string& name, TimedCallback ca
     return event_type;
 }
 
-void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type, u64 userdata,
-                           std::size_t core_id) {
+Timing::EventHandle Timing::ScheduleEvent(s64 cycles_into_future,
+                                          const TimingEventType* event_type, u64 userdata,
+                                          std::size_t core_id) {
     if (event_queue_locked) {
-        return;
+        return {};
     }
 
     ASSERT(event_type != nullptr);
@@ -68,12 +70,16 @@ void Timing::ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_
         if (!timer->is_timer_sane)
             timer->ForceExceptionCheck(cycles_into_future);
 
-        timer->event_queue.emplace_back(
-            Event{timeout, timer->event_fifo_id++, userdata, event_type});
-        std::push_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+        EventHandle handle;
+        handle.timer = timer;
+        handle.index =
+            timer->InsertEvent(Event{timeout, timer->event_fifo_id++, userdata, event_type});
+        handle.generation = timer->nodes[handle.index].generation;
+        return handle;
     } else {
         timer->ts_queue.Push(Event{static_cast<s64>(timer->GetTicks() + cycles_into_future), 0,
                                    userdata, event_type});
+        return {};
     }
 }
 
@@ -81,32 +87,44 @@ void Timing::UnscheduleEvent(const TimingEventType* event_type, u64 userdata) {
     if (event_queue_locked) {
         return;
     }
-    for (auto timer : timers) {
-        auto itr = std::remove_if(
-            timer->event_queue.begin(), timer->event_queue.end(),
-            [&](const Event& e) { return e.type == event_type && e.userdata == userdata; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+    for (auto& timer : timers) {
+        const auto it = timer->events_by_key.find({event_type, userdata});
+        if (it == timer->events_by_key.end()) {
+            continue;
+        }
+        // RemoveNode erases the map entry together with the last event
+        for (u32 index = it->second; index != Timer::INVALID_NODE;) {
+            const u32 next = timer->nodes[index].key_next;
+            timer->RemoveNode(index);
+            index = next;
         }
     }
     // TODO:remove events from ts_queue
 }
 
+void Timing::UnscheduleEvent(const EventHandle& handle) {
+    if (event_queue_locked || handle.timer == nullptr) {
+        return;
+    }
+    Timer& timer = *handle.timer;
+    if (handle.index < timer.nodes.size()) {
+        const Timer::Node& node = timer.nodes[handle.index];
+        if (node.generation == handle.generation && node.bucket != Timer::FREE_BUCKET) {
+            timer.RemoveNode(handle.index);
+        }
+    }
+}
+
 void Timing::RemoveEvent(const TimingEventType* event_type) {
     if (event_queue_locked) {
         return;
     }
-    for (auto timer : timers) {
-        auto itr = std::remove_if(timer->event_queue.begin(), timer->event_queue.end(),
-                                  [&](const Event& e) { return e.type == event_type; });
-
-        // Removing random items breaks the invariant so we have to re-establish it.
-        if (itr != timer->event_queue.end()) {
-            timer->event_queue.erase(itr, timer->event_queue.end());
-            std::make_heap(timer->event_queue.begin(), timer->event_queue.end(), std::greater<>());
+    for (auto& timer : timers) {
+        for (u32 index = 0; index < timer->nodes.size(); ++index) {
+            const Timer::Node& node = timer->nodes[index];
+            if (node.bucket != Timer::FREE_BUCKET && node.event.type == event_type) {
+                timer->RemoveNode(index);
+            }
         }
     }
     // TODO:remove events from ts_queue
@@ -136,12 +154,198 @@ std::shared_ptr<Timing::Timer> Timing::GetTimer(std::size_t cpu_id) {
     return timers[cpu_id];
 }
 
-Timing::Timer::Timer() = default;
+Timing::Timer::Timer() {
+    buckets.fill(INVALID_NODE);
+}
 
 Timing::Timer::~Timer() {
     MoveEvents();
 }
 
+u32 Timing::Timer::InsertEvent(const Event& event) {
+    u32 index;
+    if (free_node != INVALID_NODE) {
+        index = free_node;
+        free_node = nodes[index].next;
+    } else {
+        index = static_cast<u32>(nodes.size());
+        nodes.emplace_back();
+    }
+
+    Node& node = nodes[index];
+    node.event = event;
+    LinkBucket(index);
+
+    // Events with the same type and userdata are chained so that UnscheduleEvent can find them
+    // without searching the wheel
+    u32& key_head = events_by_key.try_emplace({event.type, event.userdata}, INVALID_NODE)
+                        .first->second;
+    node.key_prev = INVALID_NODE;
+    node.key_next = key_head;
+    if (key_head != INVALID_NODE) {
+        nodes[key_head].key_prev = index;
+    }
+    key_head = index;
+    return index;
+}
+
+void Timing::Timer::RemoveNode(u32 index) {
+    UnlinkBucket(index);
+
+    Node& node = nodes[index];
+    if (node.key_prev != INVALID_NODE) {
+        nodes[node.key_prev].key_next = node.key_next;
+    } else if (node.key_next != INVALID_NODE) {
+        events_by_key[{node.event.type, node.event.userdata}] = node.key_next;
+    } else {
+        events_by_key.erase({node.event.type, node.event.userdata});
+    }
+    if (node.key_next != INVALID_NODE) {
+        nodes[node.key_next].key_prev = node.key_prev;
+    }
+
+    // Bumping the generation invalidates any handle still referring to this node
+    ++node.generation;
+    node.bucket = FREE_BUCKET;
+    node.next = free_node;
+    free_node = index;
+}
+
+void Timing::Timer::LinkBucket(u32 index) {
+    Node& node = nodes[index];
+    // Events that are already due are kept in the slot of the current time
+    const u64 time = static_cast<u64>(std::max(node.event.time, wheel_time));
+    const u64 diff = (time ^ static_cast<u64>(wheel_time)) >> WHEEL_GRANULARITY_BITS;
+    const std::size_t level =
+        diff == 0 ? 0 : (static_cast<std::size_t>(std::bit_width(diff)) - 1) / WHEEL_LEVEL_BITS;
+
+    if (level < WHEEL_LEVELS) {
+        const std::size_t slot =
+            (time >> (WHEEL_GRANULARITY_BITS + level * WHEEL_LEVEL_BITS)) & (WHEEL_SLOTS - 1);
+        node.bucket = static_cast<u32>(level * WHEEL_SLOTS + slot);
+        occupied_slots[level] |= u64{1} << slot;
+    } else {
+        node.bucket = OVERFLOW_BUCKET;
+    }
+
+    u32& head = buckets[node.bucket];
+    node.prev = INVALID_NODE;
+    node.next = head;
+    if (head != INVALID_NODE) {
+        nodes[head].prev = index;
+    }
+    head = index;
+}
+
+void Timing::Timer::UnlinkBucket(u32 index) {
+    const Node& node = nodes[index];
+    if (node.prev != INVALID_NODE) {
+        nodes[node.prev].next = node.next;
+    } else {
+        buckets[node.bucket] = node.next;
+        if (node.next == INVALID_NODE && node.bucket != OVERFLOW_BUCKET) {
+            occupied_slots[node.bucket / WHEEL_SLOTS] &= ~(u64{1} << (node.bucket % WHEEL_SLOTS));
+        }
+    }
+    if (node.next != INVALID_NODE) {
+        nodes[node.next].prev = node.prev;
+    }
+}
+
+u32 Timing::Timer::FindNextEvent() const {
+    // Every event on a level is due before the events on the levels above it, and within a level
+    // the slots are ordered by time, so only the first occupied slot needs to be searched.
+    u32 bucket = OVERFLOW_BUCKET;
+    for (std::size_t level = 0; level < WHEEL_LEVELS; ++level) {
+        if (occupied_slots[level] != 0) {
+            bucket = static_cast<u32>(level * WHEEL_SLOTS +
+                                      std::countr_zero(occupied_slots[level]));
+            break;
+        }
+    }
+
+    u32 next_event = buckets[bucket];
+    if (next_event == INVALID_NODE) {
+        return INVALID_NODE;
+    }
+    for (u32 index = nodes[next_event].next; index != INVALID_NODE; index = nodes[index].next) {
+        if (nodes[index].event < nodes[next_event].event) {
+            next_event = index;
+        }
+    }
+    return next_event;
+}
+
+void Timing::Timer::AdvanceWheel(s64 new_time) {
+    // All events due at or before new_time must have been removed already. The remaining events
+    // only have to move when new_time entered their slot, which can be at most one slot per level.
+    if (new_time <= wheel_time) {
+        return;
+    }
+    const s64 old_time = wheel_time;
+    wheel_time = new_time;
+
+    const auto redistribute = [this](u32 bucket) {
+        u32 index = buckets[bucket];
+        buckets[bucket] = INVALID_NODE;
+        if (bucket != OVERFLOW_BUCKET) {
+            occupied_slots[bucket / WHEEL_SLOTS] &= ~(u64{1} << (bucket % WHEEL_SLOTS));
+        }
+        while (index != INVALID_NODE) {
+            const u32 next = nodes[index].next;
+            LinkBucket(index);
+            index = next;
+        }
+    };
+
+    constexpr std::size_t wheel_bits = WHEEL_GRANULARITY_BITS + WHEEL_LEVELS * WHEEL_LEVEL_BITS;
+    if (((static_cast<u64>(old_time) ^ static_cast<u64>(new_time)) >> wheel_bits) != 0) {
+        redistribute(OVERFLOW_BUCKET);
+    }
+    // Go from the outermost level inwards, so that events can cascade down several levels
+    for (std::size_t level = WHEEL_LEVELS - 1; level > 0; --level) {
+        const std::size_t slot =
+            (static_cast<u64>(new_time) >> (WHEEL_GRANULARITY_BITS + level * WHEEL_LEVEL_BITS)) &
+            (WHEEL_SLOTS - 1);
+        if ((occupied_slots[level] >> slot) & 1) {
+            redistribute(static_cast<u32>(level * WHEEL_SLOTS + slot));
+        }
+    }
+}
+
+std::vector<Timing::Event> Timing::Timer::GetSortedEvents() const {
+    std::vector<Event> events;
+    for (const Node& node : nodes) {
+        if (node.bucket != FREE_BUCKET) {
+            events.push_back(node.event);
+        }
+    }
+    std::sort(events.begin(), events.end());
+    return events;
+}
+
+void Timing::Timer::ResetEvents(const std::vector<Event>& events) {
+    // The nodes are kept and their generations bumped, so handles from before the reset can not
+    // match the events inserted now
+    free_node = INVALID_NODE;
+    for (u32 index = static_cast<u32>(nodes.size()); index-- > 0;) {
+        Node& node = nodes[index];
+        if (node.bucket != FREE_BUCKET) {
+            ++node.generation;
+            node.bucket = FREE_BUCKET;
+        }
+        node.next = free_node;
+        free_node = index;
+    }
+    buckets.fill(INVALID_NODE);
+    occupied_slots.fill(0);
+    events_by_key.clear();
+    wheel_time = executed_ticks;
+    for (const Event& event : events) {
+        InsertEvent(event);
+    }
+}
+
 u64 Timing::Timer::GetTicks() const {
     u64 ticks = static_cast<u64>(executed_ticks);
     if (!is_timer_sane) {
@@ -169,16 +373,16 @@ void Timing::Timer::ForceExceptionCheck(s64 cycles) {
 void Timing::Timer::MoveEvents() {
     for (Event ev; ts_queue.Pop(ev);) {
         ev.fifo_order = event_fifo_id++;
-        event_queue.emplace_back(std::move(ev));
-        std::push_heap(event_queue.begin(), event_queue.end(), std::greater<>());
+        InsertEvent(ev);
     }
 }
 
 s64 Timing::Timer::GetMaxSliceLength() const {
-    const auto& next_event = event_queue.begin();
-    if (next_event != event_queue.end()) {
-        ASSERT(next_event->time - executed_ticks > 0);
-        return next_event->time - executed_ticks;
+    const u32 next_event = FindNextEvent();
+    if (next_event != INVALID_NODE) {
+        const s64 next_time = nodes[next_event].event.time;
+        ASSERT(next_time - executed_ticks > 0);
+        return next_time - executed_ticks;
     }
     return MAX_SLICE_LENGTH;
 }
@@ -194,16 +398,18 @@ void Timing::Timer::Advance() {
 
     is_timer_sane = true;
 
-    while (!event_queue.empty() && event_queue.front().time <= executed_ticks) {
-        Event evt = std::move(event_queue.front());
-        std::pop_heap(event_queue.begin(), event_queue.end(), std::greater<>());
-        event_queue.pop_back();
+    for (u32 index = FindNextEvent();
+         index != INVALID_NODE && nodes[index].event.time <= executed_ticks;
+         index = FindNextEvent()) {
+        const Event evt = nodes[index].event;
+        RemoveNode(index);
         if (evt.type->callback != nullptr) {
             evt.type->callback(evt.userdata, static_cast<int>(executed_ticks - evt.time));
         } else {
             LOG_ERROR(Core, "Event '{}' has no callback", *evt.type->name);
         }
     }
+    AdvanceWheel(executed_ticks);
 
     is_timer_sane = false;
 }
@@ -212,9 +418,10 @@ void Timing::Timer::SetNextSlice(s64 max_slice_length) {
     slice_length = max_slice_length;
 
     // Still events left (scheduled in the future)
-    if (!event_queue.empty()) {
+    const u32 next_event = FindNextEvent();
+    if (next_event != INVALID_NODE) {
         slice_length = static_cast<int>(
-            std::min<s64>(event_queue.front().time - executed_ticks, max_slice_length));
+            std::min<s64>(nodes[next_event].event.time - executed_ticks, max_slice_length));
     }
 
     downcount = slice_length;
@@ -17,11 +17,13 @@
  *   ScheduleEvent(periodInCycles - cyclesLate, callback, "whatever")
  */
 
+#include <array>
 #include <chrono>
 #include <functional>
 #include <limits>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <boost/serialization/split_member.hpp>
 #include <boost/serialization/vector.hpp>
@@ -179,6 +181,26 @@ public:
     // scheduled and repated.
     static constexpr int MAX_SLICE_LENGTH = BASE_CLOCK_RATE_ARM11 / 234;
 
+    class Timer;
+
+    /**
+     * Refers to a single scheduled event. It can be used to unschedule that event in constant
+     * time. Handles become stale once the event fires or is removed, in which case unscheduling
+     * through them does nothing. Handles are not preserved across save states.
+     */
+    class EventHandle {
+    public:
+        bool IsValid() const {
+            return timer != nullptr;
+        }
+
+    private:
+        friend class Timing;
+        Timer* timer = nullptr;
+        u32 index = 0;
+        u32 generation = 0;
+    };
+
     class Timer {
     public:
         Timer();
@@ -205,14 +227,63 @@ public:
 
     private:
         friend class Timing;
-        // The queue is a min-heap using std::make_heap/push_heap/pop_heap.
-        // We don't use std::priority_queue because we need to be able to serialize, unserialize and
-        // erase arbitrary events (RemoveEvent()) regardless of the queue order. These aren't
-        // accommodated by the standard adaptor class.
-        std::vector<Event> event_queue;
+
+        static constexpr u32 INVALID_NODE = std::numeric_limits<u32>::max();
+        // The innermost wheel level has slots of 2^WHEEL_GRANULARITY_BITS cycles. Each further
+        // level covers a whole revolution of the previous one with every slot, so the wheel spans
+        // 2^(WHEEL_GRANULARITY_BITS + WHEEL_LEVEL_BITS * WHEEL_LEVELS) cycles (about a minute).
+        static constexpr std::size_t WHEEL_GRANULARITY_BITS = 10;
+        static constexpr std::size_t WHEEL_LEVEL_BITS = 6;
+        static constexpr std::size_t WHEEL_SLOTS = std::size_t{1} << WHEEL_LEVEL_BITS;
+        static constexpr std::size_t WHEEL_LEVELS = 4;
+        // Events further in the future than the wheel span are kept in an unordered list that is
+        // only revisited when the outermost level wraps around.
+        static constexpr u32 OVERFLOW_BUCKET = WHEEL_LEVELS * WHEEL_SLOTS;
+        static constexpr u32 FREE_BUCKET = OVERFLOW_BUCKET + 1;
+
+        using EventKey = std::pair<const TimingEventType*, u64>;
+        struct EventKeyHash {
+            std::size_t operator()(const EventKey& key) const {
+                return std::hash<const TimingEventType*>{}(key.first) ^
+                       std::hash<u64>{}(key.second) * 0x9E3779B97F4A7C15ULL;
+            }
+        };
+
+        struct Node {
+            Event event;
+            u32 prev = INVALID_NODE;
+            u32 next = INVALID_NODE;
+            // Links to the other events with the same type and userdata, used by UnscheduleEvent
+            u32 key_prev = INVALID_NODE;
+            u32 key_next = INVALID_NODE;
+            u32 generation = 0;
+            u32 bucket = FREE_BUCKET;
+        };
+
+        u32 InsertEvent(const Event& event);
+        void RemoveNode(u32 index);
+        void LinkBucket(u32 index);
+        void UnlinkBucket(u32 index);
+        u32 FindNextEvent() const;
+        void AdvanceWheel(s64 new_time);
+        std::vector<Event> GetSortedEvents() const;
+        void ResetEvents(const std::vector<Event>& events);
+
+        // The event queue is a hierarchical timing wheel. Events are stored in a node pool and
+        // chained into doubly linked bucket lists, which makes scheduling and cancelling by handle
+        // constant time. Buckets are relative to wheel_time: an event is placed on the innermost
+        // level whose slots still distinguish its time from wheel_time, so every event on a level
+        // is due before any event on the levels above it. The bucket of the current time is
+        // redistributed to the lower levels whenever wheel_time moves into it.
+        std::vector<Node> nodes;
+        u32 free_node = INVALID_NODE;
+        std::array<u32, WHEEL_LEVELS * WHEEL_SLOTS + 1> buckets;
+        std::array<u64, WHEEL_LEVELS> occupied_slots{};
+        std::unordered_map<EventKey, u32, EventKeyHash> events_by_key;
+        s64 wheel_time = 0;
         u64 event_fifo_id = 0;
         // the queue for storing the events from other threads threadsafe until they will be added
-        // to the event_queue by the emu thread
+        // to the timing wheel by the emu thread
         Common::MPSCQueue<Event> ts_queue;
         // Are we in a function that has been called from Advance()
         // If events are sheduled from a function that gets called from Advance(),
@@ -238,12 +309,21 @@ public:
             // TODO(SaveState): Remove the next two lines when we break compatibility
             s64 x;
             ar& x; // to keep compatibility with old save states that stored global_timer
+            // The events are stored sorted, which is also a valid min-heap, to stay compatible
+            // with save states from when the event queue was a binary heap.
+            std::vector<Event> event_queue;
+            if (!Archive::is_loading::value) {
+                event_queue = GetSortedEvents();
+            }
             ar& event_queue;
             ar& event_fifo_id;
             ar& slice_length;
             ar& downcount;
             ar& executed_ticks;
             ar& idled_cycles;
+            if (Archive::is_loading::value) {
+                ResetEvents(event_queue);
+            }
         }
         friend class boost::serialization::access;
     };
@@ -257,11 +337,20 @@ public:
      */
     TimingEventType* RegisterEvent(const std::string& name, TimedCallback callback);
 
-    void ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type, u64 userdata = 0,
-                       std::size_t core_id = std::numeric_limits<std::size_t>::max());
+    /**
+     * Schedules an event. The returned handle can be used to unschedule it again. It is only
+     * valid when the event is scheduled on the current timer; events for other cores are passed
+     * through a thread-safe queue and can only be unscheduled by type.
+     */
+    EventHandle ScheduleEvent(s64 cycles_into_future, const TimingEventType* event_type,
+                              u64 userdata = 0,
+                              std::size_t core_id = std::numeric_limits<std::size_t>::max());
 
     void UnscheduleEvent(const TimingEventType* event_type, u64 userdata);
 
+    /// Unschedules the event referred to by the handle, if it is still pending.
+    void UnscheduleEvent(const EventHandle& handle);
+
     /// We only permit one event of each type in the queue at a time.
     void RemoveEvent(const TimingEventType* event_type);
 
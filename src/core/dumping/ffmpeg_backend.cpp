@@ -301,7 +301,7 @@ bool FFmpegAudioStream::Init(FFmpegMuxer& muxer) {
     auto* context =
         swr_alloc_set_opts(nullptr, codec_context->channel_layout, codec_context->sample_fmt,
                            codec_context->sample_rate, codec_context->channel_layout,
-                           AV_SAMPLE_FMT_S16P, AudioCore::native_sample_rate, 0, nullptr);
+                           AV_SAMPLE_FMT_S16, AudioCore::native_sample_rate, 0, nullptr);
     if (!context) {
         LOG_ERROR(Render, "Could not create SWR context");
         return false;
@@ -336,14 +336,9 @@ void FFmpegAudioStream::Free() {
     av_freep(&resampled_data);
 }
 
-void FFmpegAudioStream::ProcessFrame(const VariableAudioFrame& channel0,
-                                     const VariableAudioFrame& channel1) {
-    ASSERT_MSG(channel0.size() == channel1.size(),
-               "Frames of the two channels must have the same number of samples");
-
+void FFmpegAudioStream::ProcessFrame(const s16* samples, std::size_t sample_count) {
     const auto sample_size = av_get_bytes_per_sample(codec_context->sample_fmt);
-    std::array<const u8*, 2> src_data = {reinterpret_cast<const u8*>(channel0.data()),
-                                         reinterpret_cast<const u8*>(channel1.data())};
+    std::array<const u8*, 1> src_data = {reinterpret_cast<const u8*>(samples)};
 
     std::array<u8*, 2> dst_data;
     if (av_sample_fmt_is_planar(codec_context->sample_fmt)) {
@@ -354,7 +349,7 @@ void FFmpegAudioStream::ProcessFrame(const VariableAudioFrame& channel0,
     }
 
     auto resampled_count = swr_convert(swr_context.get(), dst_data.data(), frame_size - offset,
-                                       src_data.data(), static_cast<int>(channel0.size()));
+                                       src_data.data(), static_cast<int>(sample_count));
     if (resampled_count < 0) {
         LOG_ERROR(Render, "Audio frame dropped: Could not resample data");
         return;
@@ -467,9 +462,8 @@ void FFmpegMuxer::ProcessVideoFrame(VideoFrame& frame) {
     video_stream.ProcessFrame(frame);
 }
 
-void FFmpegMuxer::ProcessAudioFrame(const VariableAudioFrame& channel0,
-                                    const VariableAudioFrame& channel1) {
-    audio_stream.ProcessFrame(channel0, channel1);
+void FFmpegMuxer::ProcessAudioFrame(const s16* samples, std::size_t sample_count) {
+    audio_stream.ProcessFrame(samples, sample_count);
 }
 
 void FFmpegMuxer::FlushVideo() {
@@ -535,17 +529,21 @@ bool FFmpegBackend::StartDumping(const std::string& path, const Layout::Framebuf
 
     if (audio_processing_thread.joinable())
         audio_processing_thread.join();
+    audio_ended = false;
     audio_processing_thread = std::thread([&] {
-        VariableAudioFrame channel0, channel1;
         while (true) {
-            channel0 = audio_frame_queues[0].PopWait();
-            channel1 = audio_frame_queues[1].PopWait();
-            if (channel0.empty()) {
-                // An empty frame marks the end of frame data
+            // Read the flag first so samples pushed before StopDumping are always encoded
+            const bool ended = audio_ended;
+            const std::size_t count = audio_buffer.Pop(audio_block.data(), AUDIO_BLOCK_SIZE);
+            if (count != 0) {
+                ffmpeg.ProcessAudioFrame(audio_block.data(), count);
+                continue;
+            }
+            if (ended) {
                 ffmpeg.FlushAudio();
                 break;
             }
-            ffmpeg.ProcessAudioFrame(channel0, channel1);
+            audio_available.Wait();
         }
     });
 
@@ -562,22 +560,33 @@ void FFmpegBackend::AddVideoFrame(VideoFrame frame) {
 }
 
 void FFmpegBackend::AddAudioFrame(AudioCore::StereoFrame16 frame) {
-    std::array<VariableAudioFrame, 2> refactored_frame;
-    for (auto& channel : refactored_frame) {
-        channel.resize(frame.size());
-    }
-    for (std::size_t i = 0; i < frame.size(); i++) {
-        refactored_frame[0][i] = frame[i][0];
-        refactored_frame[1][i] = frame[i][1];
-    }
-
-    audio_frame_queues[0].Push(std::move(refactored_frame[0]));
-    audio_frame_queues[1].Push(std::move(refactored_frame[1]));
+    PushAudioSamples(frame[0].data(), frame.size());
 }
 
 void FFmpegBackend::AddAudioSample(const std::array<s16, 2>& sample) {
-    audio_frame_queues[0].Push(VariableAudioFrame{sample[0]});
-    audio_frame_queues[1].Push(VariableAudioFrame{sample[1]});
+    PushAudioSamples(sample.data(), 1);
+}
+
+void FFmpegBackend::PushAudioSamples(const s16* samples, std::size_t sample_count) {
+    while (true) {
+        const std::size_t filled = audio_buffer.Size();
+        const std::size_t pushed = audio_buffer.Push(samples, sample_count);
+        samples += pushed * 2;
+        sample_count -= pushed;
+
+        // Wake the audio thread once per block instead of on every push
+        if (filled < AUDIO_BLOCK_SIZE && filled + pushed >= AUDIO_BLOCK_SIZE) {
+            audio_available.Set();
+        }
+        if (sample_count == 0) {
+            return;
+        }
+
+        // The encoder has fallen behind by the whole buffer, wait for it rather than dropping
+        // audio from the dump
+        audio_available.Set();
+        std::this_thread::yield();
+    }
 }
 
 void FFmpegBackend::StopDumping() {
@@ -586,10 +595,9 @@ void FFmpegBackend::StopDumping() {
 
     // Flush the video processing queue
     AddVideoFrame(VideoFrame());
-    for (auto i : {0, 1}) {
-        // Flush the audio processing queue
-        audio_frame_queues[i].Push(VariableAudioFrame());
-    }
+    // Flush the audio processing buffer
+    audio_ended = true;
+    audio_available.Set();
     // Wait until processing ends
     processing_ended.Wait();
 }
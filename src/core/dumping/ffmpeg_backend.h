@@ -13,8 +13,8 @@
 #include <thread>
 #include <vector>
 #include "common/common_types.h"
+#include "common/ring_buffer.h"
 #include "common/thread.h"
-#include "common/threadsafe_queue.h"
 #include "core/dumping/backend.h"
 
 extern "C" {
@@ -27,8 +27,6 @@ extern "C" {
 
 namespace VideoDumper {
 
-using VariableAudioFrame = std::vector<s16>;
-
 void InitFFmpegLibraries();
 
 class FFmpegMuxer;
@@ -108,7 +106,8 @@ public:
 
     bool Init(FFmpegMuxer& muxer);
     void Free();
-    void ProcessFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
+    /// Resamples and encodes interleaved stereo samples
+    void ProcessFrame(const s16* samples, std::size_t sample_count);
     void Flush();
 
 private:
@@ -139,7 +138,7 @@ public:
     bool Init(const std::string& path, const Layout::FramebufferLayout& layout);
     void Free();
     void ProcessVideoFrame(VideoFrame& frame);
-    void ProcessAudioFrame(const VariableAudioFrame& channel0, const VariableAudioFrame& channel1);
+    void ProcessAudioFrame(const s16* samples, std::size_t sample_count);
     void FlushVideo();
     void FlushAudio();
     void WriteTrailer();
@@ -177,7 +176,13 @@ public:
     Layout::FramebufferLayout GetLayout() const override;
 
 private:
+    /// Number of stereo samples the audio buffer can hold, about two seconds of audio
+    static constexpr std::size_t AUDIO_BUFFER_CAPACITY = 1 << 16;
+    /// Number of stereo samples the audio thread encodes at once
+    static constexpr std::size_t AUDIO_BLOCK_SIZE = 1024;
+
     void EndDumping();
+    void PushAudioSamples(const s16* samples, std::size_t sample_count);
 
     std::atomic_bool is_dumping = false; ///< Whether the backend is currently dumping
 
@@ -189,7 +194,10 @@ private:
     Common::Event event1, event2;
     std::thread video_processing_thread;
 
-    std::array<Common::SPSCQueue<VariableAudioFrame>, 2> audio_frame_queues;
+    Common::RingBuffer<s16, AUDIO_BUFFER_CAPACITY, 2> audio_buffer;
+    std::array<s16, AUDIO_BLOCK_SIZE * 2> audio_block;
+    Common::Event audio_available;
+    std::atomic_bool audio_ended = false;
     std::thread audio_processing_thread;
 
     Common::Event processing_ended;
@@ -32,6 +32,21 @@ struct LayeredFS::File {
     Directory* parent;
 };
 
+// Number of replacement files kept open at once
+constexpr std::size_t MaxReplacementHandles = 16;
+// Size of the read-ahead buffer for replacement files that could not be memory mapped
+constexpr std::size_t ReplacementReadAheadSize = 0x40000;
+
+struct LayeredFS::ReplacementHandle {
+    const File* file;
+    FileUtil::IOFile io;
+    FileUtil::MappedFile mapping;
+    std::vector<u8> read_ahead;
+    u64 read_ahead_offset{};
+    u64 next_offset{}; // End of the previous read, used to detect sequential access
+    u64 last_use{};
+};
+
 struct DirectoryMetadata {
     u32_le parent_directory_offset;
     u32_le next_sibling_offset;
@@ -522,14 +537,7 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
             romfs->ReadFile(relocation.original_offset + relative_offset, to_read,
                             buffer + read_size);
         } else if (relocation.type == 1) { // replace
-            FileUtil::IOFile replace_file(relocation.replace_file_path, "rb");
-            if (replace_file) {
-                replace_file.Seek(relative_offset, SEEK_SET);
-                replace_file.ReadBytes(buffer + read_size, to_read);
-            } else {
-                LOG_ERROR(Service_FS, "Could not open replacement file for {}",
-                          current->second->path);
-            }
+            ReadReplacement(*current->second, relative_offset, to_read, buffer + read_size);
         } else if (relocation.type == 2) { // patch
             std::memcpy(buffer + read_size, relocation.patched_file.data() + relative_offset,
                         to_read);
@@ -547,6 +555,82 @@ std::size_t LayeredFS::ReadFile(std::size_t offset, std::size_t length, u8* buff
     return read_size;
 }
 
+LayeredFS::ReplacementHandle* LayeredFS::GetReplacementHandle(const File& file) {
+    ++replacement_tick;
+
+    const auto it = std::find_if(replacement_handles.begin(), replacement_handles.end(),
+                                 [&file](const auto& handle) { return handle->file == &file; });
+    if (it != replacement_handles.end()) {
+        (*it)->last_use = replacement_tick;
+        return it->get();
+    }
+
+    FileUtil::IOFile io(file.relocation.replace_file_path, "rb");
+    if (!io) {
+        return nullptr;
+    }
+
+    auto handle = std::make_unique<ReplacementHandle>();
+    handle->file = &file;
+    handle->mapping = FileUtil::MappedFile(io);
+    handle->io = std::move(io);
+    handle->last_use = replacement_tick;
+
+    if (replacement_handles.size() < MaxReplacementHandles) {
+        return replacement_handles.emplace_back(std::move(handle)).get();
+    }
+
+    auto& lru = *std::min_element(
+        replacement_handles.begin(), replacement_handles.end(),
+        [](const auto& a, const auto& b) { return a->last_use < b->last_use; });
+    lru = std::move(handle);
+    return lru.get();
+}
+
+void LayeredFS::ReadReplacement(const File& file, u64 offset, std::size_t length, u8* buffer) {
+    if (length == 0) {
+        return;
+    }
+
+    std::scoped_lock lock{replacement_mutex};
+
+    auto* handle = GetReplacementHandle(file);
+    if (!handle) {
+        LOG_ERROR(Service_FS, "Could not open replacement file for {}", file.path);
+        return;
+    }
+
+    if (handle->mapping.IsMapped() && offset + length <= handle->mapping.Size()) {
+        std::memcpy(buffer, handle->mapping.Data() + offset, length);
+        return;
+    }
+
+    const bool sequential = offset == handle->next_offset;
+    handle->next_offset = offset + length;
+
+    if (offset >= handle->read_ahead_offset &&
+        offset + length <= handle->read_ahead_offset + handle->read_ahead.size()) {
+        std::memcpy(buffer, handle->read_ahead.data() + (offset - handle->read_ahead_offset),
+                    length);
+        return;
+    }
+
+    // Random or large reads go straight to the file, small sequential reads (the common case for
+    // streamed assets) refill the read-ahead buffer.
+    handle->io.Seek(offset, SEEK_SET);
+    if (!sequential || length >= ReplacementReadAheadSize) {
+        handle->io.ReadBytes(buffer, length);
+        return;
+    }
+
+    handle->read_ahead.resize(ReplacementReadAheadSize);
+    const std::size_t read =
+        handle->io.ReadBytes(handle->read_ahead.data(), handle->read_ahead.size());
+    handle->read_ahead.resize(read);
+    handle->read_ahead_offset = offset;
+    std::memcpy(buffer, handle->read_ahead.data(), std::min(length, read));
+}
+
 bool LayeredFS::ExtractDirectory(Directory& current, const std::string& target_path) {
     if (!FileUtil::CreateFullPath(target_path + current.path)) {
         LOG_ERROR(Service_FS, "Could not create path {}", target_path + current.path);
@@ -6,6 +6,7 @@
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -55,6 +56,7 @@ public:
 
 private:
     struct File;
+    struct ReplacementHandle;
     struct Directory {
         std::string name;
         std::string path; // with trailing '/'
@@ -100,6 +102,12 @@ private:
 
     void Load();
 
+    // Returns an open handle for a replaced file, reusing one from the cache when possible.
+    ReplacementHandle* GetReplacementHandle(const File& file);
+
+    // Reads from a replaced file through the handle cache.
+    void ReadReplacement(const File& file, u64 offset, std::size_t length, u8* buffer);
+
     std::shared_ptr<RomFSReader> romfs;
     std::string patch_path;
     std::string patch_ext_path;
@@ -128,6 +136,11 @@ private:
     std::vector<u8> file_metadata_table; // rebuilt file metadata table
     u64 current_data_offset{};           // current assigned data offset
 
+    // Open handles for replaced files, evicted least recently used first.
+    std::mutex replacement_mutex;
+    std::vector<std::unique_ptr<ReplacementHandle>> replacement_handles;
+    u64 replacement_tick{};
+
     LayeredFS();
 
     template <class Archive>
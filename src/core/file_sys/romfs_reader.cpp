@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <cstring>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include "common/archives.h"
@@ -8,18 +9,134 @@ SERIALIZE_EXPORT_IMPL(FileSys::DirectRomFSReader)
 
 namespace FileSys {
 
+// Crypto++ picks the AES-NI / ARMv8 AES implementation at runtime when the host supports it, so
+// keeping one keyed cipher around and seeking it is all that is needed to stay on the fast path.
+struct DirectRomFSReader::Decryptor {
+    CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption cipher;
+};
+
+DirectRomFSReader::DirectRomFSReader() = default;
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size)
+    : is_encrypted(false), file(std::move(file)), file_offset(file_offset), data_size(data_size) {}
+
+DirectRomFSReader::DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset,
+                                     std::size_t data_size, const std::array<u8, 16>& key,
+                                     const std::array<u8, 16>& ctr, std::size_t crypto_offset)
+    : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
+      crypto_offset(crypto_offset), data_size(data_size) {}
+
+DirectRomFSReader::~DirectRomFSReader() = default;
+
 std::size_t DirectRomFSReader::ReadFile(std::size_t offset, std::size_t length, u8* buffer) {
-    if (length == 0)
+    if (length == 0 || offset >= data_size)
         return 0; // Crypto++ does not like zero size buffer
+
+    std::scoped_lock lock{mutex};
+    const std::size_t read_length =
+        std::min(length, static_cast<std::size_t>(data_size) - offset);
+
+    if (!is_encrypted) {
+        return ReadRaw(offset, read_length, buffer);
+    }
+
+    // Large reads would only flush the cache, decrypt them straight into the destination.
+    if (read_length >= CACHE_BLOCK_SIZE) {
+        if (const u8* mapped = GetMappedData(offset, read_length)) {
+            Decrypt(offset, mapped, buffer, read_length);
+            return read_length;
+        }
+        const std::size_t raw_length = ReadRaw(offset, read_length, buffer);
+        Decrypt(offset, buffer, buffer, raw_length);
+        return raw_length;
+    }
+
+    std::size_t copied = 0;
+    while (copied < read_length) {
+        const u64 position = offset + copied;
+        const std::size_t block_offset = static_cast<std::size_t>(position % CACHE_BLOCK_SIZE);
+        const CachedBlock& block = GetCachedBlock(position / CACHE_BLOCK_SIZE);
+        if (block_offset >= block.size) {
+            break;
+        }
+        const std::size_t copy_length = std::min(read_length - copied, block.size - block_offset);
+        std::memcpy(buffer + copied, block.data.data() + block_offset, copy_length);
+        copied += copy_length;
+    }
+    return copied;
+}
+
+std::size_t DirectRomFSReader::ReadRaw(std::size_t offset, std::size_t length, u8* buffer) {
+    if (const u8* mapped = GetMappedData(offset, length)) {
+        std::memcpy(buffer, mapped, length);
+        return length;
+    }
     file.Seek(file_offset + offset, SEEK_SET);
-    std::size_t read_length = std::min(length, static_cast<std::size_t>(data_size) - offset);
-    read_length = file.ReadBytes(buffer, read_length);
-    if (is_encrypted) {
-        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
-        d.Seek(crypto_offset + offset);
-        d.ProcessData(buffer, buffer, read_length);
-    }
-    return read_length;
+    return file.ReadBytes(buffer, length);
+}
+
+const u8* DirectRomFSReader::GetMappedData(std::size_t offset, std::size_t length) {
+    if (!mapping_attempted) {
+        mapping_attempted = true;
+        mapping = FileUtil::MappedFile(file);
+    }
+    if (!mapping.IsMapped() || file_offset + offset + length > mapping.Size()) {
+        return nullptr;
+    }
+    return mapping.Data() + file_offset + offset;
+}
+
+void DirectRomFSReader::Decrypt(std::size_t offset, const u8* in, u8* out, std::size_t length) {
+    if (length == 0) {
+        return;
+    }
+    if (!decryptor) {
+        decryptor = std::make_unique<Decryptor>();
+        decryptor->cipher.SetKeyWithIV(key.data(), key.size(), ctr.data());
+    }
+    decryptor->cipher.Seek(crypto_offset + offset);
+    decryptor->cipher.ProcessData(out, in, length);
+}
+
+const DirectRomFSReader::CachedBlock& DirectRomFSReader::GetCachedBlock(u64 block_index) {
+    ++cache_tick;
+
+    auto it = std::find_if(cache.begin(), cache.end(),
+                           [block_index](const CachedBlock& block) {
+                               return block.index == block_index;
+                           });
+    if (it != cache.end()) {
+        it->last_use = cache_tick;
+        return *it;
+    }
+
+    CachedBlock* block;
+    if (cache.size() < CACHE_BLOCK_COUNT) {
+        block = &cache.emplace_back();
+        block->data.resize(CACHE_BLOCK_SIZE);
+    } else {
+        block = &*std::min_element(cache.begin(), cache.end(),
+                                   [](const CachedBlock& a, const CachedBlock& b) {
+                                       return a.last_use < b.last_use;
+                                   });
+    }
+
+    const u64 block_start = block_index * CACHE_BLOCK_SIZE;
+    const std::size_t block_length =
+        static_cast<std::size_t>(std::min<u64>(CACHE_BLOCK_SIZE, data_size - block_start));
+
+    block->index = block_index;
+    block->last_use = cache_tick;
+    block->size = ReadRaw(block_start, block_length, block->data.data());
+    Decrypt(block_start, block->data.data(), block->data.data(), block->size);
+
+    // Never keep a short read around, the next access should retry it.
+    if (block->size != block_length) {
+        block->index = ~u64{0};
+        block->last_use = 0;
+    }
+    return *block;
 }
 
 } // namespace FileSys
@@ -1,6 +1,9 @@
 #pragma once
 
 #include <array>
+#include <memory>
+#include <mutex>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/export.hpp>
@@ -27,20 +30,20 @@ private:
 
 /**
  * A RomFS reader that directly reads the RomFS file.
+ *
+ * The file is memory mapped when possible so reads avoid a seek and an extra copy. Encrypted
+ * reads go through a small LRU cache of decrypted blocks, which absorbs the many small metadata
+ * and file reads games tend to issue against the same region.
  */
 class DirectRomFSReader : public RomFSReader {
 public:
-    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size)
-        : is_encrypted(false), file(std::move(file)), file_offset(file_offset),
-          data_size(data_size) {}
+    DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size);
 
     DirectRomFSReader(FileUtil::IOFile&& file, std::size_t file_offset, std::size_t data_size,
                       const std::array<u8, 16>& key, const std::array<u8, 16>& ctr,
-                      std::size_t crypto_offset)
-        : is_encrypted(true), file(std::move(file)), key(key), ctr(ctr), file_offset(file_offset),
-          crypto_offset(crypto_offset), data_size(data_size) {}
+                      std::size_t crypto_offset);
 
-    ~DirectRomFSReader() override = default;
+    ~DirectRomFSReader() override;
 
     std::size_t GetSize() const override {
         return data_size;
@@ -49,6 +52,28 @@ public:
     std::size_t ReadFile(std::size_t offset, std::size_t length, u8* buffer) override;
 
 private:
+    static constexpr std::size_t CACHE_BLOCK_SIZE = 0x10000;
+    static constexpr std::size_t CACHE_BLOCK_COUNT = 16;
+
+    struct Decryptor;
+
+    struct CachedBlock {
+        u64 index = 0;
+        u64 last_use = 0;
+        std::size_t size = 0;
+        std::vector<u8> data;
+    };
+
+    /// Reads raw (possibly encrypted) RomFS data, from the mapping if there is one.
+    std::size_t ReadRaw(std::size_t offset, std::size_t length, u8* buffer);
+
+    /// Returns a pointer to the raw data if the requested range is memory mapped.
+    const u8* GetMappedData(std::size_t offset, std::size_t length);
+
+    void Decrypt(std::size_t offset, const u8* in, u8* out, std::size_t length);
+
+    const CachedBlock& GetCachedBlock(u64 block_index);
+
     bool is_encrypted;
     FileUtil::IOFile file;
     std::array<u8, 16> key;
@@ -57,7 +82,15 @@ private:
     u64 crypto_offset;
     u64 data_size;
 
-    DirectRomFSReader() = default;
+    // Runtime state, rebuilt lazily after deserialization.
+    std::mutex mutex;
+    FileUtil::MappedFile mapping;
+    bool mapping_attempted = false;
+    std::unique_ptr<Decryptor> decryptor;
+    std::vector<CachedBlock> cache;
+    u64 cache_tick = 0;
+
+    DirectRomFSReader();
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -69,6 +102,13 @@ private:
         ar& file_offset;
         ar& crypto_offset;
         ar& data_size;
+        if (Archive::is_loading::value) {
+            std::scoped_lock lock{mutex};
+            mapping.Unmap();
+            mapping_attempted = false;
+            decryptor.reset();
+            cache.clear();
+        }
     }
     friend class boost::serialization::access;
 };
@@ -176,11 +176,12 @@ ResultCode HLERequestContext::PopulateFromIncomingCommandBuffer(
             VAddr source_address = src_cmdbuf[i];
             IPC::StaticBufferDescInfo buffer_info{descriptor};
 
-            // Copy the input buffer into our own vector and store it.
-            std::vector<u8> data(buffer_info.size);
+            // Copy the input buffer into our own vector, reusing its storage from previous requests
+            // when the context is recycled.
+            std::vector<u8>& data = static_buffers[buffer_info.buffer_id];
+            data.resize(buffer_info.size);
             kernel.memory.ReadBlock(src_process, source_address, data.data(), data.size());
 
-            AddStaticBuffer(buffer_info.buffer_id, std::move(data));
             cmd_buf[i++] = source_address;
             break;
         }
@@ -288,6 +289,18 @@ MappedBuffer& HLERequestContext::GetMappedBuffer(u32 id_from_cmdbuf) {
     return request_mapped_buffers[id_from_cmdbuf];
 }
 
+void HLERequestContext::Reset(std::shared_ptr<ServerSession> session_,
+                              std::shared_ptr<Thread> thread_) {
+    session = std::move(session_);
+    thread = std::move(thread_);
+    cmd_buf[0] = 0;
+    request_handles.clear();
+    request_mapped_buffers.clear();
+    for (auto& buffer : static_buffers) {
+        buffer.clear();
+    }
+}
+
 void HLERequestContext::ReportUnimplemented() const {
     if (kernel.GetIPCRecorder().IsEnabled()) {
         kernel.GetIPCRecorder().SetHLEUnimplemented(thread);
@@ -316,6 +329,28 @@ void MappedBuffer::Write(const void* src_buffer, std::size_t offset, std::size_t
     memory->WriteBlock(*process, address + static_cast<VAddr>(offset), src_buffer, size);
 }
 
+std::span<const u8> MappedBuffer::GetReadSpan(std::size_t offset, std::size_t size) const {
+    ASSERT(perms & IPC::R);
+    ASSERT(offset + size <= this->size);
+    const u8* pointer = memory->GetContiguousBlockPointer(
+        *process, address + static_cast<VAddr>(offset), size);
+    if (pointer == nullptr) {
+        return {};
+    }
+    return {pointer, size};
+}
+
+std::span<u8> MappedBuffer::GetWriteSpan(std::size_t offset, std::size_t size) {
+    ASSERT(perms & IPC::W);
+    ASSERT(offset + size <= this->size);
+    u8* pointer = memory->GetContiguousBlockPointer(
+        *process, address + static_cast<VAddr>(offset), size);
+    if (pointer == nullptr) {
+        return {};
+    }
+    return {pointer, size};
+}
+
 } // namespace Kernel
 
 SERIALIZE_EXPORT_IMPL(Kernel::HLERequestContext::ThreadCallback)
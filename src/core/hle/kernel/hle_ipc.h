@@ -8,6 +8,7 @@
 #include <array>
 #include <chrono>
 #include <memory>
+#include <span>
 #include <string>
 #include <vector>
 #include <boost/container/small_vector.hpp>
@@ -132,6 +133,15 @@ public:
     // interface for service
     void Read(void* dest_buffer, std::size_t offset, std::size_t size);
     void Write(const void* src_buffer, std::size_t offset, std::size_t size);
+
+    /**
+     * Borrows a view of the range [offset, offset + size) of the buffer directly in guest memory.
+     * This is only possible if the range is contiguous in host memory and not cached by the
+     * rasterizer, otherwise an empty span is returned and Read/Write must be used instead.
+     * The view is only valid while the request is being handled.
+     */
+    std::span<const u8> GetReadSpan(std::size_t offset, std::size_t size) const;
+    std::span<u8> GetWriteSpan(std::size_t offset, std::size_t size);
     std::size_t GetSize() const {
         return size;
     }
@@ -288,6 +298,13 @@ public:
     /// Reports an unimplemented function.
     void ReportUnimplemented() const;
 
+    /**
+     * Clears the context so that it can be reused for another request, releasing all objects and
+     * buffers of the previous one. The capacity of the static buffers is kept so that subsequent
+     * requests don't have to allocate them again.
+     */
+    void Reset(std::shared_ptr<ServerSession> session, std::shared_ptr<Thread> thread);
+
     class ThreadCallback;
     friend class ThreadCallback;
 
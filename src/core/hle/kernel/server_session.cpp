@@ -90,8 +90,13 @@ ResultCode ServerSession::HandleSyncRequest(std::shared_ptr<Thread> thread) {
         kernel.memory.ReadBlock(*current_process, thread->GetCommandBufferAddress(), cmd_buf.data(),
                                 cmd_buf.size() * sizeof(u32));
 
-        auto context =
-            std::make_shared<Kernel::HLERequestContext>(kernel, SharedFrom(this), thread);
+        std::shared_ptr<Kernel::HLERequestContext> context;
+        if (cached_hle_context) {
+            context = std::move(cached_hle_context);
+            context->Reset(SharedFrom(this), thread);
+        } else {
+            context = std::make_shared<Kernel::HLERequestContext>(kernel, SharedFrom(this), thread);
+        }
         context->PopulateFromIncomingCommandBuffer(cmd_buf.data(), current_process);
 
         hle_handler->HandleSyncRequest(*context);
@@ -106,6 +111,13 @@ ResultCode ServerSession::HandleSyncRequest(std::shared_ptr<Thread> thread) {
             kernel.memory.WriteBlock(*current_process, thread->GetCommandBufferAddress(),
                                      cmd_buf.data(), cmd_buf.size() * sizeof(u32));
         }
+
+        // If the handler didn't keep the context around (e.g. for a deferred response), recycle
+        // it. It must not hold on to this session, otherwise neither would ever be freed.
+        if (context.use_count() == 1) {
+            context->Reset(nullptr, nullptr);
+            cached_hle_context = std::move(context);
+        }
     }
 
     if (thread->status == ThreadStatus::Running) {
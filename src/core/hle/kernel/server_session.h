@@ -20,6 +20,7 @@ namespace Kernel {
 
 class ClientSession;
 class ClientPort;
+class HLERequestContext;
 class ServerSession;
 class Session;
 class SessionRequestHandler;
@@ -106,6 +107,10 @@ private:
     friend class KernelSystem;
     KernelSystem& kernel;
 
+    /// Context of the last HLE request, kept for reuse when no one else holds on to it. This is
+    /// ephemeral and therefore not serialized.
+    std::shared_ptr<HLERequestContext> cached_hle_context;
+
     friend class boost::serialization::access;
     template <class Archive>
     void serialize(Archive& ar, const unsigned int file_version);
@@ -3,9 +3,11 @@
 // Refer to the license.txt file included.
 
 #include <algorithm>
+#include <atomic>
 #include <cinttypes>
 #include <cstddef>
 #include <cstring>
+#include <thread>
 #include <cryptopp/aes.h>
 #include <cryptopp/modes.h>
 #include <fmt/format.h>
@@ -13,6 +15,7 @@
 #include "common/file_util.h"
 #include "common/logging/log.h"
 #include "common/string_util.h"
+#include "common/threadsafe_queue.h"
 #include "core/core.h"
 #include "core/file_sys/errors.h"
 #include "core/file_sys/ncch_container.h"
@@ -80,6 +83,7 @@ static_assert(sizeof(TicketInfo) == 0x18, "Ticket info structure size is wrong")
 
 class CIAFile::DecryptionState {
 public:
+    std::array<u8, 16> title_key{};
     std::vector<CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption> content;
 };
 
@@ -133,8 +137,10 @@ ResultCode CIAFile::WriteTitleMetadata() {
 
     auto content_count = container.GetTitleMetadata().GetContentCount();
     content_written.resize(content_count);
+    content_files.resize(content_count);
 
     if (auto title_key = container.GetTicket().GetTitleKey()) {
+        decryption_state->title_key = *title_key;
         decryption_state->content.resize(content_count);
         for (std::size_t i = 0; i < content_count; ++i) {
             auto ctr = tmd.GetContentCTRByIndex(i);
@@ -162,35 +168,24 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
 
             // The unwritten range for this content is beyond the buffered data we have
             // or comes before the buffered data we have, so skip this content ID.
-            if (range_min > offset_max || range_max < offset) {
+            if (range_min >= offset_max || range_max <= offset) {
                 continue;
             }
 
             // Figure out how much of this content ID we have just recieved/can write out
             const u64 available_to_write = std::min(offset_max, range_max) - range_min;
 
-            // Since the incoming TMD has already been written, we can use GetTitleContentPath
-            // to get the content paths to write to.
-            FileSys::TitleMetadata tmd = container.GetTitleMetadata();
-            FileUtil::IOFile file(GetTitleContentPath(media_type, tmd.GetTitleID(), i, is_update),
-                                  content_written[i] ? "ab" : "wb");
+            // The written buffer belongs to the caller, decrypt a copy of it
+            const u8* const data = buffer + (range_min - offset);
+            content_buffer.assign(data, data + available_to_write);
+            DecryptContentData(i, content_buffer.data(), content_buffer.size());
 
-            if (!file.IsOpen()) {
-                return FileSys::ERROR_INSUFFICIENT_SPACE;
+            const ResultCode result =
+                WriteDecryptedContentData(i, content_buffer.data(), content_buffer.size());
+            if (result.IsError()) {
+                return result;
             }
 
-            std::vector<u8> temp(buffer + (range_min - offset),
-                                 buffer + (range_min - offset) + available_to_write);
-
-            if ((tmd.GetContentTypeByIndex(i) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
-                decryption_state->content[i].ProcessData(temp.data(), temp.data(), temp.size());
-            }
-
-            file.WriteBytes(temp.data(), temp.size());
-
-            // Keep tabs on how much of this content ID has been written so new range_min
-            // values can be calculated.
-            content_written[i] += available_to_write;
             LOG_DEBUG(Service_AM, "Wrote {:x} to content {}, total {:x}", available_to_write, i,
                       content_written[i]);
         }
@@ -199,6 +194,49 @@ ResultVal<std::size_t> CIAFile::WriteContentData(u64 offset, std::size_t length,
     return MakeResult(length);
 }
 
+void CIAFile::DecryptContentData(std::size_t index, u8* buffer, std::size_t length) {
+    const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+    if ((tmd.GetContentTypeByIndex(index) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
+        decryption_state->content[index].ProcessData(buffer, buffer, length);
+    }
+}
+
+void CIAFile::DecryptContentData(std::size_t index, u8* buffer, std::size_t length,
+                                 const std::array<u8, 16>& iv) const {
+    const FileSys::TitleMetadata& tmd = container.GetTitleMetadata();
+    if ((tmd.GetContentTypeByIndex(index) & FileSys::TMDContentTypeFlag::Encrypted) != 0) {
+        const auto& key = decryption_state->title_key;
+        CryptoPP::CBC_Mode<CryptoPP::AES>::Decryption{key.data(), key.size(), iv.data()}
+            .ProcessData(buffer, buffer, length);
+    }
+}
+
+ResultCode CIAFile::WriteDecryptedContentData(std::size_t index, const u8* buffer,
+                                              std::size_t length) {
+    FileUtil::IOFile& file = content_files[index];
+    if (!file.IsOpen()) {
+        // Since the incoming TMD has already been written, we can use GetTitleContentPath
+        // to get the content paths to write to.
+        const u64 title_id = container.GetTitleMetadata().GetTitleID();
+        file = FileUtil::IOFile(GetTitleContentPath(media_type, title_id, index, is_update), "wb");
+        if (!file.IsOpen()) {
+            return FileSys::ERROR_INSUFFICIENT_SPACE;
+        }
+    }
+
+    if (file.WriteBytes(buffer, length) != length) {
+        return FileSys::ERROR_INSUFFICIENT_SPACE;
+    }
+
+    // Keep tabs on how much of this content ID has been written so new range_min
+    // values can be calculated.
+    content_written[index] += length;
+    if (content_written[index] >= container.GetContentSize(index)) {
+        file.Close();
+    }
+    return RESULT_SUCCESS;
+}
+
 ResultVal<std::size_t> CIAFile::Write(u64 offset, std::size_t length, bool flush,
                                       const u8* buffer) {
     written += length;
@@ -279,6 +317,10 @@ bool CIAFile::SetSize(u64 size) const {
 }
 
 bool CIAFile::Close() const {
+    for (auto& file : content_files) {
+        file.Close();
+    }
+
     bool complete = true;
     for (std::size_t i = 0; i < container.GetTitleMetadata().GetContentCount(); i++) {
         if (content_written[i] < container.GetContentSize(static_cast<u16>(i)))
@@ -328,6 +370,146 @@ bool CIAFile::Close() const {
 
 void CIAFile::Flush() const {}
 
+/// Size of the chunks the content data of a CIA is installed in, a multiple of the AES block size
+constexpr std::size_t CIA_INSTALL_CHUNK_SIZE = 0x400000;
+/// Maximum number of threads decrypting the content data during an install
+constexpr std::size_t CIA_INSTALL_MAX_LANES = 4;
+
+namespace {
+struct ContentChunk {
+    std::size_t index = 0;    ///< Index of the content the chunk belongs to
+    std::size_t sequence = 0; ///< Position of the chunk among all the chunks read
+    u8* data = nullptr;       ///< Chunk data, nullptr marks the end of a decryption lane
+    std::size_t length = 0;   ///< Length of the chunk data
+    std::array<u8, 16> iv{};  ///< CBC IV of the chunk, the encrypted block preceding it
+};
+} // Anonymous namespace
+
+/**
+ * Installs the content data of a CIA whose header, ticket and TMD were already written to
+ * install_file. A reader thread reads the content data in large chunks, a thread per decryption
+ * lane decrypts the chunks in place and the calling thread writes them out in order. The chunks
+ * are spread across the lanes round robin, also within a content: CBC decryption only depends on
+ * the preceding encrypted block, which the reader keeps as the IV of the next chunk before the
+ * chunk is decrypted. The file is only used by the reader thread.
+ * @param total_size the size of the CIA, reported to update_callback
+ * @returns true if all the content data was installed
+ */
+static bool InstallCIAContents(CIAFile& install_file, const FileSys::CIAContainer& container,
+                               FileUtil::IOFile& file, u64 total_size,
+                               const std::function<ProgressCallback>& update_callback) {
+    const std::size_t content_count = container.GetTitleMetadata().GetContentCount();
+    const std::size_t num_lanes = std::clamp<std::size_t>(std::thread::hardware_concurrency(), 1,
+                                                          CIA_INSTALL_MAX_LANES);
+
+    // Enough buffers for every stage to work on one while the reader keeps reading ahead. They
+    // are recycled by the writer, so nothing is allocated while installing.
+    const std::size_t num_buffers = num_lanes * 2 + 2;
+    std::vector<u8> buffers(num_buffers * CIA_INSTALL_CHUNK_SIZE);
+    Common::SPSCQueue<u8*> free_buffers;
+    for (std::size_t i = 0; i < num_buffers; i++) {
+        free_buffers.Push(buffers.data() + i * CIA_INSTALL_CHUNK_SIZE);
+    }
+
+    auto decrypt_queues = std::make_unique<Common::SPSCQueue<ContentChunk>[]>(num_lanes);
+    Common::MPSCQueue<ContentChunk> write_queue;
+    std::atomic_bool aborted{false};
+
+    std::thread reader([&] {
+        std::size_t sequence = 0;
+        for (std::size_t i = 0; i < content_count && !aborted; i++) {
+            const u64 size = container.GetContentSize(i);
+            if (!file.Seek(container.GetContentOffset(i), SEEK_SET)) {
+                LOG_ERROR(Service_AM, "Failed to seek to content {}", i);
+                aborted = true;
+                break;
+            }
+            auto iv = container.GetTitleMetadata().GetContentCTRByIndex(i);
+            for (u64 read = 0; read < size && !aborted;) {
+                u8* data = free_buffers.PopWait();
+                const auto length =
+                    static_cast<std::size_t>(std::min<u64>(size - read, CIA_INSTALL_CHUNK_SIZE));
+                if (file.ReadBytes(data, length) != length) {
+                    LOG_ERROR(Service_AM, "Failed to read content {}", i);
+                    aborted = true;
+                    break;
+                }
+                const ContentChunk chunk{i, sequence, data, length, iv};
+                if (length >= iv.size()) {
+                    std::memcpy(iv.data(), data + length - iv.size(), iv.size());
+                }
+                decrypt_queues[sequence % num_lanes].Push(chunk);
+                sequence++;
+                read += length;
+            }
+        }
+        for (std::size_t lane = 0; lane < num_lanes; lane++) {
+            decrypt_queues[lane].Push(ContentChunk{});
+        }
+    });
+
+    std::vector<std::thread> decryptors(num_lanes);
+    for (std::size_t lane = 0; lane < num_lanes; lane++) {
+        decryptors[lane] = std::thread([&, lane] {
+            while (true) {
+                const ContentChunk chunk = decrypt_queues[lane].PopWait();
+                if (chunk.data) {
+                    install_file.DecryptContentData(chunk.index, chunk.data, chunk.length,
+                                                    chunk.iv);
+                }
+                write_queue.Push(chunk);
+                if (!chunk.data) {
+                    break;
+                }
+            }
+        });
+    }
+
+    // The lanes finish their chunks out of order. At most num_buffers chunks are in flight, so a
+    // chunk waiting for its turn is kept in the slot of its sequence number.
+    std::vector<ContentChunk> pending(num_buffers);
+    std::size_t next_sequence = 0;
+
+    // Keep recycling the buffers after an error so the reader can't block on them
+    const u64 content_offset = container.GetContentOffset();
+    u64 total_written = 0;
+    std::size_t finished_lanes = 0;
+    while (finished_lanes < num_lanes) {
+        const ContentChunk received = write_queue.PopWait();
+        if (!received.data) {
+            finished_lanes++;
+            continue;
+        }
+        pending[received.sequence % num_buffers] = received;
+
+        while (pending[next_sequence % num_buffers].data) {
+            ContentChunk& chunk = pending[next_sequence % num_buffers];
+            if (!aborted) {
+                const ResultCode result =
+                    install_file.WriteDecryptedContentData(chunk.index, chunk.data, chunk.length);
+                if (result.IsError()) {
+                    LOG_ERROR(Service_AM, "Failed to write content {} with error code {:08x}",
+                              chunk.index, result.raw);
+                    aborted = true;
+                }
+                total_written += chunk.length;
+                if (update_callback) {
+                    update_callback(content_offset + total_written, total_size);
+                }
+            }
+            free_buffers.Push(chunk.data);
+            chunk = ContentChunk{};
+            next_sequence++;
+        }
+    }
+
+    reader.join();
+    for (auto& decryptor : decryptors) {
+        decryptor.join();
+    }
+    return !aborted;
+}
+
 InstallStatus InstallCIA(const std::string& path,
                          std::function<ProgressCallback>&& update_callback) {
     LOG_INFO(Service_AM, "Installing {}...", path);
@@ -357,21 +539,27 @@ InstallStatus InstallCIA(const std::string& path,
         if (!file.IsOpen())
             return InstallStatus::ErrorFailedToOpenFile;
 
-        std::array<u8, 0x10000> buffer;
-        std::size_t total_bytes_read = 0;
-        while (total_bytes_read != file.GetSize()) {
-            std::size_t bytes_read = file.ReadBytes(buffer.data(), buffer.size());
-            auto result = installFile.Write(static_cast<u64>(total_bytes_read), bytes_read, true,
-                                            static_cast<u8*>(buffer.data()));
-
-            if (update_callback)
-                update_callback(total_bytes_read, file.GetSize());
-            if (result.Failed()) {
-                LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
-                          result.Code().raw);
-                return InstallStatus::ErrorAborted;
-            }
-            total_bytes_read += bytes_read;
+        // Everything before the content data is small, it goes through the regular write path
+        // which loads the ticket and TMD and creates the title directories
+        std::vector<u8> header(container.GetContentOffset());
+        if (file.ReadBytes(header.data(), header.size()) != header.size()) {
+            LOG_ERROR(Service_AM, "Failed to read the header of {}", path);
+            return InstallStatus::ErrorAborted;
+        }
+        auto result = installFile.Write(0, header.size(), true, header.data());
+        if (result.Failed()) {
+            LOG_ERROR(Service_AM, "CIA file installation aborted with error code {:08x}",
+                      result.Code().raw);
+            return InstallStatus::ErrorAborted;
+        }
+        // Only query the size up front, as it seeks the file the content reader is reading from
+        const u64 total_size = file.GetSize();
+        if (update_callback)
+            update_callback(header.size(), total_size);
+
+        if (!InstallCIAContents(installFile, container, file, total_size, update_callback)) {
+            LOG_ERROR(Service_AM, "CIA file installation aborted");
+            return InstallStatus::ErrorAborted;
         }
         installFile.Close();
 
@@ -14,6 +14,7 @@
 #include <boost/serialization/vector.hpp>
 #include "common/common_types.h"
 #include "common/construct.h"
+#include "common/file_util.h"
 #include "core/file_sys/cia_container.h"
 #include "core/file_sys/file_backend.h"
 #include "core/global.h"
@@ -76,6 +77,37 @@ public:
     ResultCode WriteTicket();
     ResultCode WriteTitleMetadata();
     ResultVal<std::size_t> WriteContentData(u64 offset, std::size_t length, const u8* buffer);
+
+    /**
+     * Decrypts the next part of a content in place if the content is encrypted. The parts of a
+     * content have to be passed in order, different contents may be decrypted concurrently.
+     * @param index the content index the data belongs to
+     * @param buffer the content data, its length must be a multiple of the AES block size
+     * @param length the length of the content data
+     */
+    void DecryptContentData(std::size_t index, u8* buffer, std::size_t length);
+
+    /**
+     * Decrypts a part of a content in place if the content is encrypted, starting from the given
+     * IV rather than where the previous part left off. The parts of a content may be decrypted
+     * concurrently and in any order this way.
+     * @param index the content index the data belongs to
+     * @param buffer the content data, its length must be a multiple of the AES block size
+     * @param length the length of the content data
+     * @param iv the content IV for the first part of a content, else the last encrypted block
+     * before the part
+     */
+    void DecryptContentData(std::size_t index, u8* buffer, std::size_t length,
+                            const std::array<u8, 16>& iv) const;
+
+    /**
+     * Appends decrypted data to a content. Only valid once the title metadata is loaded.
+     * @param index the content index the data belongs to
+     * @param buffer the decrypted content data
+     * @param length the length of the content data
+     */
+    ResultCode WriteDecryptedContentData(std::size_t index, const u8* buffer, std::size_t length);
+
     ResultVal<std::size_t> Write(u64 offset, std::size_t length, bool flush,
                                  const u8* buffer) override;
     u64 GetSize() const override;
@@ -97,6 +129,12 @@ private:
     std::vector<u64> content_written;
     Service::FS::MediaType media_type;
 
+    // Output files of the contents, kept open until the content is complete. Close has to
+    // release them before it can delete an aborted install.
+    mutable std::vector<FileUtil::IOFile> content_files;
+    // Scratch buffer the content data is decrypted in when it can't be decrypted in place
+    std::vector<u8> content_buffer;
+
     class DecryptionState;
     std::unique_ptr<DecryptionState> decryption_state;
 };
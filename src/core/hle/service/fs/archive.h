@@ -11,6 +11,7 @@
 #include <boost/serialization/unique_ptr.hpp>
 #include <boost/serialization/unordered_map.hpp>
 #include "common/common_types.h"
+#include "common/thread_worker.h"
 #include "core/file_sys/archive_backend.h"
 #include "core/hle/result.h"
 #include "core/hle/service/fs/directory.h"
@@ -257,9 +258,20 @@ public:
     /// Registers a new NCCH file with the SelfNCCH archive factory
     void RegisterSelfNCCH(Loader::AppLoader& app_loader);
 
+    /**
+     * Returns the worker that performs host I/O for file reads while the requesting guest thread
+     * sleeps for the emulated read delay. It runs a single thread, so the file backends (which
+     * may share a host file handle) are never accessed concurrently from the worker.
+     */
+    Common::ThreadWorker& GetIOWorker() {
+        return io_worker;
+    }
+
 private:
     Core::System& system;
 
+    Common::ThreadWorker io_worker{1, "FS I/O"};
+
     /**
      * Registers an Archive type, instances of which can later be opened using its IdCode.
      * @param factory File system backend interface to the archive
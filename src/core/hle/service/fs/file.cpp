@@ -2,6 +2,8 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <future>
+#include <boost/serialization/shared_ptr.hpp>
 #include <boost/serialization/unique_ptr.hpp>
 #include "common/archives.h"
 #include "common/logging/log.h"
@@ -13,15 +15,93 @@
 #include "core/hle/kernel/client_session.h"
 #include "core/hle/kernel/event.h"
 #include "core/hle/kernel/server_session.h"
+#include "core/hle/service/fs/archive.h"
 #include "core/hle/service/fs/file.h"
 
 SERIALIZE_EXPORT_IMPL(Service::FS::File)
 SERIALIZE_EXPORT_IMPL(Service::FS::FileSessionSlot)
+SERIALIZE_EXPORT_IMPL(Service::FS::File::ReadCallback)
 
 namespace Service::FS {
 
+/// State of a read performed by the FS I/O worker
+struct File::AsyncRead {
+    std::vector<u8> data;
+    ResultCode result = RESULT_SUCCESS;
+    std::size_t read_size = 0;
+    std::promise<void> promise;
+    std::shared_future<void> done = promise.get_future().share();
+};
+
+/**
+ * Completes a file read once the emulated read delay has passed. The FS I/O worker reads into a
+ * host buffer, which is copied to the guest buffer here. If the read is still in progress on the
+ * host, the emulation thread waits for it here.
+ */
+class File::ReadCallback : public Kernel::HLERequestContext::WakeupCallback {
+public:
+    ReadCallback(std::shared_ptr<File> file_, std::shared_ptr<AsyncRead> async_read_, u64 offset_,
+                 u32 length_, u32 buffer_id_)
+        : file(std::move(file_)), async_read(std::move(async_read_)), offset(offset_),
+          length(length_), buffer_id(buffer_id_) {}
+
+    void WakeUp(std::shared_ptr<Kernel::Thread> thread, Kernel::HLERequestContext& ctx,
+                Kernel::ThreadWakeupReason reason) {
+        if (!async_read) {
+            // The read was in flight when the state was saved, so it has to be done again.
+            async_read = std::make_shared<AsyncRead>();
+            DoRead(*file->backend, offset, length, *async_read);
+        }
+        async_read->done.wait();
+
+        auto& buffer = ctx.GetMappedBuffer(buffer_id);
+        IPC::RequestBuilder rb(ctx, 0x0802, 2, 2);
+        if (async_read->result.IsError()) {
+            rb.Push(async_read->result);
+            rb.Push<u32>(0);
+        } else {
+            buffer.Write(async_read->data.data(), 0, async_read->read_size);
+            rb.Push(RESULT_SUCCESS);
+            rb.Push<u32>(static_cast<u32>(async_read->read_size));
+        }
+        rb.PushMappedBuffer(buffer);
+    }
+
+    static void DoRead(FileSys::FileBackend& backend, u64 offset, u32 length,
+                       AsyncRead& async_read) {
+        async_read.data.resize(length);
+        ResultVal<std::size_t> read = backend.Read(offset, length, async_read.data.data());
+        if (read.Failed()) {
+            async_read.result = read.Code();
+        } else {
+            async_read.read_size = *read;
+        }
+        async_read.promise.set_value();
+    }
+
+private:
+    ReadCallback() = default;
+
+    std::shared_ptr<File> file;
+    std::shared_ptr<AsyncRead> async_read; ///< Not serialized, the read is redone on load
+    u64 offset = 0;
+    u32 length = 0;
+    u32 buffer_id = 0;
+
+    template <class Archive>
+    void serialize(Archive& ar, const unsigned int) {
+        ar& boost::serialization::base_object<Kernel::HLERequestContext::WakeupCallback>(*this);
+        ar& file;
+        ar& offset;
+        ar& length;
+        ar& buffer_id;
+    }
+    friend class boost::serialization::access;
+};
+
 template <class Archive>
 void File::serialize(Archive& ar, const unsigned int) {
+    WaitForPendingReads();
     ar& boost::serialization::base_object<Kernel::SessionRequestHandler>(*this);
     ar& path;
     ar& backend;
@@ -36,6 +116,17 @@ File::File(Kernel::KernelSystem& kernel, std::unique_ptr<FileSys::FileBackend>&&
     this->path = path;
 }
 
+File::~File() {
+    WaitForPendingReads();
+}
+
+void File::WaitForPendingReads() {
+    if (last_async_read) {
+        last_async_read->done.wait();
+        last_async_read.reset();
+    }
+}
+
 File::File(Kernel::KernelSystem& kernel)
     : ServiceFramework("", 1), path(""), backend(nullptr), kernel(kernel) {
     static const FunctionInfo functions[] = {
@@ -76,22 +167,20 @@ void File::Read(Kernel::HLERequestContext& ctx) {
                   offset, length, backend->GetSize());
     }
 
-    IPC::RequestBuilder rb = rp.MakeBuilder(2, 2);
-
-    std::vector<u8> data(length);
-    ResultVal<std::size_t> read = backend->Read(offset, data.size(), data.data());
-    if (read.Failed()) {
-        rb.Push(read.Code());
-        rb.Push<u32>(0);
-    } else {
-        buffer.Write(data.data(), 0, *read);
-        rb.Push(RESULT_SUCCESS);
-        rb.Push<u32>(static_cast<u32>(*read));
-    }
-    rb.PushMappedBuffer(buffer);
-
-    std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
-    ctx.SleepClientThread("file::read", read_timeout_ns, nullptr);
+    // Perform the host I/O on the FS I/O worker while the guest thread sleeps for the emulated
+    // read delay. The response is written by the callback when the thread wakes up.
+    auto async_read = std::make_shared<AsyncRead>();
+    last_async_read = async_read;
+    Core::System::GetInstance().ArchiveManager().GetIOWorker().QueueWork(
+        [backend = backend.get(), offset, length, async_read] {
+            ReadCallback::DoRead(*backend, offset, length, *async_read);
+        });
+
+    const std::chrono::nanoseconds read_timeout_ns{backend->GetReadDelayNs(length)};
+    ctx.SleepClientThread(
+        "file::read", read_timeout_ns,
+        std::make_shared<ReadCallback>(std::static_pointer_cast<File>(shared_from_this()),
+                                       std::move(async_read), offset, length, buffer.GetId()));
 }
 
 void File::Write(Kernel::HLERequestContext& ctx) {
@@ -115,9 +204,15 @@ void File::Write(Kernel::HLERequestContext& ctx) {
         return;
     }
 
-    std::vector<u8> data(length);
-    buffer.Read(data.data(), 0, data.size());
-    ResultVal<std::size_t> written = backend->Write(offset, data.size(), flush != 0, data.data());
+    WaitForPendingReads();
+    std::vector<u8> data;
+    std::span<const u8> source = buffer.GetReadSpan(0, length);
+    if (source.empty()) {
+        data.resize(length);
+        buffer.Read(data.data(), 0, data.size());
+        source = data;
+    }
+    ResultVal<std::size_t> written = backend->Write(offset, length, flush != 0, source.data());
 
     // Update file size
     file->size = backend->GetSize();
@@ -156,6 +251,7 @@ void File::SetSize(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingReads();
     file->size = size;
     backend->SetSize(size);
     rb.Push(RESULT_SUCCESS);
@@ -169,6 +265,7 @@ void File::Close(Kernel::HLERequestContext& ctx) {
         LOG_WARNING(Service_FS, "Closing File backend but {} clients still connected",
                     connected_sessions.size());
 
+    WaitForPendingReads();
     backend->Close();
     IPC::RequestBuilder rb = rp.MakeBuilder(1, 0);
     rb.Push(RESULT_SUCCESS);
@@ -187,6 +284,7 @@ void File::Flush(Kernel::HLERequestContext& ctx) {
         return;
     }
 
+    WaitForPendingReads();
     backend->Flush();
     rb.Push(RESULT_SUCCESS);
 }
@@ -224,6 +322,7 @@ void File::OpenLinkFile(Kernel::HLERequestContext& ctx) {
 
     slot->priority = original_file->priority;
     slot->offset = 0;
+    WaitForPendingReads();
     slot->size = backend->GetSize();
     slot->subfile = false;
 
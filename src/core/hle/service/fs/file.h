@@ -41,7 +41,9 @@ class File final : public ServiceFramework<File, FileSessionSlot> {
 public:
     File(Kernel::KernelSystem& kernel, std::unique_ptr<FileSys::FileBackend>&& backend,
          const FileSys::Path& path);
-    ~File() = default;
+    ~File();
+
+    class ReadCallback;
 
     std::string GetName() const {
         return "Path: " + path.DebugStr();
@@ -61,7 +63,11 @@ public:
     // OpenSubFile.
     std::size_t GetSessionFileSize(std::shared_ptr<Kernel::ServerSession> session);
 
+    /// Blocks until the reads of this file that were handed to the FS I/O worker have finished.
+    void WaitForPendingReads();
+
 private:
+    struct AsyncRead;
     void Read(Kernel::HLERequestContext& ctx);
     void Write(Kernel::HLERequestContext& ctx);
     void GetSize(Kernel::HLERequestContext& ctx);
@@ -75,6 +81,10 @@ private:
 
     Kernel::KernelSystem& kernel;
 
+    /// The most recent read handed to the FS I/O worker. The worker executes reads in order, so
+    /// once this one is done, there are no reads of the backend in flight anymore.
+    std::shared_ptr<AsyncRead> last_async_read;
+
     File(Kernel::KernelSystem& kernel);
     File();
 
@@ -87,3 +97,4 @@ private:
 
 BOOST_CLASS_EXPORT_KEY(Service::FS::FileSessionSlot)
 BOOST_CLASS_EXPORT_KEY(Service::FS::File)
+BOOST_CLASS_EXPORT_KEY(Service::FS::File::ReadCallback)
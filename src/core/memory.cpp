@@ -95,6 +95,8 @@ public:
     std::shared_ptr<BackingMem> n3ds_extra_ram_mem;
     std::shared_ptr<BackingMem> dsp_mem;
 
+    bool serialize_ram_contents = true;
+
     Impl();
 
     const u8* GetPtr(Region r) const {
@@ -267,6 +269,31 @@ public:
         return MemoryRef{};
     }
 
+    /**
+     * Turns the pages marked as cached by the rasterizer back into memory pages. Used when the
+     * marks come from a loaded state, as the rasterizer it is loaded into has nothing cached.
+     */
+    void UnmarkRasterizerCachedPages() {
+        const auto unmark_region = [this](VAddr start, VAddr end) {
+            for (VAddr vaddr = start; vaddr != end; vaddr += CITRA_PAGE_SIZE) {
+                if (!cache_marker.IsCached(vaddr)) {
+                    continue;
+                }
+                cache_marker.Mark(vaddr, false);
+                for (auto& page_table : page_table_list) {
+                    const std::size_t page = vaddr >> CITRA_PAGE_BITS;
+                    if (page_table->attributes[page] == PageType::RasterizerCachedMemory) {
+                        page_table->attributes[page] = PageType::Memory;
+                        page_table->pointers[page] = GetPointerForRasterizerCache(vaddr);
+                    }
+                }
+            }
+        };
+        unmark_region(VRAM_VADDR, VRAM_VADDR_END);
+        unmark_region(LINEAR_HEAP_VADDR, LINEAR_HEAP_VADDR_END);
+        unmark_region(NEW_LINEAR_HEAP_VADDR, NEW_LINEAR_HEAP_VADDR_END);
+    }
+
     /**
      * This function should only be called for virtual addreses with attribute `PageType::Special`.
      */
@@ -287,11 +314,13 @@ private:
     void serialize(Archive& ar, const unsigned int file_version) {
         bool save_n3ds_ram = Settings::values.is_new_3ds;
         ar& save_n3ds_ram;
-        ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
-        ar& boost::serialization::make_binary_object(
-            n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+        if (serialize_ram_contents) {
+            ar& boost::serialization::make_binary_object(vram.get(), Memory::VRAM_SIZE);
+            ar& boost::serialization::make_binary_object(
+                fcram.get(), save_n3ds_ram ? Memory::FCRAM_N3DS_SIZE : Memory::FCRAM_SIZE);
+            ar& boost::serialization::make_binary_object(
+                n3ds_extra_ram.get(), save_n3ds_ram ? Memory::N3DS_EXTRA_RAM_SIZE : 0);
+        }
         ar& cache_marker;
         ar& page_table_list;
         // dsp is set from Core::System at startup
@@ -300,6 +329,10 @@ private:
         ar& vram_mem;
         ar& n3ds_extra_ram_mem;
         ar& dsp_mem;
+        if (Archive::is_loading::value) {
+            // States are saved without uncaching the rasterizer surfaces
+            UnmarkRasterizerCachedPages();
+        }
     }
 };
 
@@ -341,11 +374,33 @@ MemorySystem::~MemorySystem() = default;
 
 template <class Archive>
 void MemorySystem::serialize(Archive& ar, const unsigned int file_version) {
+    // Incremental save states restore the RAM contents themselves after loading
+    bool ram_contents = impl->serialize_ram_contents;
+    if (file_version >= 1) {
+        ar& ram_contents;
+    }
+    impl->serialize_ram_contents = ram_contents;
     ar&* impl.get();
+    if (Archive::is_loading::value) {
+        impl->serialize_ram_contents = true;
+    }
 }
 
 SERIALIZE_IMPL(MemorySystem)
 
+std::vector<std::span<u8>> MemorySystem::GetSaveStateRam() {
+    const bool n3ds_ram = Settings::values.is_new_3ds;
+    return {
+        {impl->vram.get(), VRAM_SIZE},
+        {impl->fcram.get(), n3ds_ram ? FCRAM_N3DS_SIZE : FCRAM_SIZE},
+        {impl->n3ds_extra_ram.get(), n3ds_ram ? N3DS_EXTRA_RAM_SIZE : 0},
+    };
+}
+
+void MemorySystem::SetSerializeRamContents(bool enabled) {
+    impl->serialize_ram_contents = enabled;
+}
+
 void MemorySystem::SetCurrentPageTable(std::shared_ptr<PageTable> page_table) {
     impl->current_page_table = page_table;
 }
@@ -759,6 +814,27 @@ void RasterizerFlushVirtualRegion(VAddr start, u32 size, FlushMode mode) {
     CheckRegion(VRAM_VADDR, VRAM_VADDR_END, VRAM_PADDR);
 }
 
+u8* MemorySystem::GetContiguousBlockPointer(const Kernel::Process& process, const VAddr vaddr,
+                                            const std::size_t size) {
+    if (size == 0 || vaddr + static_cast<u64>(size) > (u64{1} << 32)) {
+        return nullptr;
+    }
+
+    auto& page_table = *process.vm_manager.page_table;
+    const std::size_t first_page = vaddr >> CITRA_PAGE_BITS;
+    const std::size_t last_page = (vaddr + size - 1) >> CITRA_PAGE_BITS;
+
+    // Rasterizer cached pages are excluded as accesses to them have to flush/invalidate the cache.
+    u8* const base_pointer = page_table.pointers[first_page];
+    for (std::size_t page = first_page; page <= last_page; ++page) {
+        if (page_table.attributes[page] != PageType::Memory ||
+            page_table.pointers[page] != base_pointer + (page - first_page) * CITRA_PAGE_SIZE) {
+            return nullptr;
+        }
+    }
+    return base_pointer + (vaddr & CITRA_PAGE_MASK);
+}
+
 u8 MemorySystem::Read8(const VAddr addr) {
     return Read<u8>(addr);
 }
@@ -5,9 +5,12 @@
 #pragma once
 #include <array>
 #include <cstddef>
+#include <span>
 #include <string>
+#include <vector>
 #include <boost/serialization/array.hpp>
 #include <boost/serialization/vector.hpp>
+#include <boost/serialization/version.hpp>
 #include "common/memory_ref.h"
 #include "core/mmio.h"
 
@@ -329,6 +332,20 @@ public:
      */
     const u8* GetPointer(VAddr vaddr) const;
 
+    /**
+     * Gets a pointer to a block of a process' address space, if the whole block is backed by
+     * contiguous host memory that is not cached by the rasterizer.
+     *
+     * @param process The process whose address space the block is in.
+     * @param vaddr   The virtual address of the start of the block.
+     * @param size    The size of the block, in bytes.
+     *
+     * @returns The pointer to the start of the block, if it can be accessed directly.
+     *          Otherwise nullptr is returned and the block has to be accessed with
+     *          ReadBlock/WriteBlock instead.
+     */
+    u8* GetContiguousBlockPointer(const Kernel::Process& process, VAddr vaddr, std::size_t size);
+
     /**
      * Reads an 8-bit unsigned value from the current process' address space
      * at the given virtual address.
@@ -585,6 +602,16 @@ public:
 
     void SetDSP(AudioCore::DspInterface& dsp);
 
+    /// Returns the RAM stored in save states (VRAM, FCRAM and the New 3DS extra RAM), in the order
+    /// it is serialized
+    std::vector<std::span<u8>> GetSaveStateRam();
+
+    /**
+     * Sets whether serializing the memory system includes the RAM contents. Incremental save
+     * states turn this off while saving and store the RAM pages on their own.
+     */
+    void SetSerializeRamContents(bool enabled);
+
 private:
     template <typename T>
     T Read(const VAddr vaddr);
@@ -620,3 +647,4 @@ BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::FCRA
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::VRAM>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::DSP>)
 BOOST_CLASS_EXPORT_KEY(Memory::MemorySystem::BackingMemImpl<Memory::Region::N3DS>)
+BOOST_CLASS_VERSION(Memory::MemorySystem, 1)
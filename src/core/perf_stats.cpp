@@ -63,6 +63,7 @@ void PerfStats::EndSystemFrame() {
     }
     accumulated_frametime += frame_time;
     system_frames += 1;
+    total_system_frames += 1;
 
     previous_frame_length = frame_end - previous_frame_end;
     previous_frame_end = frame_end;
@@ -74,6 +75,15 @@ void PerfStats::EndGameFrame() {
     game_frames += 1;
 }
 
+void PerfStats::UpdateTextureCacheStats(u32 resident_surfaces_, u64 resident_bytes,
+                                        u32 evicted_surfaces_) {
+    std::lock_guard lock{object_mutex};
+
+    resident_surfaces = resident_surfaces_;
+    resident_surface_bytes = resident_bytes;
+    evicted_surfaces += evicted_surfaces_;
+}
+
 double PerfStats::GetMeanFrametime() const {
     std::lock_guard lock{object_mutex};
 
@@ -86,6 +96,23 @@ double PerfStats::GetMeanFrametime() const {
     return sum / static_cast<double>(current_index - IgnoreFrames);
 }
 
+std::vector<double> PerfStats::GetFrametimeHistory() const {
+    std::lock_guard lock{object_mutex};
+
+    if (current_index <= IgnoreFrames) {
+        return {};
+    }
+
+    return std::vector<double>(perf_history.begin() + IgnoreFrames,
+                               perf_history.begin() + current_index);
+}
+
+u64 PerfStats::GetSystemFrameCount() const {
+    std::lock_guard lock{object_mutex};
+
+    return total_system_frames;
+}
+
 PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_us) {
     std::lock_guard lock(object_mutex);
 
@@ -101,6 +128,9 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     results.frametime = duration_cast<DoubleSecs>(accumulated_frametime).count() /
                         static_cast<double>(system_frames);
     results.emulation_speed = system_us_per_second.count() / 1'000'000.0;
+    results.resident_surfaces = resident_surfaces;
+    results.resident_surface_bytes = resident_surface_bytes;
+    results.surface_evictions = static_cast<double>(evicted_surfaces) / interval;
 
     // Reset counters
     reset_point = now;
@@ -108,6 +138,7 @@ PerfStats::Results PerfStats::GetAndResetStats(microseconds current_system_time_
     accumulated_frametime = Clock::duration::zero();
     system_frames = 0;
     game_frames = 0;
+    evicted_surfaces = 0;
 
     return results;
 }
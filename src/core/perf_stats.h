@@ -9,6 +9,7 @@
 #include <chrono>
 #include <cstddef>
 #include <mutex>
+#include <vector>
 #include "common/common_types.h"
 #include "common/thread.h"
 
@@ -34,12 +35,21 @@ public:
         double frametime;
         /// Ratio of walltime / emulated time elapsed
         double emulation_speed;
+        /// Surfaces resident in the texture cache, 0 if the renderer does not report them
+        u32 resident_surfaces;
+        /// Estimated host memory used by the resident surfaces, in bytes
+        u64 resident_surface_bytes;
+        /// Surfaces evicted from the texture cache per second
+        double surface_evictions;
     };
 
     void BeginSystemFrame();
     void EndSystemFrame();
     void EndGameFrame();
 
+    /// Records the residency counters of the texture cache after a frame was presented
+    void UpdateTextureCacheStats(u32 resident_surfaces, u64 resident_bytes, u32 evicted_surfaces);
+
     Results GetAndResetStats(std::chrono::microseconds current_system_time_us);
 
     /**
@@ -47,6 +57,18 @@ public:
      */
     double GetMeanFrametime() const;
 
+    /**
+     * Returns the frametime values in milliseconds stored in the performance history, excluding
+     * the first frames after boot.
+     */
+    std::vector<double> GetFrametimeHistory() const;
+
+    /**
+     * Returns the number of system frames presented since the title started. Unlike the
+     * performance history, this keeps counting past an hour.
+     */
+    u64 GetSystemFrameCount() const;
+
     /**
      * Gets the ratio between walltime and the emulated time of the previous system frame. This is
      * useful for scaling inputs or outputs moving between the two time domains.
@@ -69,12 +91,20 @@ private:
     /// System time when the cumulative counters were reset
     std::chrono::microseconds reset_point_system_us{0};
 
+    /// Number of system frames presented since the title started
+    u64 total_system_frames = 0;
+
     /// Cumulative duration (excluding v-sync/frame-limiting) of frames since last reset
     Clock::duration accumulated_frametime = Clock::duration::zero();
     /// Cumulative number of system frames (LCD VBlanks) presented since last reset
     u32 system_frames = 0;
     /// Cumulative number of game frames (GSP frame submissions) since last reset
     u32 game_frames = 0;
+    /// Cumulative number of surfaces evicted from the texture cache since last reset
+    u32 evicted_surfaces = 0;
+    /// Texture cache residency reported after the last presented frame
+    u32 resident_surfaces = 0;
+    u64 resident_surface_bytes = 0;
 
     /// Point when the previous system frame ended
     Clock::time_point previous_frame_end = reset_point;
@@ -0,0 +1,196 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include "common/logging/log.h"
+#include "common/zstd_compression.h"
+#include "core/core_timing.h"
+#include "core/hw/gpu.h"
+#include "core/rewind_buffer.h"
+
+namespace Core {
+
+/// The RAM deltas are mostly zeros, which compress well enough at the fastest level
+constexpr s32 DeltaCompressionLevel = 1;
+
+using Clock = std::chrono::steady_clock;
+
+static double ToMilliseconds(Clock::duration duration) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+/// XORs the source into the destination, both are multiples of the page size
+static void XorInto(std::vector<u8>& destination, const std::vector<u8>& source) {
+    auto* out = reinterpret_cast<u64*>(destination.data());
+    const auto* in = reinterpret_cast<const u64*>(source.data());
+    for (std::size_t i = 0; i < destination.size() / sizeof(u64); i++) {
+        out[i] ^= in[i];
+    }
+}
+
+RewindBuffer::RewindBuffer(u32 interval_frames, std::size_t memory_limit)
+    : interval_ticks{std::max<u32>(interval_frames, 1) * GPU::frame_ticks},
+      memory_limit{memory_limit} {
+    stats.memory_limit = memory_limit;
+    worker = std::thread(&RewindBuffer::WorkerLoop, this);
+}
+
+RewindBuffer::~RewindBuffer() {
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    worker_cv.notify_one();
+    worker.join();
+}
+
+bool RewindBuffer::IsCaptureDue(u64 ticks) const {
+    // The emulated time goes back when a save state is loaded, start over from there
+    return ticks >= next_capture_ticks || next_capture_ticks - ticks > interval_ticks;
+}
+
+void RewindBuffer::Capture(u64 ticks, const CaptureFunction& capture) {
+    next_capture_ticks = ticks + interval_ticks;
+    {
+        std::lock_guard lock(mutex);
+        if (pending) {
+            // Rather lose a snapshot than stall emulation
+            stats.skipped_captures++;
+            return;
+        }
+    }
+
+    const auto start = Clock::now();
+    std::ostringstream system{std::ios_base::binary};
+    const auto ram = capture(system);
+
+    std::size_t ram_size = 0;
+    for (const auto& region : ram) {
+        ram_size += region.size();
+    }
+    staging_ram.resize(ram_size);
+    u8* out = staging_ram.data();
+    for (const auto& region : ram) {
+        std::memcpy(out, region.data(), region.size());
+        out += region.size();
+    }
+    const auto capture_time = Clock::now() - start;
+
+    {
+        std::lock_guard lock(mutex);
+        staging_ticks = ticks;
+        staging_system = std::move(system).str();
+        stats.capture_time = ToMilliseconds(capture_time);
+        pending = true;
+    }
+    worker_cv.notify_one();
+}
+
+bool RewindBuffer::Rewind(const RestoreFunction& restore) {
+    std::unique_lock lock(mutex);
+    idle_cv.wait(lock, [this] { return !pending; });
+    if (snapshots.empty()) {
+        return false;
+    }
+
+    const Snapshot& snapshot = snapshots.back();
+    const auto system = Common::Compression::DecompressDataZSTD(snapshot.system);
+    std::istringstream stream{
+        std::string{reinterpret_cast<const char*>(system.data()), system.size()},
+        std::ios_base::binary};
+    const auto ram = restore(stream);
+
+    const u8* in = latest_ram.data();
+    for (const auto& region : ram) {
+        if (static_cast<std::size_t>(latest_ram.data() + latest_ram.size() - in) <
+            region.size()) {
+            throw std::runtime_error("Rewind snapshot does not match the memory layout");
+        }
+        std::memcpy(region.data(), in, region.size());
+        in += region.size();
+    }
+
+    // Step the kept RAM back to the previous snapshot, which the next rewind restores
+    if (snapshots.size() > 1) {
+        const auto delta = Common::Compression::DecompressDataZSTD(snapshot.ram_delta);
+        if (delta.size() != latest_ram.size()) {
+            throw std::runtime_error("Rewind snapshot is corrupted");
+        }
+        XorInto(latest_ram, delta);
+    } else {
+        latest_ram.clear();
+    }
+
+    next_capture_ticks = snapshot.ticks + interval_ticks;
+    stats.memory_used -= snapshot.Size();
+    snapshots.pop_back();
+    stats.num_snapshots = snapshots.size();
+    stats.seconds_covered = snapshots.empty() ? 0.0
+                                              : static_cast<double>(snapshots.back().ticks -
+                                                                    snapshots.front().ticks) /
+                                                    BASE_CLOCK_RATE_ARM11;
+    return true;
+}
+
+RewindBuffer::Stats RewindBuffer::GetStats() const {
+    std::lock_guard lock(mutex);
+    return stats;
+}
+
+void RewindBuffer::WorkerLoop() {
+    std::unique_lock lock(mutex);
+    while (true) {
+        worker_cv.wait(lock, [this] { return pending || stop; });
+        if (stop) {
+            return;
+        }
+        lock.unlock();
+
+        const auto start = Clock::now();
+        Snapshot snapshot;
+        snapshot.ticks = staging_ticks;
+        snapshot.system = Common::Compression::CompressDataZSTDDefault(
+            reinterpret_cast<const u8*>(staging_system.data()), staging_system.size());
+
+        // Nothing else touches the snapshots while one is pending
+        const bool has_previous = !snapshots.empty() && latest_ram.size() == staging_ram.size();
+        if (has_previous) {
+            XorInto(latest_ram, staging_ram);
+            snapshot.ram_delta = Common::Compression::CompressDataZSTD(
+                latest_ram.data(), latest_ram.size(), DeltaCompressionLevel);
+        }
+        std::swap(latest_ram, staging_ram);
+        const auto compression_time = Clock::now() - start;
+
+        lock.lock();
+        if (!has_previous) {
+            snapshots.clear();
+            stats.memory_used = 0;
+        }
+        stats.memory_used += snapshot.Size();
+        snapshots.push_back(std::move(snapshot));
+        while (stats.memory_used > memory_limit && snapshots.size() > 1) {
+            stats.memory_used -= snapshots.front().Size();
+            snapshots.pop_front();
+        }
+
+        stats.num_snapshots = snapshots.size();
+        stats.seconds_covered =
+            static_cast<double>(snapshots.back().ticks - snapshots.front().ticks) /
+            BASE_CLOCK_RATE_ARM11;
+        stats.ram_copy_size = latest_ram.size() + staging_ram.size();
+        stats.compression_time = ToMilliseconds(compression_time);
+        LOG_DEBUG(Core, "Rewind snapshot {} KiB, capture {:.2f} ms, compression {:.2f} ms",
+                  snapshots.back().Size() / 1024, stats.capture_time, stats.compression_time);
+
+        pending = false;
+        idle_cv.notify_all();
+    }
+}
+
+} // namespace Core
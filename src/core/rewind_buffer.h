@@ -0,0 +1,111 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+
+namespace Core {
+
+/**
+ * Keeps compressed snapshots of the emulated system in memory to rewind emulation to.
+ *
+ * The system state without the RAM is compressed as is. The RAM is stored as backward deltas: only
+ * the RAM of the newest snapshot is kept whole, and every snapshot holds the XOR of its RAM with
+ * the RAM of the snapshot before it. The deltas are mostly zeros and compress very well, and the
+ * oldest snapshots can be dropped to stay within the memory limit without touching the others.
+ *
+ * The compression runs on a background thread. Emulation only stops to serialize the system and
+ * copy the RAM.
+ */
+class RewindBuffer {
+public:
+    struct Stats {
+        std::size_t num_snapshots;
+        double seconds_covered;    ///< Emulated time between the oldest and the newest snapshot
+        std::size_t memory_used;   ///< Size of the compressed snapshots, in bytes
+        std::size_t memory_limit;  ///< Limit on memory_used, in bytes
+        std::size_t ram_copy_size; ///< Size of the two uncompressed RAM copies, in bytes
+        double capture_time;       ///< Time emulation stopped for the last snapshot, in ms
+        double compression_time;   ///< Time spent compressing the last snapshot, in ms
+        u64 skipped_captures;      ///< Snapshots skipped as the previous one was still compressing
+    };
+
+    /// Serializes the system without its RAM and returns the RAM, in the same order every time
+    using CaptureFunction = std::function<std::vector<std::span<u8>>(std::ostream& system)>;
+
+    /// Deserializes the system and returns the RAM to restore, in the order it was captured in
+    using RestoreFunction = std::function<std::vector<std::span<u8>>(std::istream& system)>;
+
+    /**
+     * @param interval_frames Emulated frames between two snapshots
+     * @param memory_limit Memory the compressed snapshots may take up, in bytes
+     */
+    explicit RewindBuffer(u32 interval_frames, std::size_t memory_limit);
+    ~RewindBuffer();
+
+    /// Whether a snapshot should be taken at the given emulated time. Emulation thread only.
+    [[nodiscard]] bool IsCaptureDue(u64 ticks) const;
+
+    /**
+     * Takes a snapshot and hands it over to the background thread for compression. Emulation
+     * thread only.
+     */
+    void Capture(u64 ticks, const CaptureFunction& capture);
+
+    /**
+     * Restores the newest snapshot and drops it, so that the next call goes further back.
+     * Emulation thread only.
+     * @returns false if there is no snapshot to rewind to
+     */
+    bool Rewind(const RestoreFunction& restore);
+
+    [[nodiscard]] Stats GetStats() const;
+
+private:
+    struct Snapshot {
+        u64 ticks;
+        std::vector<u8> system;
+        std::vector<u8> ram_delta; ///< XOR with the RAM of the snapshot before, empty for the first
+
+        [[nodiscard]] std::size_t Size() const {
+            return system.size() + ram_delta.size();
+        }
+    };
+
+    void WorkerLoop();
+
+    const u64 interval_ticks;
+    const std::size_t memory_limit;
+    u64 next_capture_ticks = 0; ///< Only accessed by the emulation thread
+
+    std::thread worker;
+    mutable std::mutex mutex;
+    std::condition_variable worker_cv; ///< Signals a pending snapshot or stop to the worker
+    std::condition_variable idle_cv;   ///< Signals the worker finished the pending snapshot
+    bool pending = false;
+    bool stop = false;
+
+    /// Snapshot handed over to the worker, owned by the worker while pending is set
+    u64 staging_ticks = 0;
+    std::string staging_system;
+    std::vector<u8> staging_ram;
+
+    /// RAM of the newest snapshot, owned by the worker while pending is set
+    std::vector<u8> latest_ram;
+
+    std::deque<Snapshot> snapshots;
+    Stats stats{};
+};
+
+} // namespace Core
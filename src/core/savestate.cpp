@@ -2,17 +2,32 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
+#include <bit>
 #include <chrono>
+#include <functional>
+#include <future>
+#include <optional>
+#include <random>
+#include <set>
+#include <span>
+#include <streambuf>
+#include <thread>
 #include <boost/serialization/binary_object.hpp>
 #include <cryptopp/hex.h>
 #include "common/archives.h"
+#include "common/common_paths.h"
+#include "common/hash.h"
 #include "common/logging/log.h"
 #include "common/scm_rev.h"
+#include "common/scope_exit.h"
 #include "common/zstd_compression.h"
 #include "core/cheats/cheats.h"
 #include "core/core.h"
+#include "core/memory.h"
 #include "core/movie.h"
 #include "core/savestate.h"
+#include "core/settings.h"
 #include "network/network.h"
 #include "video_core/video_core.h"
 
@@ -24,8 +39,9 @@ struct CSTHeader {
     u64_le program_id;           /// ID of the ROM being executed. Also called title_id
     std::array<u8, 20> revision; /// Git hash of the revision this savestate was created with
     u64_le time;                 /// The time when this save state was created
+    u64_le base_id; /// ID of the base snapshot of an incremental save state, 0 for full ones
 
-    std::array<u8, 216> reserved; /// Make heading 256 bytes so it has consistent size
+    std::array<u8, 208> reserved; /// Make heading 256 bytes so it has consistent size
 
     template <class Archive>
     void serialize(Archive& ar, const unsigned int) {
@@ -36,17 +52,279 @@ static_assert(sizeof(CSTHeader) == 256, "CSTHeader should be 256 bytes");
 #pragma pack(pop)
 
 constexpr std::array<u8, 4> header_magic_bytes{{'C', 'S', 'T', 0x1B}};
+constexpr std::array<u8, 4> base_magic_bytes{{'C', 'S', 'B', 0x1B}};
 
-std::string GetSaveStatePath(u64 program_id, u32 slot) {
+/// Granularity at which incremental save states compare the RAM against their base
+constexpr std::size_t DeltaPageSize = Memory::CITRA_PAGE_SIZE;
+
+static std::string GetSaveStateName(u64 program_id) {
     const u64 movie_id = Movie::GetInstance().GetCurrentMovieID();
     if (movie_id) {
-        return fmt::format("{}{:016X}.movie{:016X}.{:02d}.cst",
-                           FileUtil::GetUserPath(FileUtil::UserPath::StatesDir), program_id,
-                           movie_id, slot);
+        return fmt::format("{:016X}.movie{:016X}", program_id, movie_id);
     } else {
-        return fmt::format("{}{:016X}.{:02d}.cst",
-                           FileUtil::GetUserPath(FileUtil::UserPath::StatesDir), program_id, slot);
+        return fmt::format("{:016X}", program_id);
+    }
+}
+
+std::string GetSaveStatePath(u64 program_id, u32 slot) {
+    return fmt::format("{}{}.{:02d}.cst", FileUtil::GetUserPath(FileUtil::UserPath::StatesDir),
+                       GetSaveStateName(program_id), slot);
+}
+
+static std::string GetSaveStateBasePath(u64 program_id, u64 base_id) {
+    return fmt::format("{}{}.base{:016X}.csb",
+                       FileUtil::GetUserPath(FileUtil::UserPath::StatesDir),
+                       GetSaveStateName(program_id), base_id);
+}
+
+static CSTHeader MakeSaveStateHeader(const std::array<u8, 4>& filetype, u64 program_id) {
+    CSTHeader header{};
+    header.filetype = filetype;
+    header.program_id = program_id;
+    std::string rev_bytes;
+    CryptoPP::StringSource(Common::g_scm_rev, true,
+                           new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
+    std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(header.revision));
+    header.time = std::chrono::duration_cast<std::chrono::seconds>(
+                      std::chrono::system_clock::now().time_since_epoch())
+                      .count();
+    return header;
+}
+
+namespace {
+
+/**
+ * Incremental save states only store the RAM pages that differ from a base snapshot of the RAM
+ * shared by all the slots. The hashes of the pages of the last used base are kept around so that
+ * saving does not need to read the base back.
+ */
+struct DeltaBase {
+    u64 program_id;
+    std::string name; ///< Save state name the base belongs to, includes the movie
+    u64 id;
+    std::vector<u64> page_hashes;
+};
+
+std::optional<DeltaBase> delta_base;
+
+/// The RAM pages of a save state that differ from the base
+struct RamDelta {
+    u64 base_id;
+    bool new_base;
+    std::vector<u8> data; ///< Compressed dirty page bitmap followed by the dirty pages
+};
+
+} // Anonymous namespace
+
+static std::vector<u64> HashRamPages(const std::vector<std::span<u8>>& ram) {
+    std::vector<u64> hashes;
+    for (const auto& region : ram) {
+        for (std::size_t offset = 0; offset < region.size(); offset += DeltaPageSize) {
+            hashes.push_back(Common::ComputeHash64(region.data() + offset, DeltaPageSize));
+        }
+    }
+    return hashes;
+}
+
+static u8* GetRamPage(const std::vector<std::span<u8>>& ram, std::size_t page) {
+    for (const auto& region : ram) {
+        const std::size_t region_pages = region.size() / DeltaPageSize;
+        if (page < region_pages) {
+            return region.data() + page * DeltaPageSize;
+        }
+        page -= region_pages;
+    }
+    return nullptr;
+}
+
+/// Number of threads compressing save states
+static u32 GetCompressionWorkers() {
+    return std::max(1U, std::thread::hardware_concurrency());
+}
+
+/// Writes a new base snapshot of the RAM, stored as one compressed block per memory region
+static void WriteDeltaBase(u64 program_id, const std::vector<std::span<u8>>& ram,
+                           std::vector<u64> page_hashes) {
+    std::random_device device;
+    u64 id = 0;
+    while (id == 0) {
+        id = (static_cast<u64>(device()) << 32) | device();
+    }
+
+    const auto path = GetSaveStateBasePath(program_id, id);
+    if (!FileUtil::CreateFullPath(path)) {
+        throw std::runtime_error("Could not create path " + path);
     }
+    FileUtil::IOFile file(path, "wb");
+    if (!file) {
+        throw std::runtime_error("Could not open file " + path);
+    }
+
+    CSTHeader header = MakeSaveStateHeader(base_magic_bytes, program_id);
+    header.base_id = id;
+    bool success = file.WriteBytes(&header, sizeof(header)) == sizeof(header);
+    for (const auto& region : ram) {
+        if (!success) {
+            break;
+        }
+        // The size of a block is only known once it is compressed, fill it in afterwards
+        const u64 size_offset = file.Tell();
+        u64_le size = 0;
+        success = file.WriteBytes(&size, sizeof(size)) == sizeof(size);
+
+        Common::Compression::ZstdCompressStreamBuffer buffer{
+            file, Common::Compression::ZSTD_DEFAULT_COMPRESSION_LEVEL, GetCompressionWorkers()};
+        success = success &&
+                  buffer.sputn(reinterpret_cast<const char*>(region.data()),
+                               static_cast<std::streamsize>(region.size())) ==
+                      static_cast<std::streamsize>(region.size()) &&
+                  buffer.Finish();
+
+        const u64 end_offset = file.Tell();
+        size = end_offset - size_offset - sizeof(size);
+        success = success && file.Seek(size_offset, SEEK_SET) &&
+                  file.WriteBytes(&size, sizeof(size)) == sizeof(size) &&
+                  file.Seek(end_offset, SEEK_SET);
+    }
+    if (!success) {
+        file.Close();
+        FileUtil::Delete(path);
+        throw std::runtime_error("Could not write to file " + path);
+    }
+
+    delta_base = DeltaBase{program_id, GetSaveStateName(program_id), id, std::move(page_hashes)};
+}
+
+/// Compares the RAM against the current base, rebasing when most of it changed since
+static RamDelta BuildRamDelta(u64 program_id, const std::vector<std::span<u8>>& ram) {
+    auto page_hashes = HashRamPages(ram);
+    const std::size_t num_pages = page_hashes.size();
+
+    const bool base_valid =
+        delta_base && delta_base->program_id == program_id &&
+        delta_base->name == GetSaveStateName(program_id) &&
+        delta_base->page_hashes.size() == num_pages &&
+        FileUtil::Exists(GetSaveStateBasePath(program_id, delta_base->id));
+
+    std::vector<u64> dirty_bitmap((num_pages + 63) / 64);
+    std::size_t num_dirty = num_pages;
+    if (base_valid) {
+        num_dirty = 0;
+        for (std::size_t page = 0; page < num_pages; page++) {
+            if (page_hashes[page] != delta_base->page_hashes[page]) {
+                dirty_bitmap[page / 64] |= u64{1} << (page % 64);
+                num_dirty++;
+            }
+        }
+    }
+
+    // Past this point the deltas stop saving much space, start again from the current RAM
+    bool new_base = false;
+    if (num_dirty > num_pages / 2) {
+        WriteDeltaBase(program_id, ram, std::move(page_hashes));
+        std::fill(dirty_bitmap.begin(), dirty_bitmap.end(), 0);
+        num_dirty = 0;
+        new_base = true;
+    }
+
+    const std::size_t bitmap_size = dirty_bitmap.size() * sizeof(u64);
+    std::vector<u8> raw(bitmap_size + num_dirty * DeltaPageSize);
+    std::memcpy(raw.data(), dirty_bitmap.data(), bitmap_size);
+    u8* out = raw.data() + bitmap_size;
+    for (std::size_t page = 0; page < num_pages && num_dirty != 0; page++) {
+        if ((dirty_bitmap[page / 64] >> (page % 64)) & 1) {
+            std::memcpy(out, GetRamPage(ram, page), DeltaPageSize);
+            out += DeltaPageSize;
+        }
+    }
+
+    return {delta_base->id, new_base,
+            Common::Compression::CompressDataZSTDDefault(raw.data(), raw.size())};
+}
+
+/// Restores the RAM from a base snapshot and applies the delta of a save state on top of it
+static void LoadRamDelta(u64 program_id, u64 base_id, FileUtil::IOFile& base_file,
+                         const std::vector<u8>& delta, const std::vector<std::span<u8>>& ram) {
+    // Decompress the base straight into the RAM, the file is past the header
+    for (const auto& region : ram) {
+        u64_le size;
+        if (base_file.ReadBytes(&size, sizeof(size)) != sizeof(size)) {
+            throw std::runtime_error("Save state base is truncated");
+        }
+        const u64 data_offset = base_file.Tell();
+
+        Common::Compression::ZstdDecompressStreamBuffer buffer{base_file, size};
+        if (buffer.sgetn(reinterpret_cast<char*>(region.data()),
+                         static_cast<std::streamsize>(region.size())) !=
+                static_cast<std::streamsize>(region.size()) ||
+            buffer.sgetc() != std::streambuf::traits_type::eof()) {
+            throw std::runtime_error("Save state base does not match the memory layout");
+        }
+        base_file.Seek(data_offset + size, SEEK_SET);
+    }
+
+    auto page_hashes = HashRamPages(ram);
+    const std::size_t num_pages = page_hashes.size();
+    delta_base = DeltaBase{program_id, GetSaveStateName(program_id), base_id,
+                           std::move(page_hashes)};
+
+    const auto decompressed = Common::Compression::DecompressDataZSTD(delta);
+    const std::size_t bitmap_size = (num_pages + 63) / 64 * sizeof(u64);
+    if (decompressed.size() < bitmap_size) {
+        throw std::runtime_error("Save state RAM delta is truncated");
+    }
+    std::vector<u64> dirty_bitmap(bitmap_size / sizeof(u64));
+    std::memcpy(dirty_bitmap.data(), decompressed.data(), bitmap_size);
+
+    std::size_t num_dirty = 0;
+    for (const u64 word : dirty_bitmap) {
+        num_dirty += std::popcount(word);
+    }
+    if (decompressed.size() != bitmap_size + num_dirty * DeltaPageSize) {
+        throw std::runtime_error("Save state RAM delta is truncated");
+    }
+
+    const u8* in = decompressed.data() + bitmap_size;
+    for (std::size_t page = 0; page < num_pages; page++) {
+        if ((dirty_bitmap[page / 64] >> (page % 64)) & 1) {
+            std::memcpy(GetRamPage(ram, page), in, DeltaPageSize);
+            in += DeltaPageSize;
+        }
+    }
+}
+
+/// Deletes the base snapshots that no save state slot refers to anymore
+static void DeleteUnusedSaveStateBases(u64 program_id) {
+    std::set<u64> used_bases;
+    if (delta_base) {
+        used_bases.insert(delta_base->id);
+    }
+    for (u32 slot = 1; slot <= SaveStateSlotCount; ++slot) {
+        FileUtil::IOFile file(GetSaveStatePath(program_id, slot), "rb");
+        CSTHeader header;
+        if (file && file.ReadBytes(&header, sizeof(header)) == sizeof(header) &&
+            header.filetype == header_magic_bytes && header.base_id != 0) {
+            used_bases.insert(header.base_id);
+        }
+    }
+
+    const std::string prefix = GetSaveStateName(program_id) + ".base";
+    const std::string suffix = ".csb";
+    FileUtil::ForeachDirectoryEntry(
+        nullptr, FileUtil::GetUserPath(FileUtil::UserPath::StatesDir),
+        [&](u64*, const std::string& directory, const std::string& virtual_name) {
+            if (virtual_name.size() != prefix.size() + 16 + suffix.size() ||
+                !virtual_name.starts_with(prefix) || !virtual_name.ends_with(suffix)) {
+                return true;
+            }
+            const u64 id =
+                std::strtoull(virtual_name.substr(prefix.size(), 16).c_str(), nullptr, 16);
+            if (!used_bases.contains(id)) {
+                LOG_INFO(Core, "Deleting unused save state base {}", virtual_name);
+                FileUtil::Delete(directory + DIR_SEP + virtual_name);
+            }
+            return true;
+        });
 }
 
 std::vector<SaveStateInfo> ListSaveStates(u64 program_id) {
@@ -97,69 +375,292 @@ std::vector<SaveStateInfo> ListSaveStates(u64 program_id) {
     return result;
 }
 
-void System::SaveState(u32 slot) const {
-    std::ostringstream sstream{std::ios_base::binary};
-    // Serialize
-    oarchive oa{sstream};
-    oa&* this;
-
-    const std::string& str{sstream.str()};
-    auto buffer = Common::Compression::CompressDataZSTDDefault(
-        reinterpret_cast<const u8*>(str.data()), str.size());
-
-    const auto path = GetSaveStatePath(title_id, slot);
+/**
+ * Writes a save state file.
+ * @param write_system writes the serialized system into the compressed stream
+ * @param get_ram returns the RAM of incremental save states, called after write_system
+ */
+static void WriteSaveState(u64 program_id, u32 slot, bool incremental,
+                           const std::function<void(std::streambuf&)>& write_system,
+                           const std::function<std::vector<std::span<u8>>()>& get_ram) {
+    const auto path = GetSaveStatePath(program_id, slot);
     if (!FileUtil::CreateFullPath(path)) {
         throw std::runtime_error("Could not create path " + path);
     }
 
-    FileUtil::IOFile file(path, "wb");
+    // Write to a temporary file first so that a failed save leaves the slot as it was
+    const auto temp_path = path + ".tmp";
+    FileUtil::IOFile file(temp_path, "wb");
     if (!file) {
-        throw std::runtime_error("Could not open file " + path);
+        throw std::runtime_error("Could not open file " + temp_path);
     }
 
-    CSTHeader header{};
-    header.filetype = header_magic_bytes;
-    header.program_id = title_id;
-    std::string rev_bytes;
-    CryptoPP::StringSource(Common::g_scm_rev, true,
-                           new CryptoPP::HexDecoder(new CryptoPP::StringSink(rev_bytes)));
-    std::memcpy(header.revision.data(), rev_bytes.data(), sizeof(header.revision));
-    header.time = std::chrono::duration_cast<std::chrono::seconds>(
-                      std::chrono::system_clock::now().time_since_epoch())
-                      .count();
+    bool new_base = false;
+    try {
+        CSTHeader header = MakeSaveStateHeader(header_magic_bytes, program_id);
+        // Incremental save states store the RAM on their own, after the compressed system. The
+        // header and the size of the system are filled in once everything else is written.
+        u64_le system_size = 0;
+        if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
+            (incremental &&
+             file.WriteBytes(&system_size, sizeof(system_size)) != sizeof(system_size))) {
+            throw std::runtime_error("Could not write to file " + temp_path);
+        }
+        const u64 system_offset = file.Tell();
 
-    if (file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
-        file.WriteBytes(buffer.data(), buffer.size()) != buffer.size()) {
-        throw std::runtime_error("Could not write to file " + path);
+        {
+            Common::Compression::ZstdCompressStreamBuffer buffer{
+                file, Common::Compression::ZSTD_DEFAULT_COMPRESSION_LEVEL,
+                GetCompressionWorkers()};
+            write_system(buffer);
+            if (!buffer.Finish()) {
+                throw std::runtime_error("Could not write to file " + temp_path);
+            }
+        }
+
+        if (incremental) {
+            system_size = file.Tell() - system_offset;
+            const RamDelta ram_delta = BuildRamDelta(program_id, get_ram());
+            header.base_id = ram_delta.base_id;
+            if (file.WriteBytes(ram_delta.data.data(), ram_delta.data.size()) !=
+                    ram_delta.data.size() ||
+                !file.Seek(0, SEEK_SET) ||
+                file.WriteBytes(&header, sizeof(header)) != sizeof(header) ||
+                file.WriteBytes(&system_size, sizeof(system_size)) != sizeof(system_size)) {
+                throw std::runtime_error("Could not write to file " + temp_path);
+            }
+            new_base = ram_delta.new_base;
+        }
+        if (!file.Close()) {
+            throw std::runtime_error("Could not write to file " + temp_path);
+        }
+    } catch (...) {
+        file.Close();
+        FileUtil::Delete(temp_path);
+        throw;
+    }
+
+    // The slot keeps either the old or the new save state, even if Citra stops right here
+    if (!FileUtil::Replace(temp_path, path)) {
+        throw std::runtime_error("Could not replace " + path);
+    }
+    if (new_base) {
+        DeleteUnusedSaveStateBases(program_id);
     }
 }
 
+namespace {
+
+/// Stream buffer writing into a vector, which grows as needed
+class VectorWriteBuffer final : public std::streambuf {
+public:
+    explicit VectorWriteBuffer(std::vector<char>& buffer_) : buffer{buffer_} {
+        buffer.resize(0x100000);
+        setp(buffer.data(), buffer.data() + buffer.size());
+    }
+
+    [[nodiscard]] std::size_t Size() const {
+        return static_cast<std::size_t>(pptr() - pbase());
+    }
+
+protected:
+    int_type overflow(int_type ch) override {
+        Grow(1);
+        if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+        }
+        return traits_type::not_eof(ch);
+    }
+
+    std::streamsize xsputn(const char* data, std::streamsize count) override {
+        const auto length = static_cast<std::size_t>(count);
+        if (static_cast<std::size_t>(epptr() - pptr()) < length) {
+            Grow(length);
+        }
+        std::memcpy(pptr(), data, length);
+        pbump(static_cast<int>(count));
+        return count;
+    }
+
+private:
+    void Grow(std::size_t length) {
+        const std::size_t size = Size();
+        buffer.resize(std::max(buffer.size() * 2, size + length));
+        setp(buffer.data(), buffer.data() + buffer.size());
+        pbump(static_cast<int>(size));
+    }
+
+    std::vector<char>& buffer;
+};
+
+} // Anonymous namespace
+
+void System::StartSaveState(u32 slot) {
+    FinishSaveState();
+
+    // Only copying the state stops emulation, compressing and writing it happens in the
+    // background. Full save states serialize the RAM along with the system, incremental ones
+    // copy it on its own to compare it against their base.
+    const bool incremental = Settings::values.incremental_save_states;
+    std::vector<char> system_state;
+    std::size_t system_size;
+    {
+        memory->SetSerializeRamContents(!incremental);
+        SCOPE_EXIT({ memory->SetSerializeRamContents(true); });
+        VectorWriteBuffer buffer{system_state};
+        {
+            oarchive oa{buffer};
+            oa&* this;
+        }
+        system_size = buffer.Size();
+    }
+
+    std::vector<u8> ram_copy;
+    std::vector<std::span<u8>> ram;
+    if (incremental) {
+        const auto regions = memory->GetSaveStateRam();
+        std::size_t ram_size = 0;
+        for (const auto& region : regions) {
+            ram_size += region.size();
+        }
+        ram_copy.resize(ram_size);
+        u8* region_data = ram_copy.data();
+        for (const auto& region : regions) {
+            std::memcpy(region_data, region.data(), region.size());
+            ram.emplace_back(region_data, region.size());
+            region_data += region.size();
+        }
+    }
+
+    save_state_task = std::async(
+        std::launch::async,
+        [program_id = title_id, slot, incremental, system_state = std::move(system_state),
+         system_size, ram_copy = std::move(ram_copy), ram = std::move(ram),
+         callback = save_state_callback] {
+            try {
+                WriteSaveState(
+                    program_id, slot, incremental,
+                    [&](std::streambuf& buffer) {
+                        const auto size = static_cast<std::streamsize>(system_size);
+                        if (buffer.sputn(system_state.data(), size) != size) {
+                            throw std::runtime_error("Could not compress the save state");
+                        }
+                    },
+                    [&ram] { return ram; });
+            } catch (...) {
+                callback(slot, false);
+                throw;
+            }
+            LOG_INFO(Core, "Save to slot {} completed", slot);
+            callback(slot, true);
+        });
+}
+
+void System::FinishSaveState() {
+    if (save_state_task.valid()) {
+        // Rethrows whatever failed while writing
+        save_state_task.get();
+    }
+}
+
+bool System::IsSaveStateFinished() const {
+    return !save_state_task.valid() ||
+           save_state_task.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void System::SetSaveStateCallback(std::function<void(u32 slot, bool success)> callback) {
+    save_state_callback = std::move(callback);
+}
+
+void System::CaptureRewindSnapshot() {
+    try {
+        rewind_buffer->Capture(timing->GetGlobalTicks(), [this](std::ostream& stream) {
+            memory->SetSerializeRamContents(false);
+            SCOPE_EXIT({ memory->SetSerializeRamContents(true); });
+            oarchive oa{stream};
+            oa&* this;
+            return memory->GetSaveStateRam();
+        });
+    } catch (const std::exception& e) {
+        // Whatever failed would fail again on the next snapshot
+        LOG_ERROR(Core, "Error capturing a rewind snapshot, disabling rewind: {}", e.what());
+        rewind_buffer.reset();
+    }
+}
+
+bool System::Rewind() {
+    if (Network::GetRoomMember().lock()->IsConnected()) {
+        throw std::runtime_error("Unable to rewind while connected to multiplayer");
+    }
+
+    const bool rewound = rewind_buffer && rewind_buffer->Rewind([this](std::istream& stream) {
+        iarchive ia{stream};
+        ia&* this;
+        return memory->GetSaveStateRam();
+    });
+    if (rewound) {
+        Memory::RasterizerClearAll(false);
+    }
+    return rewound;
+}
+
 void System::LoadState(u32 slot) {
     if (Network::GetRoomMember().lock()->IsConnected()) {
         throw std::runtime_error("Unable to load while connected to multiplayer");
     }
+    // The slot might still be written, and the incremental save state base might change
+    FinishSaveState();
 
     const auto path = GetSaveStatePath(title_id, slot);
 
-    std::vector<u8> decompressed;
-    {
-        std::vector<u8> buffer(FileUtil::GetSize(path) - sizeof(CSTHeader));
+    FileUtil::IOFile file(path, "rb");
+    CSTHeader header;
+    if (file.GetSize() < sizeof(header) ||
+        file.ReadBytes(&header, sizeof(header)) != sizeof(header)) {
+        throw std::runtime_error("Could not read from file at " + path);
+    }
+    u64 system_size = file.GetSize() - sizeof(header);
 
-        FileUtil::IOFile file(path, "rb");
-        file.Seek(sizeof(CSTHeader), SEEK_SET); // Skip header
-        if (file.ReadBytes(buffer.data(), buffer.size()) != buffer.size()) {
+    FileUtil::IOFile base_file;
+    std::vector<u8> ram_delta;
+    if (header.base_id != 0) {
+        u64_le stored_size;
+        if (file.ReadBytes(&stored_size, sizeof(stored_size)) != sizeof(stored_size) ||
+            system_size - sizeof(stored_size) < stored_size) {
+            throw std::runtime_error("Save state is truncated " + path);
+        }
+        const u64 system_offset = file.Tell();
+        ram_delta.resize(system_size - sizeof(stored_size) - stored_size);
+        system_size = stored_size;
+        if (!file.Seek(system_offset + system_size, SEEK_SET) ||
+            file.ReadBytes(ram_delta.data(), ram_delta.size()) != ram_delta.size() ||
+            !file.Seek(system_offset, SEEK_SET)) {
             throw std::runtime_error("Could not read from file at " + path);
         }
-        decompressed = Common::Compression::DecompressDataZSTD(buffer);
+
+        // Make sure the base is there before touching the running system
+        const auto base_path = GetSaveStateBasePath(title_id, header.base_id);
+        base_file = FileUtil::IOFile(base_path, "rb");
+        CSTHeader base_header;
+        if (base_file.GetSize() < sizeof(base_header) ||
+            base_file.ReadBytes(&base_header, sizeof(base_header)) != sizeof(base_header) ||
+            base_header.filetype != base_magic_bytes || base_header.base_id != header.base_id) {
+            throw std::runtime_error("Missing or invalid save state base " + base_path);
+        }
     }
-    std::istringstream sstream{
-        std::string{reinterpret_cast<char*>(decompressed.data()), decompressed.size()},
-        std::ios_base::binary};
-    decompressed.clear();
 
-    // Deserialize
-    iarchive ia{sstream};
-    ia&* this;
+    // Deserialize straight from the decompressor, which reads the file as it goes
+    {
+        Common::Compression::ZstdDecompressStreamBuffer buffer{file, system_size};
+        iarchive ia{buffer};
+        ia&* this;
+    }
+
+    if (header.base_id != 0) {
+        LoadRamDelta(title_id, header.base_id, base_file, ram_delta, memory->GetSaveStateRam());
+        Memory::RasterizerClearAll(false);
+    }
 }
 
 } // namespace Core
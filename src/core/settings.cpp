@@ -90,6 +90,8 @@ void LogSettings() {
     LogSetting("Renderer_UseFrameLimitAlternate", values.use_frame_limit_alternate);
     LogSetting("Renderer_FrameLimitAlternate", values.frame_limit_alternate);
     LogSetting("Renderer_VSyncNew", values.use_vsync_new);
+    LogSetting("Renderer_FramesInFlight", values.frames_in_flight);
+    LogSetting("Renderer_VRAMBudget", values.vram_budget);
     LogSetting("Renderer_PostProcessingShader", values.pp_shader_name);
     LogSetting("Renderer_FilterMode", values.filter_mode);
     LogSetting("Renderer_TextureFilterName", values.texture_filter_name);
@@ -119,6 +121,10 @@ void LogSettings() {
     LogSetting("Camera_OuterLeftConfig", values.camera_config[OuterLeftCamera]);
     LogSetting("Camera_OuterLeftFlip", values.camera_flip[OuterLeftCamera]);
     LogSetting("DataStorage_UseVirtualSd", values.use_virtual_sd);
+    LogSetting("DataStorage_IncrementalSaveStates", values.incremental_save_states);
+    LogSetting("DataStorage_EnableRewind", values.enable_rewind);
+    LogSetting("DataStorage_RewindInterval", values.rewind_interval);
+    LogSetting("DataStorage_RewindBufferSize", values.rewind_buffer_size);
     LogSetting("DataStorage_SdmcDir", FileUtil::GetUserPath(FileUtil::UserPath::SDMCDir));
     LogSetting("DataStorage_NandDir", FileUtil::GetUserPath(FileUtil::UserPath::NANDDir));
     LogSetting("System_IsNew3ds", values.is_new_3ds);
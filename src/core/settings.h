@@ -161,6 +161,10 @@ struct Values {
 
     // Data Storage
     bool use_virtual_sd;
+    bool incremental_save_states;
+    bool enable_rewind;
+    u32 rewind_interval;    ///< Emulated frames between two rewind snapshots
+    u32 rewind_buffer_size; ///< Memory the rewind snapshots may take up, in MiB
 
     // System
     int region_value;
@@ -213,6 +217,8 @@ struct Values {
     bool preload_textures;
 
     bool use_vsync_new;
+    u16 frames_in_flight;
+    u16 vram_budget;
 
     // Audio
     bool enable_dsp_lle;
@@ -234,6 +240,7 @@ struct Values {
     bool use_gdbstub;
     u16 gdbstub_port;
     std::string log_filter;
+    bool binary_log;
     std::unordered_map<std::string, bool> lle_modules;
 
     // Video Dumping
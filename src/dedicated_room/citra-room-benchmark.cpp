@@ -0,0 +1,298 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <enet/enet.h>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/scm_rev.h"
+#include "network/network.h"
+#include "network/packet.h"
+#include "network/room.h"
+#include "network/room_member.h"
+#include "network/verify_user.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options]\n"
+                 "Simulates room members exchanging wifi packets and reports the forwarding rate.\n"
+                 "Unless --address is given, the room is hosted in this process on localhost.\n\n"
+                 "-m, --members=N     The number of simulated members, defaults to 8\n"
+                 "-t, --time=SECONDS  The duration of the measurement, defaults to 10\n"
+                 "-s, --size=BYTES    The payload size of each packet, defaults to 512\n"
+                 "-w, --window=N      The number of packets in flight, defaults to 256\n"
+                 "-b, --broadcast     Send broadcast packets instead of unicast ones\n"
+                 "-a, --address=HOST  Connect to an already running room on HOST\n"
+                 "-p, --port=PORT     The port of the room\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra room benchmark " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << " Libnetwork: " << Network::network_version << std::endl;
+}
+
+namespace {
+
+struct SimulatedMember {
+    ENetPeer* peer = nullptr;
+    Network::MacAddress mac_address{};
+};
+
+/// Services the client host, calling the handler for every received packet
+template <typename Handler>
+void ServiceClients(ENetHost* client, u32 timeout, Handler&& handler) {
+    ENetEvent event;
+    if (enet_host_service(client, &event, timeout) <= 0) {
+        return;
+    }
+    do {
+        if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+            handler(event);
+            enet_packet_destroy(event.packet);
+        }
+    } while (enet_host_check_events(client, &event) > 0);
+}
+
+/// Builds the serialized wifi packet a member sends to the given destination
+std::vector<u8> BuildWifiPacket(const Network::MacAddress& transmitter,
+                                const Network::MacAddress& destination, std::size_t size) {
+    Network::Packet packet;
+    packet << static_cast<u8>(Network::IdWifiPacket);
+    packet << static_cast<u8>(Network::WifiPacket::PacketType::Data);
+    packet << static_cast<u8>(1); // Channel
+    packet << transmitter;
+    packet << destination;
+    packet << std::vector<u8>(size, 0xAA);
+
+    const auto* data = static_cast<const u8*>(packet.GetData());
+    return {data, data + packet.GetDataSize()};
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    u32 num_members = 8;
+    u32 duration = 10;
+    std::size_t payload_size = 512;
+    std::size_t window = 256;
+    bool broadcast = false;
+    std::string address;
+    u16 port = Network::DefaultRoomPort;
+
+    static struct option long_options[] = {
+        {"members", required_argument, 0, 'm'},
+        {"time", required_argument, 0, 't'},
+        {"size", required_argument, 0, 's'},
+        {"window", required_argument, 0, 'w'},
+        {"broadcast", no_argument, 0, 'b'},
+        {"address", required_argument, 0, 'a'},
+        {"port", required_argument, 0, 'p'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "m:t:s:w:ba:p:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'm':
+                num_members = strtoul(optarg, &endarg, 0);
+                break;
+            case 't':
+                duration = strtoul(optarg, &endarg, 0);
+                break;
+            case 's':
+                payload_size = strtoul(optarg, &endarg, 0);
+                break;
+            case 'w':
+                window = strtoul(optarg, &endarg, 0);
+                break;
+            case 'b':
+                broadcast = true;
+                break;
+            case 'a':
+                address.assign(optarg);
+                break;
+            case 'p':
+                port = static_cast<u16>(strtoul(optarg, &endarg, 0));
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            optind++;
+        }
+    }
+
+    if (num_members < 2 || num_members > Network::MaxConcurrentConnections) {
+        std::cout << "members needs to be in the range 2 - " << Network::MaxConcurrentConnections
+                  << "!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    if (!Network::Init()) {
+        return -1;
+    }
+
+    std::shared_ptr<Network::Room> room;
+    if (address.empty()) {
+        address = "127.0.0.1";
+        room = Network::GetRoom().lock();
+        if (!room || !room->Create("Benchmark", "", address, port, "", num_members, "", "", 0,
+                                   std::make_unique<Network::VerifyUser::NullBackend>())) {
+            std::cout << "Failed to create the room on port " << port << "\n";
+            Network::Shutdown();
+            return -1;
+        }
+    }
+
+    ENetHost* client = enet_host_create(nullptr, num_members, Network::NumChannels, 0, 0);
+    if (!client) {
+        std::cout << "Failed to create the client host\n";
+        Network::Shutdown();
+        return -1;
+    }
+
+    ENetAddress room_address;
+    enet_address_set_host(&room_address, address.c_str());
+    room_address.port = port;
+
+    std::vector<SimulatedMember> members(num_members);
+    for (auto& member : members) {
+        member.peer = enet_host_connect(client, &room_address, Network::NumChannels, 0);
+        member.peer->data = &member;
+    }
+
+    // Wait for every connection and join the room with each member
+    u32 num_connected = 0;
+    u32 num_joined = 0;
+    const auto join_deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+    while (num_joined < num_members && std::chrono::steady_clock::now() < join_deadline) {
+        ENetEvent event;
+        if (enet_host_service(client, &event, 16) <= 0) {
+            continue;
+        }
+        auto& member = *static_cast<SimulatedMember*>(event.peer->data);
+        if (event.type == ENET_EVENT_TYPE_CONNECT) {
+            Network::Packet packet;
+            packet << static_cast<u8>(Network::IdJoinRequest);
+            packet << fmt::format("bench-{:03}", num_connected);
+            packet << fmt::format("bench-console-{}", num_connected);
+            packet << Network::NoPreferredMac;
+            packet << Network::network_version;
+            packet << std::string{};
+            packet << std::string{};
+            enet_peer_send(member.peer, 0,
+                           enet_packet_create(packet.GetData(), packet.GetDataSize(),
+                                              ENET_PACKET_FLAG_RELIABLE));
+            num_connected++;
+        } else if (event.type == ENET_EVENT_TYPE_RECEIVE) {
+            const u8 type = event.packet->data[0];
+            if (type == Network::IdJoinSuccess || type == Network::IdJoinSuccessAsMod) {
+                Network::Packet packet;
+                packet.Append(event.packet->data, event.packet->dataLength);
+                packet.IgnoreBytes(sizeof(u8));
+                packet >> member.mac_address;
+                num_joined++;
+            }
+            enet_packet_destroy(event.packet);
+        }
+    }
+
+    if (num_joined < num_members) {
+        std::cout << "Only " << num_joined << " of " << num_members << " members could join\n";
+        enet_host_destroy(client);
+        Network::Shutdown();
+        return -1;
+    }
+
+    // Each member sends to the next one, or to everyone else when broadcasting
+    std::vector<std::vector<u8>> payloads(num_members);
+    for (u32 i = 0; i < num_members; i++) {
+        const auto& destination =
+            broadcast ? Network::BroadcastMac : members[(i + 1) % num_members].mac_address;
+        payloads[i] = BuildWifiPacket(members[i].mac_address, destination, payload_size);
+    }
+    const u64 fanout = broadcast ? num_members - 1 : 1;
+    window = std::max<std::size_t>(window, fanout);
+
+    u64 sent = 0;
+    u64 received = 0;
+    u64 received_bytes = 0;
+    const auto CountPacket = [&](const ENetEvent& event) {
+        if (event.packet->data[0] == Network::IdWifiPacket) {
+            received++;
+            received_bytes += event.packet->dataLength;
+        }
+    };
+
+    const std::clock_t cpu_start = std::clock();
+    const auto start_time = std::chrono::steady_clock::now();
+    const auto end_time = start_time + std::chrono::seconds(duration);
+    u32 next_member = 0;
+    while (std::chrono::steady_clock::now() < end_time) {
+        // Keep a bounded number of packets in flight so the measurement isn't limited by the
+        // reliable send queues growing without end
+        while ((sent * fanout) - received + fanout <= window) {
+            const auto& payload = payloads[next_member];
+            enet_peer_send(
+                members[next_member].peer, 0,
+                enet_packet_create(payload.data(), payload.size(), ENET_PACKET_FLAG_RELIABLE));
+            next_member = (next_member + 1) % num_members;
+            sent++;
+        }
+        enet_host_flush(client);
+        ServiceClients(client, 1, CountPacket);
+    }
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+    const double cpu_time = static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+
+    std::cout << fmt::format("members:            {}\n"
+                             "mode:               {}\n"
+                             "payload:            {} bytes\n"
+                             "sent:               {} packets\n"
+                             "forwarded:          {} packets\n"
+                             "forwarding rate:    {:.0f} packets/s, {:.2f} MiB/s\n",
+                             num_members, broadcast ? "broadcast" : "unicast", payload_size, sent,
+                             received, received / elapsed.count(),
+                             received_bytes / elapsed.count() / (1024.0 * 1024.0));
+    if (room) {
+        // The process time covers both the room and the simulated members
+        std::cout << fmt::format("process CPU time:   {:.2f}s\n"
+                                 "per core:           {:.0f} packets/s\n",
+                                 cpu_time, cpu_time > 0.0 ? received / cpu_time : 0.0);
+    }
+
+    for (auto& member : members) {
+        enet_peer_disconnect(member.peer, 0);
+    }
+    enet_host_flush(client);
+    enet_host_destroy(client);
+    Network::Shutdown();
+    return 0;
+}
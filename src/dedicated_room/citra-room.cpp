@@ -2,6 +2,7 @@
 // Licensed under GPLv2 or any later version
 // Refer to the license.txt file included.
 
+#include <algorithm>
 #include <chrono>
 #include <fstream>
 #include <iostream>
@@ -9,6 +10,7 @@
 #include <regex>
 #include <string>
 #include <thread>
+#include <vector>
 #include <cryptopp/base64.h>
 
 #ifdef _WIN32
@@ -30,6 +32,7 @@
 #include "network/network.h"
 #include "network/network_settings.h"
 #include "network/room.h"
+#include "network/room_pool.h"
 #include "network/verify_user.h"
 
 #ifdef ENABLE_WEB_SERVICE
@@ -58,6 +61,8 @@ static void PrintHelp(const char* argv0) {
                  "--ban-list-file     The file for storing the room ban list\n"
                  "--log-file          The file for storing the room log\n"
                  "--enable-citra-mods Allow Citra Community Moderators to moderate on your room\n"
+                 "--rooms             Host this many private rooms on consecutive ports\n"
+                 "--threads           The number of threads servicing the rooms\n"
                  "-h, --help          Display this help and exit\n"
                  "-v, --version       Output version information and exit\n";
 }
@@ -150,6 +155,58 @@ static void SaveBanList(const Network::Room::BanList& ban_list, const std::strin
     file.flush();
 }
 
+static void PrintRoomStats(const std::vector<std::shared_ptr<Network::Room>>& rooms) {
+    for (const auto& room : rooms) {
+        const auto& info = room->GetRoomInformation();
+        const auto stats = room->GetStats();
+        std::cout << info.name << " (port " << info.port << "): " << stats.members << "/"
+                  << info.member_slots << " members, " << stats.packets_received
+                  << " packets received (" << stats.bytes_received << " bytes), "
+                  << stats.packets_forwarded << " packets forwarded\n";
+    }
+    std::cout << std::endl;
+}
+
+/// Hosts the rooms of a multi-room process until Q+Enter is entered
+static int HostRoomPool(const std::string& room_name, const std::string& room_description,
+                        u32 port, u32 num_rooms, u32 num_threads, const std::string& password,
+                        u32 max_members, const std::string& preferred_game, u64 preferred_game_id,
+                        std::shared_ptr<Network::VerifyUser::Backend> verify_backend,
+                        const Network::Room::BanList& ban_list, const std::string& ban_list_file,
+                        bool enable_citra_mods) {
+    Network::RoomPool pool(num_threads, std::move(verify_backend), ban_list);
+    for (u32 i = 0; i < num_rooms; i++) {
+        const std::string name = room_name + " " + std::to_string(i + 1);
+        if (!pool.CreateRoom(name, room_description, "", static_cast<u16>(port + i), password,
+                             max_members, "", preferred_game, preferred_game_id,
+                             enable_citra_mods)) {
+            std::cout << "Failed to create room on port " << port + i << "\n\n";
+            return -1;
+        }
+    }
+
+    std::cout << num_rooms << " rooms are open on ports " << port << " - " << port + num_rooms - 1
+              << " using " << num_threads << " threads.\n"
+              << "Show statistics with S+Enter, close with Q+Enter...\n\n";
+    while (true) {
+        std::string in;
+        std::cin >> in;
+        if (in == "S" || in == "s") {
+            PrintRoomStats(pool.GetRooms());
+        } else if (in.size() > 0) {
+            break;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    // Save the ban list
+    if (!ban_list_file.empty()) {
+        SaveBanList(pool.GetBanList(), ban_list_file);
+    }
+    pool.Destroy();
+    return 0;
+}
+
 static void InitializeLogging(const std::string& log_file) {
     Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
 
@@ -181,6 +238,8 @@ int main(int argc, char** argv) {
     u32 port = Network::DefaultRoomPort;
     u32 max_members = 16;
     bool enable_citra_mods = false;
+    u32 num_rooms = 1;
+    u32 num_threads = std::max(1U, std::thread::hardware_concurrency());
 
     static struct option long_options[] = {
         {"room-name", required_argument, 0, 'n'},
@@ -196,13 +255,16 @@ int main(int argc, char** argv) {
         {"ban-list-file", required_argument, 0, 'b'},
         {"log-file", required_argument, 0, 'l'},
         {"enable-citra-mods", no_argument, 0, 'e'},
+        {"rooms", required_argument, 0, 'r'},
+        {"threads", required_argument, 0, 'j'},
         {"help", no_argument, 0, 'h'},
         {"version", no_argument, 0, 'v'},
         {0, 0, 0, 0},
     };
 
     while (optind < argc) {
-        int arg = getopt_long(argc, argv, "n:d:p:m:w:g:u:t:a:i:l:hv", long_options, &option_index);
+        int arg =
+            getopt_long(argc, argv, "n:d:p:m:w:g:u:t:a:i:l:r:j:hv", long_options, &option_index);
         if (arg != -1) {
             switch (static_cast<char>(arg)) {
             case 'n':
@@ -244,6 +306,12 @@ int main(int argc, char** argv) {
             case 'e':
                 enable_citra_mods = true;
                 break;
+            case 'r':
+                num_rooms = strtoul(optarg, &endarg, 0);
+                break;
+            case 'j':
+                num_threads = std::max<u32>(1, strtoul(optarg, &endarg, 0));
+                break;
             case 'h':
                 PrintHelp(argv[0]);
                 return 0;
@@ -279,11 +347,21 @@ int main(int argc, char** argv) {
         PrintHelp(argv[0]);
         return -1;
     }
+    if (num_rooms == 0 || port + num_rooms - 1 > 65535) {
+        std::cout << "rooms needs to be at least 1 and the last port at most 65535!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
     if (ban_list_file.empty()) {
         std::cout << "Ban list file not set!\nThis should get set to load and save room ban "
                      "list.\nSet with --ban-list-file <file>\n\n";
     }
     bool announce = true;
+    if (num_rooms > 1 && announce) {
+        // The announce session only knows about the room of Network::GetRoom
+        announce = false;
+        std::cout << "Hosting multiple rooms: Hosting private rooms\n\n";
+    }
     if (token.empty() && announce) {
         announce = false;
         std::cout << "token is empty: Hosting a private room\n\n";
@@ -334,6 +412,15 @@ int main(int argc, char** argv) {
     }
 
     Network::Init();
+    if (num_rooms > 1) {
+        const int result =
+            HostRoomPool(room_name, room_description, port, num_rooms, num_threads, password,
+                         max_members, preferred_game, preferred_game_id, std::move(verify_backend),
+                         ban_list, ban_list_file, enable_citra_mods);
+        Network::Shutdown();
+        detached_tasks.WaitForAllTasks();
+        return result;
+    }
     if (std::shared_ptr<Network::Room> room = Network::GetRoom().lock()) {
         if (!room->Create(room_name, room_description, "", port, password, max_members, username,
                           preferred_game, preferred_game_id, std::move(verify_backend), ban_list,
@@ -0,0 +1,303 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <fmt/format.h>
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/logging/record.h"
+#include "common/logging/text_formatter.h"
+#include "common/scm_rev.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <binary log>\n"
+                 "       "
+              << argv0
+              << " --benchmark\n"
+                 "Converts a binary log written by Citra to text. Logs cut short by a crash are\n"
+                 "converted up to the last complete message.\n\n"
+                 "-o, --output=FILE   Write the text to FILE instead of the standard output\n"
+                 "-f, --filter=FILTER Only convert the messages passing FILTER, e.g. *:Info\n"
+                 "-b, --benchmark     Measure the throughput of logging\n"
+                 "-j, --jobs=N        Number of threads logging in the benchmark, defaults to 1\n"
+                 "-d, --drop          Drop the messages the log can not keep up with\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra log dump tool " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+namespace {
+
+/// Converts a binary log to text, returns false if the log is not a binary log
+bool Dump(const std::vector<u8>& log, const Log::Filter& filter, std::ostream& output) {
+    Log::BinaryLogHeader header;
+    if (log.size() < sizeof(header)) {
+        return false;
+    }
+    std::memcpy(&header, log.data(), sizeof(header));
+    if (header.magic != Log::BINARY_LOG_MAGIC || header.version != Log::BINARY_LOG_VERSION) {
+        return false;
+    }
+
+    std::unordered_map<u64, std::string> strings;
+    const auto GetString = [&strings](u64 address) -> const char* {
+        const auto it = strings.find(address);
+        return it == strings.end() ? "<unknown>" : it->second.c_str();
+    };
+
+    std::size_t offset = sizeof(header);
+    while (offset < log.size()) {
+        // Both headers start with the size, followed by the class
+        Log::StringHeader string_header;
+        if (log.size() - offset < sizeof(string_header)) {
+            break;
+        }
+        std::memcpy(&string_header, log.data() + offset, sizeof(string_header));
+        const std::size_t size = string_header.size;
+        if (size < sizeof(string_header) || log.size() - offset < size) {
+            break;
+        }
+
+        if (string_header.marker == Log::Class::Count) {
+            const auto* const characters =
+                reinterpret_cast<const char*>(log.data() + offset + sizeof(string_header));
+            // The characters are padded with zeros
+            strings[string_header.address] = std::string(
+                characters, strnlen(characters, size - sizeof(string_header)));
+        } else {
+            Log::RecordHeader record;
+            if (size < sizeof(record)) {
+                break;
+            }
+            std::memcpy(&record, log.data() + offset, sizeof(record));
+            if (filter.CheckMessage(record.log_class, record.log_level)) {
+                Log::Entry entry;
+                entry.timestamp = std::chrono::microseconds{record.timestamp};
+                entry.log_class = record.log_class;
+                entry.log_level = record.log_level;
+                entry.filename = GetString(record.filename);
+                entry.line_num = record.line_num;
+                entry.function = GetString(record.function);
+                entry.message = Log::FormatRecordMessage(
+                    GetString(record.format), record.num_args,
+                    {log.data() + offset + sizeof(record), size - sizeof(record)});
+                output << Log::FormatLogMessage(entry) << '\n';
+            }
+        }
+        offset += size;
+    }
+
+    if (offset != log.size()) {
+        output << "<the log ends with an incomplete message>\n";
+    }
+    return true;
+}
+
+/// Counts the messages reaching the logging backends
+class CountingBackend : public Log::Backend {
+public:
+    explicit CountingBackend(std::atomic<u64>& count) : count{count} {}
+
+    static const char* Name() {
+        return "counting";
+    }
+
+    const char* GetName() const override {
+        return Name();
+    }
+
+    void Write(const Log::Entry& entry) override {
+        if (entry.log_class == Log::Class::Frontend) {
+            count.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<u64>& count;
+};
+
+/// Measures how long logging a message stops the calling thread, and how many make it through
+void Benchmark(std::size_t num_threads, bool drop_when_full) {
+    constexpr u64 MessagesPerThread = 1000000;
+
+    Log::SetDropWhenFull(drop_when_full);
+
+    Log::Filter filter(Log::Level::Info);
+    filter.SetClassLevel(Log::Class::Frontend, Log::Level::Debug);
+    Log::SetGlobalFilter(filter);
+    std::atomic<u64> written = 0;
+    Log::AddBackend(std::make_unique<CountingBackend>(written));
+
+    const auto RunThreads = [num_threads](const auto& function) {
+        const auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> threads(num_threads);
+        for (std::size_t i = 0; i < num_threads; i++) {
+            threads[i] = std::thread(function, static_cast<u32>(i));
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        const std::chrono::duration<double, std::nano> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return elapsed.count() / MessagesPerThread;
+    };
+
+    // What logging cost the calling thread when it formatted every message itself
+    std::atomic<std::size_t> total_length = 0;
+    const double format_time = RunThreads([&total_length](u32 thread) {
+        std::size_t length = 0;
+        for (u64 i = 0; i < MessagesPerThread; i++) {
+            length += fmt::format("Message {} from thread {}: {:08X} {}", i, thread,
+                                  i * 0x9E3779B9, "benchmark")
+                          .size();
+        }
+        total_length += length;
+    });
+
+    const auto start = std::chrono::steady_clock::now();
+    const double log_time = RunThreads([](u32 thread) {
+        for (u64 i = 0; i < MessagesPerThread; i++) {
+            LOG_DEBUG(Frontend, "Message {} from thread {}: {:08X} {}", i, thread,
+                      i * 0x9E3779B9, "benchmark");
+        }
+    });
+
+    // Wait for the logging thread to catch up
+    u64 last_written = 0;
+    do {
+        last_written = written;
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    } while (written != last_written);
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start - std::chrono::milliseconds(100);
+
+    const u64 logged = MessagesPerThread * num_threads;
+    std::cout << fmt::format("{} threads logging {} messages each\n"
+                             "  formatting on the caller: {:.1f} ns/message\n"
+                             "  logging:                  {:.1f} ns/message\n"
+                             "  written:                  {} messages ({:.1f}%), "
+                             "{:.0f} messages/s\n",
+                             num_threads, MessagesPerThread, format_time, log_time, written.load(),
+                             100.0 * written / logged, written / elapsed.count());
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    std::string output_path;
+    std::string filter_string = "*:Trace";
+    std::size_t num_threads = 1;
+    bool benchmark = false;
+    bool drop_when_full = false;
+
+    static struct option long_options[] = {
+        {"output", required_argument, 0, 'o'},
+        {"filter", required_argument, 0, 'f'},
+        {"benchmark", no_argument, 0, 'b'},
+        {"jobs", required_argument, 0, 'j'},
+        {"drop", no_argument, 0, 'd'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    std::vector<std::string> paths;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "o:f:bj:dhv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'o':
+                output_path = optarg;
+                break;
+            case 'f':
+                filter_string = optarg;
+                break;
+            case 'b':
+                benchmark = true;
+                break;
+            case 'j':
+                num_threads = std::max<std::size_t>(1, strtoul(optarg, &endarg, 0));
+                break;
+            case 'd':
+                drop_when_full = true;
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            paths.emplace_back(argv[optind]);
+            optind++;
+        }
+    }
+
+    if (benchmark) {
+        Benchmark(num_threads, drop_when_full);
+        return 0;
+    }
+
+    if (paths.size() != 1) {
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    FileUtil::IOFile input(paths[0], "rb");
+    if (!input.IsOpen()) {
+        std::cout << "Failed to open " << paths[0] << "\n";
+        return -1;
+    }
+    std::vector<u8> log(input.GetSize());
+    if (input.ReadBytes(log.data(), log.size()) != log.size()) {
+        std::cout << "Failed to read " << paths[0] << "\n";
+        return -1;
+    }
+
+    std::ofstream output_file;
+    if (!output_path.empty()) {
+        OpenFStream(output_file, output_path, std::ios_base::out);
+        if (!output_file.is_open()) {
+            std::cout << "Failed to create " << output_path << "\n";
+            return -1;
+        }
+    }
+
+    Log::Filter filter;
+    filter.ParseFilterString(filter_string);
+    if (!Dump(log, filter, output_path.empty() ? std::cout : output_file)) {
+        std::cout << paths[0] << " is not a binary log\n";
+        return 1;
+    }
+    return 0;
+}
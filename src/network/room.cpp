@@ -4,12 +4,14 @@
 
 #include <algorithm>
 #include <atomic>
+#include <cstring>
 #include <iomanip>
 #include <mutex>
 #include <random>
 #include <regex>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include "common/logging/log.h"
 #include "enet/enet.h"
 #include "network/packet.h"
@@ -48,9 +50,23 @@ public:
     mutable std::mutex member_mutex; ///< Mutex for locking the members list
     /// This should be a std::shared_mutex as soon as C++17 is supported
 
-    UsernameBanList username_ban_list; ///< List of banned usernames
-    IPBanList ip_ban_list;             ///< List of banned IP addresses
-    mutable std::mutex ban_list_mutex; ///< Mutex for the ban lists
+    struct MacAddressHash {
+        std::size_t operator()(const MacAddress& address) const {
+            u64 value = 0;
+            std::memcpy(&value, address.data(), address.size());
+            return std::hash<u64>{}(value);
+        }
+    };
+    /// Peers of the members indexed by their MAC address, guarded by member_mutex
+    std::unordered_map<MacAddress, ENetPeer*, MacAddressHash> member_peers;
+
+    std::shared_ptr<BanLists> ban_lists; ///< Ban lists, possibly shared with other rooms
+
+    bool pooled = false; ///< Whether the room is serviced by a RoomPool instead of room_thread
+
+    std::atomic<u64> packets_received{0};  ///< Number of packets received from the members
+    std::atomic<u64> bytes_received{0};    ///< Size of the packets received from the members
+    std::atomic<u64> packets_forwarded{0}; ///< Number of wifi packets queued to members
 
     RoomImpl()
         : NintendoOUI{0x00, 0x1F, 0x32, 0x00, 0x00, 0x00}, random_gen(std::random_device()()) {}
@@ -59,12 +75,18 @@ public:
     std::unique_ptr<std::thread> room_thread;
 
     /// Verification backend of the room
-    std::unique_ptr<VerifyUser::Backend> verify_backend;
+    std::shared_ptr<VerifyUser::Backend> verify_backend;
 
     /// Thread function that will receive and dispatch messages until the room is destroyed.
     void ServerLoop();
     void StartLoop();
 
+    /**
+     * Dispatches the events that have been received and flushes the packets sent in response.
+     * @param timeout Maximum time to wait for an event in milliseconds
+     */
+    void ServiceEvents(u32 timeout);
+
     /**
      * Parses and answers a room join request from a client.
      * Validates the uniqueness of the username and assigns the MAC address
@@ -223,10 +245,18 @@ public:
     MacAddress GenerateMacAddress();
 
     /**
-     * Broadcasts this packet to all members except the sender.
+     * Dispatches a packet received from a client.
+     * @param event The ENet event that was received.
+     */
+    void HandlePacket(const ENetEvent* event);
+
+    /**
+     * Forwards this packet to its destination, or to all members except the sender.
+     * The received ENet packet is sent as is without being copied.
      * @param event The ENet event containing the data
+     * @returns Whether the packet was queued, in which case ENet takes ownership of it
      */
-    void HandleWifiPacket(const ENetEvent* event);
+    bool HandleWifiPacket(const ENetEvent* event);
 
     /**
      * Extracts a chat entry from a received ENet packet and adds it to the chat queue.
@@ -250,52 +280,70 @@ public:
 // RoomImpl
 void Room::RoomImpl::ServerLoop() {
     while (state != State::Closed) {
-        ENetEvent event;
-        if (enet_host_service(server, &event, 16) > 0) {
-            switch (event.type) {
-            case ENET_EVENT_TYPE_RECEIVE:
-                switch (event.packet->data[0]) {
-                case IdJoinRequest:
-                    HandleJoinRequest(&event);
-                    break;
-                case IdSetGameInfo:
-                    HandleGameNamePacket(&event);
-                    break;
-                case IdWifiPacket:
-                    HandleWifiPacket(&event);
-                    break;
-                case IdChatMessage:
-                    HandleChatPacket(&event);
-                    break;
-                // Moderation
-                case IdModKick:
-                    HandleModKickPacket(&event);
-                    break;
-                case IdModBan:
-                    HandleModBanPacket(&event);
-                    break;
-                case IdModUnban:
-                    HandleModUnbanPacket(&event);
-                    break;
-                case IdModGetBanList:
-                    HandleModGetBanListPacket(&event);
-                    break;
-                }
-                enet_packet_destroy(event.packet);
-                break;
-            case ENET_EVENT_TYPE_DISCONNECT:
-                HandleClientDisconnection(event.peer);
-                break;
-            case ENET_EVENT_TYPE_NONE:
-            case ENET_EVENT_TYPE_CONNECT:
-                break;
-            }
-        }
+        ServiceEvents(16);
     }
     // Close the connection to all members:
     SendCloseMessage();
 }
 
+void Room::RoomImpl::ServiceEvents(u32 timeout) {
+    ENetEvent event;
+    if (enet_host_service(server, &event, timeout) <= 0) {
+        return;
+    }
+    // Handle every event that has already been received before sending anything, so the
+    // forwarded packets go out together in a single flush
+    do {
+        switch (event.type) {
+        case ENET_EVENT_TYPE_RECEIVE:
+            packets_received.fetch_add(1, std::memory_order_relaxed);
+            bytes_received.fetch_add(event.packet->dataLength, std::memory_order_relaxed);
+            HandlePacket(&event);
+            break;
+        case ENET_EVENT_TYPE_DISCONNECT:
+            HandleClientDisconnection(event.peer);
+            break;
+        case ENET_EVENT_TYPE_NONE:
+        case ENET_EVENT_TYPE_CONNECT:
+            break;
+        }
+    } while (enet_host_check_events(server, &event) > 0);
+    enet_host_flush(server);
+}
+
+void Room::RoomImpl::HandlePacket(const ENetEvent* event) {
+    switch (event->packet->data[0]) {
+    case IdJoinRequest:
+        HandleJoinRequest(event);
+        break;
+    case IdSetGameInfo:
+        HandleGameNamePacket(event);
+        break;
+    case IdWifiPacket:
+        if (HandleWifiPacket(event)) {
+            return;
+        }
+        break;
+    case IdChatMessage:
+        HandleChatPacket(event);
+        break;
+    // Moderation
+    case IdModKick:
+        HandleModKickPacket(event);
+        break;
+    case IdModBan:
+        HandleModBanPacket(event);
+        break;
+    case IdModUnban:
+        HandleModUnbanPacket(event);
+        break;
+    case IdModGetBanList:
+        HandleModGetBanListPacket(event);
+        break;
+    }
+    enet_packet_destroy(event->packet);
+}
+
 void Room::RoomImpl::StartLoop() {
     room_thread = std::make_unique<std::thread>(&Room::RoomImpl::ServerLoop, this);
 }
@@ -376,7 +424,9 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     std::string ip;
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_lists->mutex);
+        auto& username_ban_list = ban_lists->username_ban_list;
+        auto& ip_ban_list = ban_lists->ip_ban_list;
 
         // Check username ban
         if (!member.user_data.username.empty() &&
@@ -403,6 +453,7 @@ void Room::RoomImpl::HandleJoinRequest(const ENetEvent* event) {
 
     {
         std::lock_guard lock(member_mutex);
+        member_peers.emplace(member.mac_address, member.peer);
         members.push_back(std::move(member));
     }
 
@@ -449,6 +500,7 @@ void Room::RoomImpl::HandleModKickPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
+        member_peers.erase(target_member->mac_address);
         members.erase(target_member);
     }
 
@@ -492,11 +544,14 @@ void Room::RoomImpl::HandleModBanPacket(const ENetEvent* event) {
         ip = ip_raw;
 
         enet_peer_disconnect(target_member->peer, 0);
+        member_peers.erase(target_member->mac_address);
         members.erase(target_member);
     }
 
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_lists->mutex);
+        auto& username_ban_list = ban_lists->username_ban_list;
+        auto& ip_ban_list = ban_lists->ip_ban_list;
 
         if (!username.empty()) {
             // Ban the forum username
@@ -533,7 +588,9 @@ void Room::RoomImpl::HandleModUnbanPacket(const ENetEvent* event) {
 
     bool unbanned = false;
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_lists->mutex);
+        auto& username_ban_list = ban_lists->username_ban_list;
+        auto& ip_ban_list = ban_lists->ip_ban_list;
 
         auto it = std::find(username_ban_list.begin(), username_ban_list.end(), address);
         if (it != username_ban_list.end()) {
@@ -579,8 +636,7 @@ bool Room::RoomImpl::IsValidNickname(const std::string& nickname) const {
 bool Room::RoomImpl::IsValidMacAddress(const MacAddress& address) const {
     // A MAC address is valid if it is not already taken by anybody else in the room.
     std::lock_guard lock(member_mutex);
-    return std::all_of(members.begin(), members.end(),
-                       [&address](const auto& member) { return member.mac_address != address; });
+    return member_peers.find(address) == member_peers.end();
 }
 
 bool Room::RoomImpl::IsValidConsoleId(const std::string& console_id_hash) const {
@@ -737,7 +793,9 @@ void Room::RoomImpl::SendModBanListResponse(ENetPeer* client) {
     Packet packet;
     packet << static_cast<u8>(IdModBanListResponse);
     {
-        std::lock_guard lock(ban_list_mutex);
+        std::lock_guard lock(ban_lists->mutex);
+        auto& username_ban_list = ban_lists->username_ban_list;
+        auto& ip_ban_list = ban_lists->ip_ban_list;
         packet << username_ban_list;
         packet << ip_ban_list;
     }
@@ -846,52 +904,48 @@ MacAddress Room::RoomImpl::GenerateMacAddress() {
     return result_mac;
 }
 
-void Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
-    Packet in_packet;
-    in_packet.Append(event->packet->data, event->packet->dataLength);
-    in_packet.IgnoreBytes(sizeof(u8));         // Message type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Type
-    in_packet.IgnoreBytes(sizeof(u8));         // WifiPacket Channel
-    in_packet.IgnoreBytes(sizeof(MacAddress)); // WifiPacket Transmitter Address
+bool Room::RoomImpl::HandleWifiPacket(const ENetEvent* event) {
+    // Message type, WifiPacket type, WifiPacket channel and transmitter address
+    constexpr std::size_t DestinationOffset = 3 * sizeof(u8) + sizeof(MacAddress);
+    ENetPacket* enet_packet = event->packet;
+    if (enet_packet->dataLength < DestinationOffset + sizeof(MacAddress)) {
+        return false;
+    }
     MacAddress destination_address;
-    in_packet >> destination_address;
+    std::memcpy(destination_address.data(), enet_packet->data + DestinationOffset,
+                sizeof(MacAddress));
 
-    Packet out_packet;
-    out_packet.Append(event->packet->data, event->packet->dataLength);
-    ENetPacket* enet_packet = enet_packet_create(out_packet.GetData(), out_packet.GetDataSize(),
-                                                 ENET_PACKET_FLAG_RELIABLE);
+    // The packet is forwarded as it was received, ENet counts its references and frees it once
+    // every destination has acknowledged it
+    enet_packet->flags = ENET_PACKET_FLAG_RELIABLE;
 
+    bool sent_packet = false;
     if (destination_address == BroadcastMac) { // Send the data to everyone except the sender
         std::lock_guard lock(member_mutex);
-        bool sent_packet = false;
         for (const auto& member : members) {
-            if (member.peer != event->peer) {
+            // ENet only takes a reference when the packet could be queued
+            if (member.peer != event->peer && enet_peer_send(member.peer, 0, enet_packet) == 0) {
                 sent_packet = true;
-                enet_peer_send(member.peer, 0, enet_packet);
+                packets_forwarded.fetch_add(1, std::memory_order_relaxed);
             }
         }
-
-        if (!sent_packet) {
-            enet_packet_destroy(enet_packet);
-        }
     } else { // Send the data only to the destination client
         std::lock_guard lock(member_mutex);
-        auto member = std::find_if(members.begin(), members.end(),
-                                   [destination_address](const Member& member) -> bool {
-                                       return member.mac_address == destination_address;
-                                   });
-        if (member != members.end()) {
-            enet_peer_send(member->peer, 0, enet_packet);
+        const auto member = member_peers.find(destination_address);
+        if (member != member_peers.end()) {
+            if (enet_peer_send(member->second, 0, enet_packet) == 0) {
+                sent_packet = true;
+                packets_forwarded.fetch_add(1, std::memory_order_relaxed);
+            }
         } else {
             LOG_ERROR(Network,
                       "Attempting to send to unknown MAC address: "
                       "{:02X}:{:02X}:{:02X}:{:02X}:{:02X}:{:02X}",
                       destination_address[0], destination_address[1], destination_address[2],
                       destination_address[3], destination_address[4], destination_address[5]);
-            enet_packet_destroy(enet_packet);
         }
     }
-    enet_host_flush(server);
+    return sent_packet;
 }
 
 void Room::RoomImpl::HandleChatPacket(const ENetEvent* event) {
@@ -993,6 +1047,7 @@ void Room::RoomImpl::HandleClientDisconnection(ENetPeer* client) {
             enet_address_get_host_ip(&member->peer->address, ip_raw, sizeof(ip_raw) - 1);
             ip = ip_raw;
 
+            member_peers.erase(member->mac_address);
             members.erase(member);
         }
     }
@@ -1013,7 +1068,7 @@ bool Room::Create(const std::string& name, const std::string& description,
                   const std::string& server_address, u16 server_port, const std::string& password,
                   const u32 max_connections, const std::string& host_username,
                   const std::string& preferred_game, u64 preferred_game_id,
-                  std::unique_ptr<VerifyUser::Backend> verify_backend,
+                  std::shared_ptr<VerifyUser::Backend> verify_backend,
                   const Room::BanList& ban_list, bool enable_citra_mods) {
     ENetAddress address;
     address.host = ENET_HOST_ANY;
@@ -1040,10 +1095,13 @@ bool Room::Create(const std::string& name, const std::string& description,
     room_impl->room_information.enable_citra_mods = enable_citra_mods;
     room_impl->password = password;
     room_impl->verify_backend = std::move(verify_backend);
-    room_impl->username_ban_list = ban_list.first;
-    room_impl->ip_ban_list = ban_list.second;
+    if (!room_impl->pooled) {
+        room_impl->ban_lists = std::make_shared<BanLists>();
+        room_impl->ban_lists->username_ban_list = ban_list.first;
+        room_impl->ban_lists->ip_ban_list = ban_list.second;
 
-    room_impl->StartLoop();
+        room_impl->StartLoop();
+    }
     return true;
 }
 
@@ -1061,8 +1119,8 @@ std::string Room::GetVerifyUID() const {
 }
 
 Room::BanList Room::GetBanList() const {
-    std::lock_guard lock(room_impl->ban_list_mutex);
-    return {room_impl->username_ban_list, room_impl->ip_ban_list};
+    std::lock_guard lock(room_impl->ban_lists->mutex);
+    return {room_impl->ban_lists->username_ban_list, room_impl->ban_lists->ip_ban_list};
 }
 
 std::vector<Room::Member> Room::GetRoomMemberList() const {
@@ -1085,6 +1143,18 @@ bool Room::HasPassword() const {
     return !room_impl->password.empty();
 }
 
+Room::Stats Room::GetStats() const {
+    Stats stats{};
+    {
+        std::lock_guard lock(room_impl->member_mutex);
+        stats.members = static_cast<u32>(room_impl->members.size());
+    }
+    stats.packets_received = room_impl->packets_received.load(std::memory_order_relaxed);
+    stats.bytes_received = room_impl->bytes_received.load(std::memory_order_relaxed);
+    stats.packets_forwarded = room_impl->packets_forwarded.load(std::memory_order_relaxed);
+    return stats;
+}
+
 void Room::SetVerifyUID(const std::string& uid) {
     std::lock_guard lock(room_impl->verify_UID_mutex);
     room_impl->verify_UID = uid;
@@ -1092,8 +1162,13 @@ void Room::SetVerifyUID(const std::string& uid) {
 
 void Room::Destroy() {
     room_impl->state = State::Closed;
-    room_impl->room_thread->join();
-    room_impl->room_thread.reset();
+    if (room_impl->pooled) {
+        // The pool has stopped servicing the room, close it from here
+        room_impl->SendCloseMessage();
+    } else {
+        room_impl->room_thread->join();
+        room_impl->room_thread.reset();
+    }
 
     if (room_impl->server) {
         enet_host_destroy(room_impl->server);
@@ -1103,9 +1178,23 @@ void Room::Destroy() {
     {
         std::lock_guard lock(room_impl->member_mutex);
         room_impl->members.clear();
+        room_impl->member_peers.clear();
     }
     room_impl->room_information.member_slots = 0;
     room_impl->room_information.name.clear();
 }
 
+void Room::SetPooled(std::shared_ptr<BanLists> ban_lists) {
+    room_impl->pooled = true;
+    room_impl->ban_lists = std::move(ban_lists);
+}
+
+void Room::Service() {
+    room_impl->ServiceEvents(0);
+}
+
+_ENetHost* Room::GetHost() const {
+    return room_impl->server;
+}
+
 } // namespace Network
@@ -6,11 +6,14 @@
 
 #include <array>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include "common/common_types.h"
 #include "network/verify_user.h"
 
+struct _ENetHost;
+
 namespace Network {
 
 constexpr u32 network_version = 4; ///< The version of this Room and RoomMember
@@ -104,6 +107,14 @@ public:
         MacAddress mac_address;   ///< The assigned mac address of the member.
     };
 
+    /// Traffic counters of the room
+    struct Stats {
+        u32 members;            ///< Number of members currently in the room
+        u64 packets_received;   ///< Number of packets received from the members
+        u64 bytes_received;     ///< Size of the packets received from the members
+        u64 packets_forwarded;  ///< Number of wifi packets queued to members
+    };
+
     Room();
     ~Room();
 
@@ -132,6 +143,11 @@ public:
      */
     bool HasPassword() const;
 
+    /**
+     * Gets the traffic counters of the room.
+     */
+    Stats GetStats() const;
+
     using UsernameBanList = std::vector<std::string>;
     using IPBanList = std::vector<std::string>;
 
@@ -147,7 +163,7 @@ public:
                 const u32 max_connections = MaxConcurrentConnections,
                 const std::string& host_username = "", const std::string& preferred_game = "",
                 u64 preferred_game_id = 0,
-                std::unique_ptr<VerifyUser::Backend> verify_backend = nullptr,
+                std::shared_ptr<VerifyUser::Backend> verify_backend = nullptr,
                 const BanList& ban_list = {}, bool enable_citra_mods = false);
 
     /**
@@ -166,6 +182,31 @@ public:
     void Destroy();
 
 private:
+    friend class RoomPool;
+
+    /// Ban lists of a room, shared by all the rooms of a RoomPool
+    struct BanLists {
+        UsernameBanList username_ban_list; ///< List of banned usernames
+        IPBanList ip_ban_list;             ///< List of banned IP addresses
+        std::mutex mutex;                  ///< Mutex for the ban lists
+    };
+
+    /**
+     * Makes the room use the given ban lists and be serviced by a RoomPool instead of its own
+     * thread. Must be called before Create.
+     */
+    void SetPooled(std::shared_ptr<BanLists> ban_lists);
+
+    /**
+     * Handles the events the room has already received and sends the pending packets.
+     */
+    void Service();
+
+    /**
+     * Gets the ENet host the room is listening on.
+     */
+    _ENetHost* GetHost() const;
+
     class RoomImpl;
     std::unique_ptr<RoomImpl> room_impl;
 };
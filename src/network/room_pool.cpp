@@ -0,0 +1,144 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include "common/logging/log.h"
+#include "enet/enet.h"
+#include "network/room_pool.h"
+
+namespace Network {
+
+/// Longest time a room goes without being serviced, so that ENet can resend lost packets, ping
+/// the members and detect the ones that timed out
+constexpr std::chrono::milliseconds TimerInterval{10};
+
+RoomPool::RoomPool(std::size_t num_threads, std::shared_ptr<VerifyUser::Backend> verify_backend,
+                   const Room::BanList& ban_list)
+    : verify_backend{std::move(verify_backend)}, ban_lists{std::make_shared<Room::BanLists>()} {
+    ban_lists->username_ban_list = ban_list.first;
+    ban_lists->ip_ban_list = ban_list.second;
+
+    workers.resize(std::max<std::size_t>(num_threads, 1));
+    for (auto& worker : workers) {
+        worker = std::make_unique<Worker>();
+        worker->thread = std::thread(&RoomPool::WorkerLoop, this, std::ref(*worker));
+    }
+}
+
+RoomPool::~RoomPool() {
+    Destroy();
+}
+
+std::shared_ptr<Room> RoomPool::CreateRoom(const std::string& name,
+                                           const std::string& description,
+                                           const std::string& server, u16 server_port,
+                                           const std::string& password, u32 max_connections,
+                                           const std::string& host_username,
+                                           const std::string& preferred_game,
+                                           u64 preferred_game_id, bool enable_citra_mods) {
+    if (workers.empty()) {
+        // The pool was destroyed, there is nothing left to service the room
+        return nullptr;
+    }
+
+    auto room = std::make_shared<Room>();
+    room->SetPooled(ban_lists);
+    if (!room->Create(name, description, server, server_port, password, max_connections,
+                      host_username, preferred_game, preferred_game_id, verify_backend, {},
+                      enable_citra_mods)) {
+        return nullptr;
+    }
+
+    // Give the room to the worker with the fewest rooms, it stays there until it is destroyed
+    Worker& worker = **std::min_element(workers.begin(), workers.end(),
+                                        [](const auto& lhs, const auto& rhs) {
+                                            return lhs->num_rooms < rhs->num_rooms;
+                                        });
+    {
+        std::lock_guard lock(worker.mutex);
+        worker.rooms.push_back(room);
+        worker.num_rooms++;
+        worker.rooms_changed = true;
+    }
+    {
+        std::lock_guard lock(rooms_mutex);
+        rooms.push_back(room);
+    }
+    return room;
+}
+
+std::vector<std::shared_ptr<Room>> RoomPool::GetRooms() const {
+    std::lock_guard lock(rooms_mutex);
+    return rooms;
+}
+
+Room::BanList RoomPool::GetBanList() const {
+    std::lock_guard lock(ban_lists->mutex);
+    return {ban_lists->username_ban_list, ban_lists->ip_ban_list};
+}
+
+void RoomPool::Destroy() {
+    if (!running.exchange(false)) {
+        return;
+    }
+    for (auto& worker : workers) {
+        worker->thread.join();
+    }
+    workers.clear();
+
+    std::lock_guard lock(rooms_mutex);
+    for (auto& room : rooms) {
+        room->Destroy();
+    }
+    rooms.clear();
+}
+
+void RoomPool::WorkerLoop(Worker& worker) {
+    std::vector<std::shared_ptr<Room>> serviced_rooms;
+    auto next_timer_service = std::chrono::steady_clock::now();
+
+    while (running) {
+        if (worker.rooms_changed.exchange(false)) {
+            std::lock_guard lock(worker.mutex);
+            serviced_rooms = worker.rooms;
+        }
+        if (serviced_rooms.empty()) {
+            std::this_thread::sleep_for(TimerInterval);
+            continue;
+        }
+
+        // Wait until a room receives something or its timers are due
+        ENetSocketSet read_set;
+        ENET_SOCKETSET_EMPTY(read_set);
+        ENetSocket max_socket = 0;
+        for (const auto& room : serviced_rooms) {
+            const ENetSocket socket = room->GetHost()->socket;
+            ENET_SOCKETSET_ADD(read_set, socket);
+            max_socket = std::max(max_socket, socket);
+        }
+
+        const auto now = std::chrono::steady_clock::now();
+        const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::max(next_timer_service - now, std::chrono::steady_clock::duration::zero()));
+        if (enet_socketset_select(max_socket, &read_set, nullptr,
+                                  static_cast<enet_uint32>(timeout.count())) < 0) {
+            LOG_ERROR(Network, "Failed to wait for the sockets of the rooms");
+            ENET_SOCKETSET_EMPTY(read_set);
+        }
+
+        const bool service_all = std::chrono::steady_clock::now() >= next_timer_service;
+        if (service_all) {
+            next_timer_service = std::chrono::steady_clock::now() + TimerInterval;
+        }
+        for (const auto& room : serviced_rooms) {
+            if (service_all || ENET_SOCKETSET_CHECK(read_set, room->GetHost()->socket)) {
+                room->Service();
+            }
+        }
+    }
+}
+
+} // namespace Network
@@ -0,0 +1,85 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "common/common_types.h"
+#include "network/room.h"
+
+namespace Network {
+
+/**
+ * Hosts many rooms in one process. The rooms are spread over a fixed number of threads, each of
+ * which waits on the sockets of all its rooms at once and only services the rooms that received
+ * something. All the rooms share the same verification backend and ban lists.
+ */
+class RoomPool final {
+public:
+    /**
+     * @param num_threads Number of threads servicing the rooms
+     * @param verify_backend Verification backend used by all the rooms
+     * @param ban_list Initial ban lists of all the rooms
+     */
+    explicit RoomPool(std::size_t num_threads,
+                      std::shared_ptr<VerifyUser::Backend> verify_backend,
+                      const Room::BanList& ban_list = {});
+    ~RoomPool();
+
+    /**
+     * Creates a room serviced by the pool. Will bind to default address if server is empty
+     * string.
+     * @returns The new room, or nullptr if its socket could not be created or the pool was
+     *          destroyed
+     */
+    std::shared_ptr<Room> CreateRoom(const std::string& name, const std::string& description,
+                                     const std::string& server, u16 server_port,
+                                     const std::string& password, u32 max_connections,
+                                     const std::string& host_username,
+                                     const std::string& preferred_game, u64 preferred_game_id,
+                                     bool enable_citra_mods);
+
+    /**
+     * Gets the rooms hosted by the pool.
+     */
+    std::vector<std::shared_ptr<Room>> GetRooms() const;
+
+    /**
+     * Gets the ban lists shared by the rooms.
+     */
+    Room::BanList GetBanList() const;
+
+    /**
+     * Stops servicing the rooms and closes all of them.
+     */
+    void Destroy();
+
+private:
+    struct Worker {
+        std::thread thread;
+        std::mutex mutex; ///< Mutex for rooms
+        std::vector<std::shared_ptr<Room>> rooms;
+        std::atomic<u32> num_rooms{0};
+        std::atomic_bool rooms_changed{false};
+    };
+
+    /// Thread function that services the rooms of a worker until the pool is destroyed
+    void WorkerLoop(Worker& worker);
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::atomic_bool running{true};
+
+    std::shared_ptr<VerifyUser::Backend> verify_backend;
+    std::shared_ptr<Room::BanLists> ban_lists;
+
+    mutable std::mutex rooms_mutex; ///< Mutex for rooms
+    std::vector<std::shared_ptr<Room>> rooms;
+};
+
+} // namespace Network
@@ -0,0 +1,302 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "common/common_paths.h"
+#include "common/common_types.h"
+#include "common/file_util.h"
+#include "common/logging/backend.h"
+#include "common/logging/filter.h"
+#include "common/logging/log.h"
+#include "common/scm_rev.h"
+#include "core/settings.h"
+#include "video_core/renderer_opengl/gl_shader_disk_cache.h"
+#include "video_core/renderer_opengl/gl_shader_gen.h"
+#include "video_core/renderer_opengl/gl_vars.h"
+#include "video_core/video_core.h"
+
+#undef _UNICODE
+#include <getopt.h>
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+static void PrintHelp(const char* argv0) {
+    std::cout << "Usage: " << argv0
+              << " [options] <title id>\n"
+                 "Decompiles every shader in the transferable cache of the given title and\n"
+                 "writes the results to its separable precompiled cache.\n\n"
+                 "-a, --accurate-mul  Generate vertex shaders with accurate multiplication\n"
+                 "-e, --gles          Generate shaders for OpenGL ES\n"
+                 "-j, --jobs=N        Number of worker threads, defaults to all cores\n"
+                 "-c, --check         Only verify the caches, do not write anything\n"
+                 "-u, --user-dir=DIR  Use DIR as the user directory instead of the default one\n"
+                 "-h, --help          Display this help and exit\n"
+                 "-v, --version       Output version information and exit\n";
+}
+
+static void PrintVersion() {
+    std::cout << "Citra shader cache tool " << Common::g_scm_branch << " " << Common::g_scm_desc
+              << std::endl;
+}
+
+static void InitializeLogging() {
+    Log::Filter log_filter(Log::Level::Info);
+    Log::SetGlobalFilter(log_filter);
+
+    Log::AddBackend(std::make_unique<Log::ColorConsoleBackend>());
+
+#ifdef _WIN32
+    Log::AddBackend(std::make_unique<Log::DebuggerBackend>());
+#endif
+}
+
+namespace {
+
+enum class EntryStatus {
+    New,      ///< The entry was not in the precompiled cache
+    Matching, ///< The precompiled cache holds identical code for the entry
+    Stale,    ///< The precompiled cache holds different code for the entry
+    Invalid,  ///< The stored identifier does not match the configuration
+    Failed,   ///< The shader could not be decompiled
+};
+
+struct Entry {
+    EntryStatus status{};
+    bool sanitize_mul{};
+    std::optional<OpenGL::ShaderDecompiler::ProgramResult> result;
+};
+
+Entry DecompileEntry(const OpenGL::ShaderDiskCacheRaw& raw,
+                     const OpenGL::ShaderDecompiledMap& decompiled) {
+    using namespace OpenGL;
+
+    Entry entry;
+    const u64 unique_identifier = raw.GetUniqueIdentifier();
+    if (unique_identifier != GetUniqueIdentifier(raw.GetRawShaderConfig(), raw.GetProgramCode())) {
+        entry.status = EntryStatus::Invalid;
+        return entry;
+    }
+
+    switch (raw.GetProgramType()) {
+    case ProgramType::VS: {
+        auto [conf, setup] = BuildVSConfigFromRaw(raw);
+        entry.result = GenerateVertexShader(setup, conf, true);
+        entry.sanitize_mul = conf.state.sanitize_mul;
+        break;
+    }
+    case ProgramType::FS: {
+        const PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
+        entry.result = GenerateFragmentShader(conf, true);
+        break;
+    }
+    default:
+        break;
+    }
+
+    if (!entry.result) {
+        entry.status = EntryStatus::Failed;
+        return entry;
+    }
+
+    const auto it = decompiled.find(unique_identifier);
+    if (it == decompiled.end()) {
+        entry.status = EntryStatus::New;
+    } else if (it->second.sanitize_mul == entry.sanitize_mul &&
+               it->second.result.code == entry.result->code) {
+        entry.status = EntryStatus::Matching;
+    } else {
+        entry.status = EntryStatus::Stale;
+    }
+    return entry;
+}
+
+} // Anonymous namespace
+
+/// Application entry point
+int main(int argc, char** argv) {
+    int option_index = 0;
+    char* endarg;
+
+    bool accurate_mul = false;
+    bool gles = false;
+    bool check_only = false;
+    std::size_t num_workers = std::max(1U, std::thread::hardware_concurrency());
+    std::string user_dir;
+
+    static struct option long_options[] = {
+        {"accurate-mul", no_argument, 0, 'a'},
+        {"gles", no_argument, 0, 'e'},
+        {"jobs", required_argument, 0, 'j'},
+        {"check", no_argument, 0, 'c'},
+        {"user-dir", required_argument, 0, 'u'},
+        {"help", no_argument, 0, 'h'},
+        {"version", no_argument, 0, 'v'},
+        {0, 0, 0, 0},
+    };
+
+    std::string title_id;
+    while (optind < argc) {
+        int arg = getopt_long(argc, argv, "aej:cu:hv", long_options, &option_index);
+        if (arg != -1) {
+            switch (static_cast<char>(arg)) {
+            case 'a':
+                accurate_mul = true;
+                break;
+            case 'e':
+                gles = true;
+                break;
+            case 'j':
+                num_workers = std::max<std::size_t>(1, strtoul(optarg, &endarg, 0));
+                break;
+            case 'c':
+                check_only = true;
+                break;
+            case 'u':
+                user_dir.assign(optarg);
+                break;
+            case 'h':
+                PrintHelp(argv[0]);
+                return 0;
+            case 'v':
+                PrintVersion();
+                return 0;
+            }
+        } else {
+            title_id.assign(argv[optind]);
+            optind++;
+        }
+    }
+
+    const u64 program_id = strtoull(title_id.c_str(), &endarg, 16);
+    if (program_id == 0) {
+        std::cout << "title id not set!\n\n";
+        PrintHelp(argv[0]);
+        return -1;
+    }
+
+    InitializeLogging();
+    if (!user_dir.empty()) {
+        if (user_dir.back() != DIR_SEP_CHR) {
+            user_dir += DIR_SEP_CHR;
+        }
+        FileUtil::SetUserPath(user_dir);
+    }
+
+    // The disk cache and the shader generators read these globals
+    Settings::values.use_hw_shader = true;
+    Settings::values.use_disk_shader_cache = true;
+    VideoCore::g_hw_shader_accurate_mul = accurate_mul;
+    OpenGL::GLES = gles;
+
+    // Only separable shaders are built from the raw entries, conventional programs are linked
+    // and dumped by the driver while playing
+    OpenGL::ShaderDiskCache disk_cache{true, program_id};
+    auto transferable = disk_cache.LoadTransferable();
+    if (!transferable) {
+        std::cout << "No usable transferable cache for title id " << title_id << "\n";
+        return -1;
+    }
+
+    // Process the entries in identifier order so the written cache does not depend on the order
+    // they were encountered in or on the number of workers
+    auto& raws = *transferable;
+    std::sort(raws.begin(), raws.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs.GetUniqueIdentifier() < rhs.GetUniqueIdentifier();
+    });
+    raws.erase(std::unique(raws.begin(), raws.end(),
+                           [](const auto& lhs, const auto& rhs) {
+                               return lhs.GetUniqueIdentifier() == rhs.GetUniqueIdentifier();
+                           }),
+               raws.end());
+
+    const auto precompiled = disk_cache.LoadPrecompiled(true);
+    const OpenGL::ShaderDecompiledMap& decompiled = precompiled.first;
+
+    const auto start_time = std::chrono::steady_clock::now();
+
+    std::vector<Entry> entries(raws.size());
+    std::atomic<std::size_t> next_entry = 0;
+    const auto DecompileEntries = [&] {
+        for (std::size_t i = next_entry++; i < raws.size(); i = next_entry++) {
+            entries[i] = DecompileEntry(raws[i], decompiled);
+        }
+    };
+
+    num_workers = std::min(num_workers, std::max<std::size_t>(1, raws.size()));
+    std::vector<std::thread> threads(num_workers);
+    for (auto& thread : threads) {
+        thread = std::thread(DecompileEntries);
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_time;
+
+    std::size_t counts[5]{};
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        const EntryStatus status = entries[i].status;
+        counts[static_cast<std::size_t>(status)]++;
+        if (status == EntryStatus::Invalid) {
+            LOG_ERROR(Render_OpenGL, "Invalid hash in entry={:016x}",
+                      raws[i].GetUniqueIdentifier());
+        } else if (status == EntryStatus::Failed) {
+            LOG_WARNING(Render_OpenGL, "Failed to decompile entry={:016x} of type {}",
+                        raws[i].GetUniqueIdentifier(), raws[i].GetProgramType());
+        } else if (status == EntryStatus::Stale) {
+            LOG_INFO(Render_OpenGL, "Precompiled entry={:016x} is stale",
+                     raws[i].GetUniqueIdentifier());
+        }
+    }
+
+    std::cout << "Decompiled " << raws.size() << " shaders in " << elapsed.count() << "s using "
+              << num_workers << " threads\n"
+              << "  new:      " << counts[static_cast<std::size_t>(EntryStatus::New)] << "\n"
+              << "  matching: " << counts[static_cast<std::size_t>(EntryStatus::Matching)] << "\n"
+              << "  stale:    " << counts[static_cast<std::size_t>(EntryStatus::Stale)] << "\n"
+              << "  invalid:  " << counts[static_cast<std::size_t>(EntryStatus::Invalid)] << "\n"
+              << "  failed:   " << counts[static_cast<std::size_t>(EntryStatus::Failed)] << "\n";
+
+    const std::size_t num_invalid = counts[static_cast<std::size_t>(EntryStatus::Invalid)];
+    if (check_only) {
+        const std::size_t num_outdated =
+            counts[static_cast<std::size_t>(EntryStatus::New)] +
+            counts[static_cast<std::size_t>(EntryStatus::Stale)];
+        return num_invalid == 0 && num_outdated == 0 ? 0 : 1;
+    }
+    if (num_invalid != 0) {
+        // The emulator discards the whole cache when it finds such an entry, don't ship it
+        std::cout << "The transferable cache is corrupted, not writing the precompiled cache\n";
+        return 1;
+    }
+    if (std::none_of(entries.begin(), entries.end(), [](const Entry& entry) {
+            return entry.result.has_value();
+        })) {
+        std::cout << "Nothing to write\n";
+        return 0;
+    }
+
+    // Rewrite the precompiled cache from scratch. Driver binaries are not carried over since
+    // they are specific to the machine, the emulator builds them from the decompiled code
+    disk_cache.InvalidatePrecompiled();
+    for (std::size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].result) {
+            disk_cache.SaveDecompiled(raws[i].GetUniqueIdentifier(), *entries[i].result,
+                                      entries[i].sanitize_mul);
+        }
+    }
+    disk_cache.SaveVirtualPrecompiledFile();
+
+    return 0;
+}
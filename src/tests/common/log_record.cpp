@@ -0,0 +1,46 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/logging/record.h"
+
+namespace Log {
+
+template <typename... Args>
+static std::string PackAndFormat(std::string_view format, const Args&... args) {
+    std::vector<u8> packed((Detail::PackedArgSize<Detail::ArgType_t<Args>>(args) + ... + 0));
+    [[maybe_unused]] u8* out = packed.data();
+    ((out = Detail::PackArg<Detail::ArgType_t<Args>>(out, args)), ...);
+    REQUIRE(out == packed.data() + packed.size());
+    return FormatRecordMessage(format, sizeof...(Args), packed);
+}
+
+TEST_CASE("LogRecord", "[common]") {
+    SECTION("arguments keep their formatting") {
+        const std::string string = "string";
+        const char array[] = "array";
+        REQUIRE(PackAndFormat("{} {} {:08X} {} {}", -5, u8{200}, 0xABCDu, ~0ULL, s16{-3}) ==
+                "-5 200 0000ABCD 18446744073709551615 -3");
+        REQUIRE(PackAndFormat("{} {} {:.2f}", 0.1f, 0.1, 1.0) == "0.1 0.1 1.00");
+        REQUIRE(PackAndFormat("{} {} {}", true, 'c', static_cast<const void*>(nullptr)) ==
+                "true c 0x0");
+        REQUIRE(PackAndFormat("{} {} {} {}", string, std::string_view{"view"}, array, "literal") ==
+                "string view array literal");
+        REQUIRE(PackAndFormat("{:>8}|{}", "", static_cast<const char*>(nullptr)) == "        |");
+    }
+
+    SECTION("broken records are reported") {
+        REQUIRE(PackAndFormat("{:d}", "string").starts_with("<invalid log message"));
+        REQUIRE(PackAndFormat("{} {}", 1).starts_with("<invalid log message"));
+        REQUIRE(FormatRecordMessage("{}", 1, {}).starts_with("<truncated log record"));
+
+        const u8 unknown_type[9] = {0xFF};
+        REQUIRE(FormatRecordMessage("{}", 1, unknown_type).starts_with("<corrupted log record"));
+    }
+}
+
+} // namespace Log
@@ -0,0 +1,186 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/logging/log.h"
+#include "common/logging/record_ring.h"
+
+namespace Log {
+
+namespace {
+
+constexpr std::size_t RING_SIZE = 1024;
+
+/// Collects the records passed to the writer, which waits until it is opened
+class Collector {
+public:
+    void Write(const RecordHeader& header, u32 size) {
+        std::unique_lock lock{mutex};
+        cv.wait(lock, [this] { return open; });
+        const auto* const record = reinterpret_cast<const u8*>(&header);
+        records.emplace_back(record, record + size);
+    }
+
+    void Open() {
+        std::lock_guard lock{mutex};
+        open = true;
+        cv.notify_all();
+    }
+
+    std::vector<std::vector<u8>> Records() {
+        std::lock_guard lock{mutex};
+        return records;
+    }
+
+    RecordRing::Writer Writer() {
+        return [this](const RecordHeader& header, u32 size) { Write(header, size); };
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool open = false;
+    std::vector<std::vector<u8>> records;
+};
+
+/// Logs a record of the given size whose line number and contents are the index
+bool PushTestRecord(RecordRing& ring, u8 index, Level log_level, std::size_t size) {
+    RecordHeader* const header = ring.Reserve(size, log_level);
+    if (!header) {
+        return false;
+    }
+    header->log_class = Class::Log;
+    header->log_level = log_level;
+    header->num_args = 0;
+    header->line_num = index;
+    header->reserved = 0;
+    header->filename = header->function = header->format = reinterpret_cast<uintptr_t>("");
+    std::memset(header + 1, index, size - sizeof(RecordHeader));
+    ring.Commit(header, size);
+    return true;
+}
+
+RecordHeader GetHeader(const std::vector<u8>& record) {
+    RecordHeader header;
+    std::memcpy(&header, record.data(), sizeof(header));
+    return header;
+}
+
+bool IsIntact(const std::vector<u8>& record, u8 index) {
+    return std::all_of(record.begin() + sizeof(RecordHeader), record.end(),
+                       [index](u8 value) { return value == index; });
+}
+
+} // Anonymous namespace
+
+TEST_CASE("RecordRing", "[common]") {
+    Collector collector;
+
+    SECTION("records skip the end of the ring") {
+        // Records that do not divide the ring, so that it has to be padded when wrapping around
+        constexpr std::size_t record_size = 200;
+        constexpr u8 num_records = 20;
+        {
+            RecordRing ring{RING_SIZE, collector.Writer()};
+            collector.Open();
+            for (u8 i = 0; i < num_records; i++) {
+                REQUIRE(PushTestRecord(ring, i, Level::Debug, record_size));
+            }
+        }
+
+        const auto records = collector.Records();
+        REQUIRE(records.size() == num_records);
+        for (u8 i = 0; i < num_records; i++) {
+            const RecordHeader header = GetHeader(records[i]);
+            REQUIRE(header.size == record_size);
+            REQUIRE(header.log_class == Class::Log);
+            REQUIRE(header.line_num == i);
+            REQUIRE(IsIntact(records[i], i));
+        }
+    }
+
+    SECTION("a full ring makes messages wait") {
+        constexpr std::size_t record_size = 128;
+        constexpr u8 num_records = RING_SIZE / record_size;
+        RecordRing ring{RING_SIZE, collector.Writer()};
+        for (u8 i = 0; i < num_records; i++) {
+            REQUIRE(PushTestRecord(ring, i, Level::Debug, record_size));
+        }
+
+        auto pushed = std::async(std::launch::async, [&ring] {
+            return PushTestRecord(ring, num_records, Level::Debug, record_size);
+        });
+        REQUIRE(pushed.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+        collector.Open();
+        REQUIRE(pushed.get());
+    }
+
+    SECTION("errors wait when other messages are dropped") {
+        constexpr std::size_t record_size = 128;
+        constexpr u8 num_records = RING_SIZE / record_size;
+        std::optional<RecordRing> ring{std::in_place, RING_SIZE, collector.Writer()};
+        ring->SetDropWhenFull(true);
+        for (u8 i = 0; i < num_records; i++) {
+            REQUIRE(PushTestRecord(*ring, i, Level::Debug, record_size));
+        }
+        REQUIRE(!PushTestRecord(*ring, num_records, Level::Warning, record_size));
+
+        constexpr u8 error_index = num_records + 1;
+        auto pushed = std::async(std::launch::async, [&ring] {
+            return PushTestRecord(*ring, error_index, Level::Error, record_size);
+        });
+        REQUIRE(pushed.wait_for(std::chrono::milliseconds(50)) == std::future_status::timeout);
+        collector.Open();
+        REQUIRE(pushed.get());
+        ring.reset();
+
+        // The number of dropped messages follows the record being written when they were dropped
+        const auto records = collector.Records();
+        REQUIRE(records.size() == num_records + 2);
+        const RecordHeader notice = GetHeader(records[1]);
+        REQUIRE(notice.log_class == Class::Log);
+        REQUIRE(notice.log_level == Level::Warning);
+        REQUIRE(FormatRecordMessage(reinterpret_cast<const char*>(notice.format), notice.num_args,
+                                    {records[1].data() + sizeof(notice),
+                                     records[1].size() - sizeof(notice)}) ==
+                "1 log messages were dropped");
+        REQUIRE(GetHeader(records.back()).log_level == Level::Error);
+        REQUIRE(IsIntact(records.back(), error_index));
+    }
+
+    SECTION("pending records are written when the ring is destroyed") {
+        constexpr std::size_t record_size = 64;
+        constexpr u8 num_records = 10;
+        std::thread opener;
+        {
+            RecordRing ring{RING_SIZE, collector.Writer()};
+            for (u8 i = 0; i < num_records; i++) {
+                REQUIRE(PushTestRecord(ring, i, Level::Info, record_size));
+            }
+            opener = std::thread([&collector] {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+                collector.Open();
+            });
+        }
+        opener.join();
+
+        const auto records = collector.Records();
+        REQUIRE(records.size() == num_records);
+        for (u8 i = 0; i < num_records; i++) {
+            REQUIRE(GetHeader(records[i]).line_num == i);
+            REQUIRE(IsIntact(records[i], i));
+        }
+    }
+}
+
+} // namespace Log
@@ -0,0 +1,71 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include "common/zstd_seekable.h"
+
+namespace Common::Compression {
+
+static std::vector<u8> BuildArchive(const std::vector<u8>& data, std::size_t frame_size) {
+    std::vector<u8> archive;
+    std::vector<SeekableZstdFrame> frames;
+    for (std::size_t offset = 0; offset < data.size(); offset += frame_size) {
+        const std::size_t size = std::min(frame_size, data.size() - offset);
+        const auto frame = CompressSeekableZstdFrame(data.data() + offset, size, 3);
+        archive.insert(archive.end(), frame.begin(), frame.end());
+        frames.push_back({static_cast<u32>(frame.size()), static_cast<u32>(size)});
+    }
+    const auto seek_table = BuildSeekableZstdSeekTable(frames);
+    archive.insert(archive.end(), seek_table.begin(), seek_table.end());
+    return archive;
+}
+
+static SeekableZstdReader::ReadFunction ReadFrom(const std::vector<u8>& archive) {
+    return [&archive](u64 offset, void* buffer, std::size_t length) -> std::size_t {
+        if (offset >= archive.size()) {
+            return 0;
+        }
+        length = std::min<std::size_t>(length, archive.size() - offset);
+        std::memcpy(buffer, archive.data() + offset, length);
+        return length;
+    };
+}
+
+TEST_CASE("SeekableZstd", "[common]") {
+    std::vector<u8> data(10000);
+    for (std::size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<u8>((i * 7) ^ (i >> 5));
+    }
+    const auto archive = BuildArchive(data, 1024);
+
+    auto reader = SeekableZstdReader::Open(ReadFrom(archive), archive.size());
+    REQUIRE(reader != nullptr);
+    REQUIRE(reader->GetSize() == data.size());
+
+    SECTION("reads across frames") {
+        std::vector<u8> buffer(data.size());
+        for (const auto& [offset, length] : std::vector<std::pair<std::size_t, std::size_t>>{
+                 {0, 10000}, {0, 1}, {1023, 2}, {1024, 1024}, {500, 5000}, {9990, 10}}) {
+            REQUIRE(reader->Read(offset, buffer.data(), length) == length);
+            REQUIRE(std::equal(buffer.begin(), buffer.begin() + length, data.begin() + offset));
+        }
+    }
+
+    SECTION("reads stop at the end") {
+        std::vector<u8> buffer(100);
+        REQUIRE(reader->Read(9950, buffer.data(), buffer.size()) == 50);
+        REQUIRE(reader->Read(10000, buffer.data(), buffer.size()) == 0);
+    }
+
+    SECTION("other data is rejected") {
+        const auto compressed = CompressSeekableZstdFrame(data.data(), data.size(), 3);
+        REQUIRE(SeekableZstdReader::Open(ReadFrom(compressed), compressed.size()) == nullptr);
+        REQUIRE(SeekableZstdReader::Open(ReadFrom(data), data.size()) == nullptr);
+    }
+}
+
+} // namespace Common::Compression
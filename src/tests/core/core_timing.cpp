@@ -2,11 +2,13 @@
 // Licensed under GPLv2+
 // Refer to the license.txt file included.
 
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <catch2/catch_test_macros.hpp>
 
 #include <array>
 #include <bitset>
 #include <string>
+#include <vector>
 #include "common/file_util.h"
 #include "core/core.h"
 #include "core/core_timing.h"
@@ -196,4 +198,72 @@ TEST_CASE("CoreTiming[ChainScheduling]", "[core]") {
     REQUIRE(MAX_SLICE_LENGTH == timing.GetTimer(0)->GetDowncount());
 }
 
+TEST_CASE("CoreTiming[UnscheduleByHandle]", "[core]") {
+    Core::Timing timing(1, 100);
+
+    Core::TimingEventType* cb_a = timing.RegisterEvent("callbackA", CallbackTemplate<0>);
+    Core::TimingEventType* cb_b = timing.RegisterEvent("callbackB", CallbackTemplate<1>);
+    Core::TimingEventType* cb_c = timing.RegisterEvent("callbackC", CallbackTemplate<2>);
+
+    // Enter slice 0
+    timing.GetTimer(0)->Advance();
+    timing.GetTimer(0)->SetNextSlice();
+
+    const auto handle_a = timing.ScheduleEvent(100, cb_a, CB_IDS[0], 0);
+    const auto handle_b = timing.ScheduleEvent(200, cb_b, CB_IDS[1], 0);
+    timing.ScheduleEvent(BASE_CLOCK_RATE_ARM11 * 100, cb_c, CB_IDS[2], 0);
+    REQUIRE(handle_a.IsValid());
+    REQUIRE(handle_b.IsValid());
+
+    timing.UnscheduleEvent(handle_a);
+    AdvanceAndCheck(timing, 1, MAX_SLICE_LENGTH, 0, -100);
+
+    // Both handles are stale now, unscheduling through them must not touch other events
+    timing.UnscheduleEvent(handle_a);
+    timing.UnscheduleEvent(handle_b);
+    REQUIRE(BASE_CLOCK_RATE_ARM11 * 100 - 200 == timing.GetTimer(0)->GetMaxSliceLength());
+}
+
 // TODO: Add tests for multiple timers
+
+TEST_CASE("CoreTiming[Benchmark]", "[core][!benchmark]") {
+    Core::Timing timing(1, 100);
+    Core::TimingEventType* cb = timing.RegisterEvent("callback", [](u64, s64) {});
+    auto timer = timing.GetTimer(0);
+
+    // Enter slice 0
+    timer->Advance();
+    timer->SetNextSlice();
+
+    constexpr std::size_t num_events = 1000;
+    std::vector<Core::Timing::EventHandle> handles(num_events);
+
+    BENCHMARK("Schedule and unschedule by handle") {
+        for (std::size_t i = 0; i < num_events; ++i) {
+            handles[i] = timing.ScheduleEvent(static_cast<s64>(1 + i * 7919 % 50000000), cb, i);
+        }
+        for (const auto& handle : handles) {
+            timing.UnscheduleEvent(handle);
+        }
+    };
+
+    BENCHMARK("Schedule and unschedule by userdata") {
+        for (std::size_t i = 0; i < num_events; ++i) {
+            timing.ScheduleEvent(static_cast<s64>(1 + i * 7919 % 50000000), cb, i);
+        }
+        for (std::size_t i = 0; i < num_events; ++i) {
+            timing.UnscheduleEvent(cb, i);
+        }
+    };
+
+    BENCHMARK("Advance through periodic events") {
+        for (std::size_t i = 0; i < 64; ++i) {
+            timing.ScheduleEvent(static_cast<s64>(1000 + i * 20000), cb, i);
+        }
+        while (timer->GetMaxSliceLength() != MAX_SLICE_LENGTH) {
+            timer->AddTicks(timer->GetDowncount());
+            timer->Advance();
+            timer->SetNextSlice();
+        }
+    };
+}
@@ -0,0 +1,79 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/file_util.h"
+#include "core/file_sys/romfs_reader.h"
+
+namespace FileSys {
+
+namespace {
+
+constexpr std::size_t FILE_OFFSET = 0x200;
+constexpr std::size_t DATA_SIZE = 0x28345;
+
+std::string WriteTestFile(std::vector<u8>& contents) {
+    contents.resize(FILE_OFFSET + DATA_SIZE);
+    for (std::size_t i = 0; i < contents.size(); ++i) {
+        contents[i] = static_cast<u8>(i * 7 + (i >> 8));
+    }
+    const auto path = std::filesystem::temp_directory_path() / "citra_romfs_reader_test.bin";
+    FileUtil::IOFile out(path.string(), "wb");
+    out.WriteBytes(contents.data(), contents.size());
+    return path.string();
+}
+
+void CheckReads(RomFSReader& reader, const std::vector<u8>& expected) {
+    const std::vector<std::pair<std::size_t, std::size_t>> ranges = {
+        {0, 16},          {0xFFF0, 0x20},     {0x10, 0x20000},
+        {0x1234, 0x5678}, {DATA_SIZE - 5, 5}, {DATA_SIZE - 5, 0x100},
+        {0x1234, 0x5678}, {0, DATA_SIZE},
+    };
+    for (const auto& [offset, length] : ranges) {
+        std::vector<u8> buffer(length);
+        const std::size_t expected_length = std::min(length, DATA_SIZE - offset);
+        REQUIRE(reader.ReadFile(offset, length, buffer.data()) == expected_length);
+        REQUIRE(std::equal(buffer.begin(), buffer.begin() + expected_length,
+                           expected.begin() + offset));
+    }
+
+    u8 byte;
+    REQUIRE(reader.ReadFile(DATA_SIZE, 1, &byte) == 0);
+}
+
+} // Anonymous namespace
+
+TEST_CASE("DirectRomFSReader", "[core][file_sys]") {
+    std::vector<u8> contents;
+    const std::string path = WriteTestFile(contents);
+
+    SECTION("plain") {
+        DirectRomFSReader reader(FileUtil::IOFile(path, "rb"), FILE_OFFSET, DATA_SIZE);
+        CheckReads(reader, std::vector<u8>(contents.begin() + FILE_OFFSET, contents.end()));
+    }
+
+    SECTION("encrypted") {
+        const std::array<u8, 16> key{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16};
+        const std::array<u8, 16> ctr{0xC0, 0xFF, 0xEE};
+        constexpr std::size_t crypto_offset = 0x1000;
+
+        std::vector<u8> expected(contents.begin() + FILE_OFFSET, contents.end());
+        CryptoPP::CTR_Mode<CryptoPP::AES>::Decryption d(key.data(), key.size(), ctr.data());
+        d.Seek(crypto_offset);
+        d.ProcessData(expected.data(), expected.data(), expected.size());
+
+        DirectRomFSReader reader(FileUtil::IOFile(path, "rb"), FILE_OFFSET, DATA_SIZE, key, ctr,
+                                 crypto_offset);
+        CheckReads(reader, expected);
+    }
+
+    FileUtil::Delete(path);
+}
+
+} // namespace FileSys
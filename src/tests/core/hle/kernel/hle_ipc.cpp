@@ -186,6 +186,40 @@ TEST_CASE("HLERequestContext::PopulateFromIncomingCommandBuffer", "[core][kernel
                     target_address, static_cast<u32>(buffer.GetSize())) == RESULT_SUCCESS);
     }
 
+    SECTION("borrows MappedBuffer memory") {
+        auto mem = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE * 2);
+        MemoryRef buffer{mem};
+        std::fill(buffer.GetPtr(), buffer.GetPtr() + buffer.GetSize(), 0xCD);
+
+        VAddr target_address = 0x10000000;
+        auto result = process->vm_manager.MapBackingMemory(
+            target_address, buffer, static_cast<u32>(buffer.GetSize()), MemoryState::Private);
+        REQUIRE(result.Code() == RESULT_SUCCESS);
+
+        const u32_le input[]{
+            IPC::MakeHeader(0, 0, 2),
+            IPC::MappedBufferDesc(buffer.GetSize(), IPC::RW),
+            target_address,
+        };
+
+        context.PopulateFromIncomingCommandBuffer(input, process);
+
+        auto& mapped_buffer = context.GetMappedBuffer(0);
+        const auto read_span = mapped_buffer.GetReadSpan(0x10, Memory::CITRA_PAGE_SIZE);
+        REQUIRE(read_span.data() == buffer.GetPtr() + 0x10);
+        REQUIRE(read_span.size() == Memory::CITRA_PAGE_SIZE);
+
+        const auto write_span = mapped_buffer.GetWriteSpan(1, 2);
+        REQUIRE(write_span.size() == 2);
+        write_span[0] = 0x12;
+        write_span[1] = 0x34;
+        CHECK(mem->Vector()[1] == 0x12);
+        CHECK(mem->Vector()[2] == 0x34);
+
+        REQUIRE(process->vm_manager.UnmapRange(
+                    target_address, static_cast<u32>(buffer.GetSize())) == RESULT_SUCCESS);
+    }
+
     SECTION("translates mixed params") {
         auto mem_static = std::make_shared<BufferMem>(Memory::CITRA_PAGE_SIZE);
         MemoryRef buffer_static{mem_static};
@@ -0,0 +1,160 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
+#include <vector>
+#include <catch2/catch_test_macros.hpp>
+#include <cryptopp/aes.h>
+#include <cryptopp/modes.h>
+#include "common/alignment.h"
+#include "common/common_paths.h"
+#include "common/file_util.h"
+#include "core/file_sys/cia_common.h"
+#include "core/file_sys/cia_container.h"
+#include "core/file_sys/ticket.h"
+#include "core/file_sys/title_metadata.h"
+#include "core/hle/service/am/am.h"
+#include "core/hle/service/fs/archive.h"
+#include "core/hw/aes/key.h"
+
+namespace Service::AM {
+
+namespace {
+
+constexpr u64 TITLE_ID = 0x00040000'0F0C1A00;
+// Several install chunks long, so that the content is decrypted by several threads
+constexpr std::size_t CONTENT_SIZE = 0x400000 * 5 + 0x2340;
+constexpr std::size_t SECTION_ALIGNMENT = 0x40;
+// Offset of the body of a ticket or TMD with a RSA-2048 signature
+constexpr std::size_t SIGNED_BODY_OFFSET = 0x140;
+
+using Key = std::array<u8, 16>;
+
+template <typename T>
+void WriteAt(std::vector<u8>& data, std::size_t offset, const T& value) {
+    std::memcpy(data.data() + offset, &value, sizeof(T));
+}
+
+void EncryptCBC(const Key& key, const Key& iv, u8* data, std::size_t length) {
+    CryptoPP::CBC_Mode<CryptoPP::AES>::Encryption{key.data(), key.size(), iv.data()}.ProcessData(
+        data, data, length);
+}
+
+/// Points the key and title directories to a temporary directory and sets up a common key
+void SetUpUserDirectories(const std::filesystem::path& root) {
+    const auto sysdata = root / "sysdata";
+    const auto sdmc = root / "sdmc";
+    std::filesystem::create_directories(sysdata);
+    std::filesystem::create_directories(sdmc);
+    FileUtil::UpdateUserPath(FileUtil::UserPath::SysDataDir, sysdata.string());
+    FileUtil::UpdateUserPath(FileUtil::UserPath::SDMCDir, sdmc.string());
+    FileUtil::WriteStringToFile(true, (sysdata / AES_KEYS).string(),
+                                "slot0x3DKeyX=000102030405060708090A0B0C0D0E0F\n"
+                                "common0=F0E0D0C0B0A090807060504030201000");
+    HW::AES::InitKeys();
+}
+
+/// Builds a CIA with a single encrypted content, plain_content receives the decrypted content
+std::vector<u8> BuildCIA(std::vector<u8>& plain_content) {
+    const std::size_t ticket_size = SIGNED_BODY_OFFSET + sizeof(FileSys::Ticket::Body);
+    const std::size_t tmd_size = SIGNED_BODY_OFFSET + sizeof(FileSys::TitleMetadata::Body) +
+                                 sizeof(FileSys::TitleMetadata::ContentChunk);
+    const std::size_t ticket_offset = Common::AlignUp(FileSys::CIA_HEADER_SIZE, SECTION_ALIGNMENT);
+    const std::size_t tmd_offset = Common::AlignUp(ticket_offset + ticket_size, SECTION_ALIGNMENT);
+    const std::size_t content_offset = Common::AlignUp(tmd_offset + tmd_size, SECTION_ALIGNMENT);
+    std::vector<u8> cia(content_offset + CONTENT_SIZE);
+
+    // Header, without certificates or meta
+    WriteAt<u32_le>(cia, 0x0, static_cast<u32>(FileSys::CIA_HEADER_SIZE));
+    WriteAt<u32_le>(cia, 0xC, static_cast<u32>(ticket_size));
+    WriteAt<u32_le>(cia, 0x10, static_cast<u32>(tmd_size));
+    WriteAt<u64_le>(cia, 0x18, CONTENT_SIZE);
+    cia[0x20] = 0x80; // Content 0 is present
+
+    // Ticket holding the title key encrypted with the common key
+    HW::AES::SelectCommonKeyIndex(0);
+    REQUIRE(HW::AES::IsNormalKeyAvailable(HW::AES::KeySlotID::TicketCommonKey));
+    const Key common_key = HW::AES::GetNormalKey(HW::AES::KeySlotID::TicketCommonKey);
+    const Key title_key = {0x11, 0x22, 0x33, 0x44, 0x55, 0x66, 0x77, 0x88,
+                           0x99, 0xAA, 0xBB, 0xCC, 0xDD, 0xEE, 0xFF, 0x00};
+    FileSys::Ticket::Body ticket{};
+    ticket.title_id = TITLE_ID;
+    ticket.common_key_index = 0;
+    ticket.title_key = title_key;
+    Key title_id_iv{};
+    std::memcpy(title_id_iv.data(), &ticket.title_id, sizeof(ticket.title_id));
+    EncryptCBC(common_key, title_id_iv, ticket.title_key.data(), ticket.title_key.size());
+    WriteAt<u32_be>(cia, ticket_offset, FileSys::Rsa2048Sha256);
+    WriteAt(cia, ticket_offset + SIGNED_BODY_OFFSET, ticket);
+
+    // TMD with a single encrypted content
+    FileSys::TitleMetadata::Body tmd{};
+    tmd.title_id = TITLE_ID;
+    tmd.content_count = 1;
+    FileSys::TitleMetadata::ContentChunk content{};
+    content.id = 0x12;
+    content.index = 0;
+    content.type = FileSys::TMDContentTypeFlag::Encrypted;
+    content.size = CONTENT_SIZE;
+    WriteAt<u32_be>(cia, tmd_offset, FileSys::Rsa2048Sha256);
+    WriteAt(cia, tmd_offset + SIGNED_BODY_OFFSET, tmd);
+    WriteAt(cia, tmd_offset + SIGNED_BODY_OFFSET + sizeof(tmd), content);
+
+    // The content IV is the content index
+    plain_content.resize(CONTENT_SIZE);
+    for (std::size_t i = 0; i < plain_content.size(); i++) {
+        plain_content[i] = static_cast<u8>(i * 13 + (i >> 12));
+    }
+    std::memcpy(cia.data() + content_offset, plain_content.data(), CONTENT_SIZE);
+    EncryptCBC(title_key, Key{}, cia.data() + content_offset, CONTENT_SIZE);
+    return cia;
+}
+
+std::vector<u8> ReadInstalledContent() {
+    FileUtil::IOFile file(GetTitleContentPath(FS::MediaType::SDMC, TITLE_ID, 0), "rb");
+    std::vector<u8> content(file.GetSize());
+    REQUIRE(file.ReadBytes(content.data(), content.size()) == content.size());
+    return content;
+}
+
+} // Anonymous namespace
+
+TEST_CASE("InstallCIA single content", "[core][am]") {
+    const auto root = std::filesystem::temp_directory_path() / "citra_install_cia_test";
+    std::filesystem::remove_all(root);
+    SetUpUserDirectories(root);
+
+    std::vector<u8> plain_content;
+    const std::vector<u8> cia = BuildCIA(plain_content);
+
+    // The serial path, taken when the guest writes a CIA through AM, decrypts each content in
+    // order with a single cipher
+    {
+        CIAFile file(FS::MediaType::SDMC);
+        constexpr std::size_t piece_size = 0x100000;
+        for (std::size_t offset = 0; offset < cia.size(); offset += piece_size) {
+            const std::size_t length = std::min(piece_size, cia.size() - offset);
+            REQUIRE(file.Write(offset, length, true, cia.data() + offset).Succeeded());
+        }
+        file.Close();
+    }
+    const std::vector<u8> serial_content = ReadInstalledContent();
+    REQUIRE(serial_content == plain_content);
+    FileUtil::DeleteDirRecursively(GetTitlePath(FS::MediaType::SDMC, TITLE_ID));
+
+    const std::string cia_path = (root / "test.cia").string();
+    {
+        FileUtil::IOFile out(cia_path, "wb");
+        REQUIRE(out.WriteBytes(cia.data(), cia.size()) == cia.size());
+    }
+    REQUIRE(InstallCIA(cia_path) == InstallStatus::Success);
+    REQUIRE(ReadInstalledContent() == serial_content);
+
+    std::filesystem::remove_all(root);
+}
+
+} // namespace Service::AM
@@ -52,12 +52,14 @@ static const char* GetShaderSetupTypeName(Shader::ShaderSetup& setup) {
 static void WriteUniformBoolReg(Shader::ShaderSetup& setup, u32 value) {
     for (unsigned i = 0; i < setup.uniforms.b.size(); ++i)
         setup.uniforms.b[i] = (value & (1 << i)) != 0;
+    setup.uniforms_dirty.bools = true;
 }
 
 static void WriteUniformIntReg(Shader::ShaderSetup& setup, unsigned index,
                                const Common::Vec4<u8>& values) {
     ASSERT(index < setup.uniforms.i.size());
     setup.uniforms.i[index] = values;
+    setup.uniforms_dirty.ints = true;
     LOG_TRACE(HW_GPU, "Set {} integer uniform {} to {:02x} {:02x} {:02x} {:02x}",
               GetShaderSetupTypeName(setup), index, values.x, values.y, values.z, values.w);
 }
@@ -101,6 +103,7 @@ static void WriteUniformFloatReg(ShaderRegs& config, Shader::ShaderSetup& setup,
                                              ((uniform_write_buffer[2] >> 24) & 0xFF));
                 uniform.x = float24::FromRaw(uniform_write_buffer[2] & 0xFFFFFF);
             }
+            setup.MarkFloatUniformDirty(uniform_setup.index);
 
             LOG_TRACE(HW_GPU, "Set {} float uniform {:x} to ({} {} {} {})",
                       GetShaderSetupTypeName(setup), (int)uniform_setup.index,
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <unordered_map>
 #include <optional>
+#include <span>
 #include <vector>
 #include <boost/range/iterator_range.hpp>
 #include "common/alignment.h"
@@ -21,6 +22,18 @@
 
 namespace VideoCore {
 
+/// Number of guest readbacks after which a surface is copied to host memory ahead of time
+constexpr u32 ASYNC_READBACK_THRESHOLD = 2;
+
+/// Number of frames a surface must stay unused before it can be evicted
+constexpr u64 SURFACE_EVICTION_AGE = 4;
+
+struct CacheStats {
+    u32 resident_surfaces = 0; ///< Number of registered surfaces backed by a host texture
+    u64 resident_bytes = 0;    ///< Estimated host memory used by resident surfaces
+    u32 evicted_surfaces = 0;  ///< Number of surfaces evicted during the last frame
+};
+
 inline auto RangeFromInterval(auto& map, SurfaceInterval interval) {
     return boost::make_iterator_range(map.equal_range(interval));
 }
@@ -121,6 +134,18 @@ public:
     /// Flush all cached resources tracked by this cache manager
     void FlushAll();
 
+    /// Records asynchronous readbacks of modified surfaces the guest is expected to read back
+    void QueueReadbacks();
+
+    /// Advances the frame counter and evicts least recently used surfaces when the runtime
+    /// reports memory usage above its budget
+    void TickFrame();
+
+    /// Returns the residency counters of the cache
+    const CacheStats& GetStats() const {
+        return stats;
+    }
+
 private:
     void DuplicateSurface(const Surface& src_surface, const Surface& dest_surface);
 
@@ -156,13 +181,19 @@ private:
     /// Remove surface from the cache
     void UnregisterSurface(const Surface& surface);
 
+    /// Returns the estimated host memory used by the surface texture
+    u64 GetSurfaceMemorySize(const Surface& surface) const;
+
 private:
     VideoCore::RasterizerAccelerated& rasterizer;
     TextureRuntime& runtime;
     SurfaceCache surface_cache;
     SurfaceMap dirty_regions;
     SurfaceSet remove_surfaces;
+    SurfaceSet readback_surfaces;
     u16 resolution_scale_factor;
+    u64 current_frame = 0;
+    CacheStats stats;
 
     std::unordered_map<TextureCubeConfig, Surface> texture_cube_cache;
     std::recursive_mutex mutex;
@@ -260,6 +291,11 @@ auto RasterizerCache<T>::FindMatch(const SurfaceCache& surface_cache, const Surf
             });
         }
     }
+
+    if (match_surface) {
+        match_surface->last_used_frame = current_frame;
+    }
+
     return match_surface;
 }
 
@@ -930,17 +966,29 @@ void RasterizerCache<T>::DownloadSurface(const Surface& surface, SurfaceInterval
     const u32 flush_end = boost::icl::last_next(interval);
     ASSERT(flush_start >= surface->addr && flush_end <= surface->end);
 
-    const auto& staging = runtime.FindStaging(
-                surface->width * surface->height * 4, false);
-    const SurfaceParams params = surface->FromInterval(interval);
-    const BufferTextureCopy download = {
-        .buffer_offset = 0,
-        .buffer_size = staging.size,
-        .texture_rect = surface->GetSubRect(params),
-        .texture_level = 0
-    };
+    surface->readback_count++;
+
+    // Prefer the data of an asynchronous readback when it covers the exact same region,
+    // the copy has most likely completed by now so this avoids stalling on the GPU
+    std::span<std::byte> download_data;
+    if (surface->readback_pending && surface->readback_interval == interval) {
+        download_data = surface->ReadbackData();
+    }
+
+    if (download_data.empty()) {
+        const auto& staging = runtime.FindStaging(
+                    surface->width * surface->height * 4, false);
+        const SurfaceParams params = surface->FromInterval(interval);
+        const BufferTextureCopy download = {
+            .buffer_offset = 0,
+            .buffer_size = staging.size,
+            .texture_rect = surface->GetSubRect(params),
+            .texture_level = 0
+        };
 
-    surface->Download(download, staging);
+        surface->Download(download, staging);
+        download_data = staging.mapped;
+    }
 
     MemoryRef dest_ptr = VideoCore::g_memory->GetPhysicalRef(flush_start);
     if (!dest_ptr) [[unlikely]] {
@@ -952,12 +1000,12 @@ void RasterizerCache<T>::DownloadSurface(const Surface& surface, SurfaceInterval
     MICROPROFILE_SCOPE(RasterizerCache_SurfaceFlush);
 
     if (surface->is_tiled) {
-        std::vector<std::byte> swizzled_data(staging.size);
+        std::vector<std::byte> swizzled_data(download_data.size());
         runtime.FormatConvert(surface->pixel_format, false, swizzled_data, swizzled_data);
         SwizzleTexture(*surface, flush_start - surface->addr, flush_end - surface->addr,
-                       staging.mapped, download_dest);
+                       download_data, download_dest);
     } else {
-        runtime.FormatConvert(surface->pixel_format, false, staging.mapped, download_dest);
+        runtime.FormatConvert(surface->pixel_format, false, download_data, download_dest);
     }
 }
 
@@ -1117,12 +1165,18 @@ void RasterizerCache<T>::FlushRegion(PAddr addr, u32 size, Surface flush_surface
         // small sizes imply that this most likely comes from the cpu, flush the entire region
         // the point is to avoid thousands of small writes every frame if the cpu decides to
         // access that region, anything higher than 8 you're guaranteed it comes from a service
-        const auto interval = size <= 8 ? pair.first : pair.first & flush_interval;
+        auto interval = size <= 8 ? pair.first : pair.first & flush_interval;
         auto& surface = pair.second;
 
         if (flush_surface != nullptr && surface != flush_surface)
             continue;
 
+        // Writing back the entire region of a completed readback is cheaper than downloading
+        // the requested part again
+        if (surface->readback_pending && surface->readback_interval == pair.first) {
+            interval = pair.first;
+        }
+
         // Sanity check, this surface is the last one that marked this region dirty
         ASSERT(surface->IsRegionValid(interval));
 
@@ -1144,6 +1198,99 @@ void RasterizerCache<T>::FlushAll() {
     FlushRegion(0, 0xFFFFFFFF);
 }
 
+template <class T>
+void RasterizerCache<T>::QueueReadbacks() {
+    std::lock_guard lock{mutex};
+
+    for (const auto& surface : readback_surfaces) {
+        if (!surface->registered || surface->type == SurfaceType::Fill) {
+            continue;
+        }
+
+        // Only a single dirty region can be tracked per surface
+        SurfaceRegions owned_regions;
+        for (const auto& pair : RangeFromInterval(dirty_regions, surface->GetInterval())) {
+            if (pair.second == surface) {
+                owned_regions += pair.first;
+            }
+        }
+
+        if (owned_regions.iterative_size() != 1) {
+            continue;
+        }
+
+        const SurfaceInterval interval = *owned_regions.begin();
+        const SurfaceParams params = surface->FromInterval(interval);
+        const BufferTextureCopy readback = {
+            .buffer_offset = 0,
+            .buffer_size = surface->width * surface->height * 4,
+            .texture_rect = surface->GetSubRect(params),
+            .texture_level = 0
+        };
+
+        surface->readback_interval = interval;
+        surface->readback_pending = surface->QueueReadback(readback);
+    }
+
+    readback_surfaces.clear();
+}
+
+template <class T>
+void RasterizerCache<T>::TickFrame() {
+    std::lock_guard lock{mutex};
+
+    current_frame++;
+    stats.evicted_surfaces = 0;
+
+    u64 over_budget = runtime.GetMemoryOverBudget();
+    if (over_budget == 0) {
+        return;
+    }
+
+    // Collect surfaces that can be evicted without losing data. Dirty surfaces hold data
+    // that only exists on the GPU, so they are never evicted
+    std::vector<Surface> candidates;
+    for (const auto& pair : surface_cache) {
+        for (const auto& surface : pair.second) {
+            if (surface->type == SurfaceType::Fill ||
+                surface->last_used_frame + SURFACE_EVICTION_AGE > current_frame) {
+                continue;
+            }
+
+            const auto dirty = RangeFromInterval(dirty_regions, surface->GetInterval());
+            const bool is_dirty = std::any_of(dirty.begin(), dirty.end(), [&](const auto& dirty_pair) {
+                return dirty_pair.second == surface;
+            });
+
+            if (!is_dirty) {
+                candidates.push_back(surface);
+            }
+        }
+    }
+
+    // Surfaces spanning multiple intervals are visited more than once
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    std::sort(candidates.begin(), candidates.end(), [](const Surface& lhs, const Surface& rhs) {
+        return lhs->last_used_frame < rhs->last_used_frame;
+    });
+
+    // Evicted textures are handed back to the runtime, which frees them once the GPU is done
+    for (const Surface& surface : candidates) {
+        if (over_budget == 0) {
+            break;
+        }
+
+        over_budget -= std::min(over_budget, GetSurfaceMemorySize(surface));
+        UnregisterSurface(surface);
+        stats.evicted_surfaces++;
+    }
+
+    LOG_DEBUG(Render, "Evicted {} surfaces, {} surfaces resident using {} bytes",
+              stats.evicted_surfaces, stats.resident_surfaces, stats.resident_bytes);
+}
+
 template <class T>
 void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, const Surface& region_owner) {
     std::lock_guard lock{mutex};
@@ -1159,6 +1306,13 @@ void RasterizerCache<T>::InvalidateRegion(PAddr addr, u32 size, const Surface& r
         // Surfaces can't have a gap
         ASSERT(region_owner->width == region_owner->stride);
         region_owner->invalid_regions.erase(invalid_interval);
+
+        // Any readback of the surface is now out of date, copy it again if the guest
+        // is likely to read it back
+        region_owner->readback_pending = false;
+        if (region_owner->readback_count >= ASYNC_READBACK_THRESHOLD) {
+            readback_surfaces.emplace(region_owner);
+        }
     }
 
     for (const auto& pair : RangeFromInterval(surface_cache, invalid_interval)) {
@@ -1225,7 +1379,14 @@ void RasterizerCache<T>::RegisterSurface(const Surface& surface) {
         return;
     }
     surface->registered = true;
+    surface->last_used_frame = current_frame;
     surface_cache.add({surface->GetInterval(), SurfaceSet{surface}});
+
+    if (surface->type != SurfaceType::Fill) {
+        stats.resident_surfaces++;
+        stats.resident_bytes += GetSurfaceMemorySize(surface);
+    }
+
     rasterizer.UpdatePagesCachedCount(surface->addr, surface->size, 1);
 }
 
@@ -1237,8 +1398,22 @@ void RasterizerCache<T>::UnregisterSurface(const Surface& surface) {
         return;
     }
     surface->registered = false;
+    readback_surfaces.erase(surface);
+
+    if (surface->type != SurfaceType::Fill) {
+        stats.resident_surfaces--;
+        stats.resident_bytes -= GetSurfaceMemorySize(surface);
+    }
+
     rasterizer.UpdatePagesCachedCount(surface->addr, surface->size, -1);
     surface_cache.subtract({surface->GetInterval(), SurfaceSet{surface}});
 }
 
+template <class T>
+u64 RasterizerCache<T>::GetSurfaceMemorySize(const Surface& surface) const {
+    // Texture formats are decoded to RGBA8, the others keep their size on the host
+    const u64 texels = static_cast<u64>(surface->GetScaledWidth()) * surface->GetScaledHeight();
+    return texels * GetBytesPerPixel(surface->pixel_format);
+}
+
 } // namespace VideoCore
@@ -87,6 +87,15 @@ public:
     std::array<u8, 4> fill_data;
     u32 fill_size = 0;
 
+    /// Frame the surface was last looked up by the cache
+    u64 last_used_frame = 0;
+
+    /// Number of times the guest has read this surface back to memory
+    u32 readback_count = 0;
+    /// Interval of an asynchronous readback that is still up to date with the surface
+    SurfaceInterval readback_interval{};
+    bool readback_pending = false;
+
 public:
     u32 watcher_count = 0;
     std::array<std::weak_ptr<Watcher>, 8> watchers;
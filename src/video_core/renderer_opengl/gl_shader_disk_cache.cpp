@@ -42,6 +42,33 @@ ShaderCacheVersionHash GetShaderCacheVersionHash() {
     return hash;
 }
 
+u64 GetUniqueIdentifier(const Pica::Regs& regs, const ProgramCode& code) {
+    std::size_t hash = 0;
+    u64 regs_uid = Common::ComputeHash64(regs.reg_array.data(), Pica::Regs::NUM_REGS * sizeof(u32));
+    hash = Common::HashCombine(hash, regs_uid);
+
+    if (code.size() > 0) {
+        u64 code_uid = Common::ComputeHash64(code.data(), code.size() * sizeof(u32));
+        hash = Common::HashCombine(hash, code_uid);
+    }
+
+    return hash;
+}
+
+std::tuple<PicaVSConfig, Pica::Shader::ShaderSetup> BuildVSConfigFromRaw(
+    const ShaderDiskCacheRaw& raw) {
+    Pica::Shader::ProgramCode program_code{};
+    Pica::Shader::SwizzleData swizzle_data{};
+    std::copy_n(raw.GetProgramCode().begin(), Pica::Shader::MAX_PROGRAM_CODE_LENGTH,
+                program_code.begin());
+    std::copy_n(raw.GetProgramCode().begin() + Pica::Shader::MAX_PROGRAM_CODE_LENGTH,
+                Pica::Shader::MAX_SWIZZLE_DATA_LENGTH, swizzle_data.begin());
+    Pica::Shader::ShaderSetup setup;
+    setup.program_code = program_code;
+    setup.swizzle_data = swizzle_data;
+    return {PicaVSConfig{raw.GetRawShaderConfig().vs, setup}, setup};
+}
+
 ShaderDiskCacheRaw::ShaderDiskCacheRaw(u64 unique_identifier, ProgramType program_type,
                                        RawShaderConfig config, ProgramCode program_code)
     : unique_identifier{unique_identifier}, program_type{program_type}, config{config},
@@ -106,6 +133,9 @@ bool ShaderDiskCacheRaw::Save(FileUtil::IOFile& file) const {
 
 ShaderDiskCache::ShaderDiskCache(bool separable) : separable{separable} {}
 
+ShaderDiskCache::ShaderDiskCache(bool separable, u64 program_id)
+    : separable{separable}, program_id{program_id} {}
+
 std::optional<std::vector<ShaderDiskCacheRaw>> ShaderDiskCache::LoadTransferable() {
     const bool has_title_id = GetProgramID() != 0;
     if (!Settings::values.use_hw_shader || !Settings::values.use_disk_shader_cache ||
@@ -501,6 +531,9 @@ void ShaderDiskCache::SavePrecompiledHeaderToVirtualPrecompiledCache() {
 }
 
 void ShaderDiskCache::SaveVirtualPrecompiledFile() {
+    if (!EnsureDirectories())
+        return;
+
     decompressed_precompiled_cache_offset = 0;
     const std::vector<u8>& compressed = Common::Compression::CompressDataZSTDDefault(
         decompressed_precompiled_cache.data(), decompressed_precompiled_cache.size());
@@ -76,6 +76,13 @@ private:
     ProgramCode program_code{};
 };
 
+/// Computes the identifier a shader is stored under from its configuration and program code
+u64 GetUniqueIdentifier(const Pica::Regs& regs, const ProgramCode& code);
+
+/// Reconstructs the vertex shader configuration and setup stored in a raw VS entry
+std::tuple<PicaVSConfig, Pica::Shader::ShaderSetup> BuildVSConfigFromRaw(
+    const ShaderDiskCacheRaw& raw);
+
 /// Contains decompiled data from a shader
 struct ShaderDiskCacheDecompiled {
     ShaderDecompiler::ProgramResult result;
@@ -91,6 +98,8 @@ struct ShaderDiskCacheDump {
 class ShaderDiskCache {
 public:
     explicit ShaderDiskCache(bool separable);
+    /// Creates a cache for the given title instead of the one currently running
+    explicit ShaderDiskCache(bool separable, u64 program_id);
     ~ShaderDiskCache() = default;
 
     /// Loads transferable cache. If file has a old version or on failure, it deletes the file.
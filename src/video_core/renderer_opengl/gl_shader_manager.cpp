@@ -16,19 +16,6 @@
 
 namespace OpenGL {
 
-static u64 GetUniqueIdentifier(const Pica::Regs& regs, const ProgramCode& code) {
-    std::size_t hash = 0;
-    u64 regs_uid = Common::ComputeHash64(regs.reg_array.data(), Pica::Regs::NUM_REGS * sizeof(u32));
-    hash = Common::HashCombine(hash, regs_uid);
-
-    if (code.size() > 0) {
-        u64 code_uid = Common::ComputeHash64(code.data(), code.size() * sizeof(u32));
-        hash = Common::HashCombine(hash, code_uid);
-    }
-
-    return hash;
-}
-
 static OGLProgram GeneratePrecompiledProgram(const ShaderDiskCacheDump& dump,
                                              const std::set<GLenum>& supported_formats,
                                              bool separable) {
@@ -70,20 +57,6 @@ static std::set<GLenum> GetSupportedFormats() {
     return supported_formats;
 }
 
-static std::tuple<PicaVSConfig, Pica::Shader::ShaderSetup> BuildVSConfigFromRaw(
-    const ShaderDiskCacheRaw& raw) {
-    Pica::Shader::ProgramCode program_code{};
-    Pica::Shader::SwizzleData swizzle_data{};
-    std::copy_n(raw.GetProgramCode().begin(), Pica::Shader::MAX_PROGRAM_CODE_LENGTH,
-                program_code.begin());
-    std::copy_n(raw.GetProgramCode().begin() + Pica::Shader::MAX_PROGRAM_CODE_LENGTH,
-                Pica::Shader::MAX_SWIZZLE_DATA_LENGTH, swizzle_data.begin());
-    Pica::Shader::ShaderSetup setup;
-    setup.program_code = program_code;
-    setup.swizzle_data = swizzle_data;
-    return {PicaVSConfig{raw.GetRawShaderConfig().vs, setup}, setup};
-}
-
 static void SetShaderUniformBlockBinding(GLuint shader, const char* name, UniformBindings binding,
                                          std::size_t expected_size) {
     const GLuint ub_index = glGetUniformBlockIndex(shader, name);
@@ -637,6 +610,7 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
     compilation_failed = false;
 
     std::size_t built_shaders = 0; // It doesn't have be atomic since it's used behind a mutex
+    const ShaderDecompiledMap& decompiled_map = decompiled;
     const auto LoadRawSepareble = [&](Frontend::GraphicsContext* context, std::size_t begin,
                                       std::size_t end) {
         const auto scope = context->Acquire();
@@ -649,14 +623,34 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
             const auto& raw{raws[raws_index]};
             const u64 unique_identifier{raw.GetUniqueIdentifier()};
 
+            // Entries written without a binary (e.g. by citra-shader-cache) only need to be
+            // built, unless the precompiled file was discarded above
+            const auto decomp{decompiled_map.find(unique_identifier)};
+            const bool has_decompiled = !load_all_raws && decomp != decompiled_map.end();
+
             bool sanitize_mul = false;
+            bool save_decompiled = true;
             GLuint handle{0};
             std::optional<ShaderDecompiler::ProgramResult> result;
             // Otherwise decompile and build the shader at boot and save the result to the
             // precompiled file
             if (raw.GetProgramType() == ProgramType::VS) {
                 auto [conf, setup] = BuildVSConfigFromRaw(raw);
-                result = GenerateVertexShader(setup, conf, impl->separable);
+                if (has_decompiled && decomp->second.sanitize_mul == conf.state.sanitize_mul) {
+                    result = decomp->second.result;
+                    save_decompiled = false;
+                } else {
+                    result = GenerateVertexShader(setup, conf, impl->separable);
+                }
+                if (!result) {
+                    // The shader is not supported by the decompiler, it will run on the CPU
+                    std::scoped_lock lock(mutex);
+                    if (callback) {
+                        callback(VideoCore::LoadCallbackStage::Build, ++built_shaders,
+                                 load_raws_size);
+                    }
+                    continue;
+                }
                 OGLShaderStage stage{impl->separable};
                 stage.Create(result->code.c_str(), GL_VERTEX_SHADER);
                 handle = stage.GetHandle();
@@ -665,7 +659,12 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
                 impl->programmable_vertex_shaders.Inject(conf, result->code, std::move(stage));
             } else if (raw.GetProgramType() == ProgramType::FS) {
                 PicaFSConfig conf = PicaFSConfig::BuildFromRegs(raw.GetRawShaderConfig());
-                result = GenerateFragmentShader(conf, impl->separable);
+                if (has_decompiled) {
+                    result = decomp->second.result;
+                    save_decompiled = false;
+                } else {
+                    result = GenerateFragmentShader(conf, impl->separable);
+                }
                 OGLShaderStage stage{impl->separable};
                 stage.Create(result->code.c_str(), GL_FRAGMENT_SHADER);
                 handle = stage.GetHandle();
@@ -687,7 +686,9 @@ void ShaderProgramManager::LoadDiskCache(const std::atomic_bool& stop_loading,
             std::scoped_lock lock(mutex);
             // If this is a new separable shader, add it the precompiled cache
             if (result) {
-                disk_cache.SaveDecompiled(unique_identifier, *result, sanitize_mul);
+                if (save_decompiled) {
+                    disk_cache.SaveDecompiled(unique_identifier, *result, sanitize_mul);
+                }
                 disk_cache.SaveDump(unique_identifier, handle);
                 precompiled_cache_altered = true;
             }
@@ -136,6 +136,16 @@ public:
     /// Downloads pixel data to staging from a rectangle region of the surface texture
     void Download(const VideoCore::BufferTextureCopy& download, const StagingBuffer& staging);
 
+    /// Asynchronous readback is not implemented, downloads always wait for the GPU
+    bool QueueReadback(const VideoCore::BufferTextureCopy& readback) {
+        return false;
+    }
+
+    /// Returns the pixel data of the last queued readback
+    std::span<std::byte> ReadbackData() {
+        return {};
+    }
+
 private:
     /// Downloads scaled image by downscaling the requested rectangle
     void ScaledDownload(const VideoCore::BufferTextureCopy& download);
@@ -183,7 +183,8 @@ static std::array<float, 3 * 2> MakeOrthographicMatrix(float width, float height
 }
 
 RendererVulkan::RendererVulkan(Frontend::EmuWindow& window)
-    : RendererBase{window}, instance{window}, scheduler{instance}, renderpass_cache{instance, scheduler},
+    : RendererBase{window}, instance{window},
+      scheduler{instance, Settings::values.frames_in_flight}, renderpass_cache{instance, scheduler},
       runtime{instance, scheduler, renderpass_cache}, swapchain{instance, renderpass_cache},
       vertex_buffer{instance, scheduler, VERTEX_BUFFER_SIZE, vk::BufferUsageFlagBits::eVertexBuffer, {}} {
 
@@ -197,6 +198,8 @@ RendererVulkan::RendererVulkan(Frontend::EmuWindow& window)
 }
 
 RendererVulkan::~RendererVulkan() {
+    scheduler.WaitWorker();
+
     vk::Device device = instance.GetDevice();
     device.waitIdle();
 
@@ -280,11 +283,13 @@ void RendererVulkan::PrepareRendertarget() {
                 .layerCount = 1,
             };
 
-            vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
             TextureInfo& texture = screen_infos[i].texture;
-            runtime.Transition(command_buffer, texture.alloc, vk::ImageLayout::eTransferDstOptimal, 0, texture.alloc.levels);
-            command_buffer.clearColorImage(texture.alloc.image, vk::ImageLayout::eTransferDstOptimal,
-                                           clear_color, range);
+            runtime.Transition(texture.alloc, vk::ImageLayout::eTransferDstOptimal, 0, texture.alloc.levels);
+            scheduler.Record([image = texture.alloc.image, clear_color,
+                              range](vk::CommandBuffer command_buffer) {
+                command_buffer.clearColorImage(image, vk::ImageLayout::eTransferDstOptimal,
+                                               clear_color, range);
+            });
         } else {
             TextureInfo& texture = screen_infos[i].texture;
             if (texture.width != framebuffer.width || texture.height != framebuffer.height ||
@@ -306,9 +311,6 @@ void RendererVulkan::PrepareRendertarget() {
 }
 
 void RendererVulkan::BeginRendering() {
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, present_pipelines[current_pipeline]);
-
     std::array<vk::DescriptorImageInfo, 4> present_textures;
     for (std::size_t i = 0; i < screen_infos.size(); i++) {
         const auto& info = screen_infos[i];
@@ -333,9 +335,6 @@ void RendererVulkan::BeginRendering() {
     vk::DescriptorSet set = device.allocateDescriptorSets(alloc_info)[0];
     device.updateDescriptorSetWithTemplate(set, present_update_template, present_textures[0]);
 
-    command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, present_pipeline_layout,
-                                      0, 1, &set, 0, nullptr);
-
     const vk::ClearValue clear_value = {
         .color = clear_color
     };
@@ -349,10 +348,19 @@ void RendererVulkan::BeginRendering() {
             .extent = {layout.width, layout.height}
         },
         .clearValueCount = 1,
-        .pClearValues = &clear_value,
     };
 
-    command_buffer.beginRenderPass(begin_info, vk::SubpassContents::eInline);
+    scheduler.Record([pipeline = present_pipelines[current_pipeline],
+                      layout = present_pipeline_layout, set, begin_info,
+                      clear_value](vk::CommandBuffer command_buffer) {
+        command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+        command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout,
+                                          0, 1, &set, 0, nullptr);
+
+        vk::RenderPassBeginInfo info = begin_info;
+        info.pClearValues = &clear_value;
+        command_buffer.beginRenderPass(info, vk::SubpassContents::eInline);
+    });
 }
 
 void RendererVulkan::LoadFBToScreenInfo(const GPU::Regs::FramebufferConfig& framebuffer,
@@ -699,13 +707,17 @@ void RendererVulkan::DrawSingleScreenRotated(u32 screen_id, float x, float y, fl
     draw_info.o_resolution = Common::Vec4f{h, w, 1.0f / h, 1.0f / w};
     draw_info.screen_id_l = screen_id;
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.pushConstants(present_pipeline_layout,
-                                 vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
-                                 0, sizeof(draw_info), &draw_info);
-
-    command_buffer.bindVertexBuffers(0, vertex_buffer.GetHandle(), {0});
-    command_buffer.draw(4, 1, offset / sizeof(ScreenRectVertex), 0);
+    scheduler.Record([layout = present_pipeline_layout, info = draw_info,
+                      buffer = vertex_buffer.GetHandle(),
+                      first_vertex = static_cast<u32>(offset / sizeof(ScreenRectVertex))](
+                          vk::CommandBuffer command_buffer) {
+        command_buffer.pushConstants(layout,
+                                     vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
+                                     0, sizeof(info), &info);
+
+        command_buffer.bindVertexBuffers(0, buffer, {0});
+        command_buffer.draw(4, 1, first_vertex, 0);
+    });
 }
 
 void RendererVulkan::DrawSingleScreen(u32 screen_id, float x, float y, float w, float h) {
@@ -735,11 +747,6 @@ void RendererVulkan::DrawSingleScreen(u32 screen_id, float x, float y, float w,
     draw_info.o_resolution = Common::Vec4f{h, w, 1.0f / h, 1.0f / w};
     draw_info.screen_id_l = screen_id;
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.pushConstants(present_pipeline_layout,
-                                 vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
-                                 0, sizeof(draw_info), &draw_info);
-
     const vk::ClearValue clear_value = {
         .color = clear_color
     };
@@ -748,14 +755,24 @@ void RendererVulkan::DrawSingleScreen(u32 screen_id, float x, float y, float w,
         .renderPass = renderpass_cache.GetPresentRenderpass(),
         .framebuffer = swapchain.GetFramebuffer(),
         .clearValueCount = 1,
-        .pClearValues = &clear_value,
     };
 
-    command_buffer.beginRenderPass(begin_info, vk::SubpassContents::eInline);
-
-    command_buffer.bindVertexBuffers(0, vertex_buffer.GetHandle(), {0});
-    command_buffer.draw(4, 1, offset / sizeof(ScreenRectVertex), 0);
-    command_buffer.endRenderPass();
+    scheduler.Record([layout = present_pipeline_layout, info = draw_info, begin_info, clear_value,
+                      buffer = vertex_buffer.GetHandle(),
+                      first_vertex = static_cast<u32>(offset / sizeof(ScreenRectVertex))](
+                          vk::CommandBuffer command_buffer) {
+        command_buffer.pushConstants(layout,
+                                     vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
+                                     0, sizeof(info), &info);
+
+        vk::RenderPassBeginInfo renderpass_info = begin_info;
+        renderpass_info.pClearValues = &clear_value;
+        command_buffer.beginRenderPass(renderpass_info, vk::SubpassContents::eInline);
+
+        command_buffer.bindVertexBuffers(0, buffer, {0});
+        command_buffer.draw(4, 1, first_vertex, 0);
+        command_buffer.endRenderPass();
+    });
 }
 
 void RendererVulkan::DrawSingleScreenStereoRotated(u32 screen_id_l, u32 screen_id_r,
@@ -788,13 +805,17 @@ void RendererVulkan::DrawSingleScreenStereoRotated(u32 screen_id_l, u32 screen_i
     draw_info.screen_id_l = screen_id_l;
     draw_info.screen_id_r = screen_id_r;
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.pushConstants(present_pipeline_layout,
-                                 vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
-                                 0, sizeof(draw_info), &draw_info);
-
-    command_buffer.bindVertexBuffers(0, vertex_buffer.GetHandle(), {0});
-    command_buffer.draw(4, 1, offset / sizeof(ScreenRectVertex), 0);
+    scheduler.Record([layout = present_pipeline_layout, info = draw_info,
+                      buffer = vertex_buffer.GetHandle(),
+                      first_vertex = static_cast<u32>(offset / sizeof(ScreenRectVertex))](
+                          vk::CommandBuffer command_buffer) {
+        command_buffer.pushConstants(layout,
+                                     vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
+                                     0, sizeof(info), &info);
+
+        command_buffer.bindVertexBuffers(0, buffer, {0});
+        command_buffer.draw(4, 1, first_vertex, 0);
+    });
 }
 
 void RendererVulkan::DrawSingleScreenStereo(u32 screen_id_l, u32 screen_id_r,
@@ -827,13 +848,17 @@ void RendererVulkan::DrawSingleScreenStereo(u32 screen_id_l, u32 screen_id_r,
     draw_info.screen_id_l = screen_id_l;
     draw_info.screen_id_r = screen_id_r;
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.pushConstants(present_pipeline_layout,
-                                 vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
-                                 0, sizeof(draw_info), &draw_info);
-
-    command_buffer.bindVertexBuffers(0, vertex_buffer.GetHandle(), {0});
-    command_buffer.draw(4, 1, offset / sizeof(ScreenRectVertex), 0);
+    scheduler.Record([layout = present_pipeline_layout, info = draw_info,
+                      buffer = vertex_buffer.GetHandle(),
+                      first_vertex = static_cast<u32>(offset / sizeof(ScreenRectVertex))](
+                          vk::CommandBuffer command_buffer) {
+        command_buffer.pushConstants(layout,
+                                     vk::ShaderStageFlagBits::eFragment | vk::ShaderStageFlagBits::eVertex,
+                                     0, sizeof(info), &info);
+
+        command_buffer.bindVertexBuffers(0, buffer, {0});
+        command_buffer.draw(4, 1, first_vertex, 0);
+    });
 }
 
 void RendererVulkan::DrawScreens(const Layout::FramebufferLayout& layout, bool flipped) {
@@ -992,8 +1017,9 @@ void RendererVulkan::DrawScreens(const Layout::FramebufferLayout& layout, bool f
         }
     }
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.endRenderPass();
+    scheduler.Record([](vk::CommandBuffer command_buffer) {
+        command_buffer.endRenderPass();
+    });
 }
 
 void RendererVulkan::SwapBuffers() {
@@ -1024,13 +1050,14 @@ void RendererVulkan::SwapBuffers() {
         .extent = {layout.width, layout.height}
     };
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.setViewport(0, viewport);
-    command_buffer.setScissor(0, scissor);
+    scheduler.Record([viewport, scissor](vk::CommandBuffer command_buffer) {
+        command_buffer.setViewport(0, viewport);
+        command_buffer.setScissor(0, scissor);
+    });
 
     for (auto& info : screen_infos) {
         auto alloc = info.display_texture ? info.display_texture : &info.texture.alloc;
-        runtime.Transition(command_buffer, *alloc, vk::ImageLayout::eShaderReadOnlyOptimal, 0, alloc->levels);
+        runtime.Transition(*alloc, vk::ImageLayout::eShaderReadOnlyOptimal, 0, alloc->levels);
     }
 
     DrawScreens(layout, false);
@@ -1039,7 +1066,17 @@ void RendererVulkan::SwapBuffers() {
     rasterizer->FlushBuffers();
     vertex_buffer.Flush();
 
+    // Surfaces age by presented frames, not by submissions
+    rasterizer->TickFrame();
+    const VideoCore::CacheStats& cache_stats = rasterizer->GetCacheStats();
+    Core::System::GetInstance().perf_stats->UpdateTextureCacheStats(
+        cache_stats.resident_surfaces, cache_stats.resident_bytes, cache_stats.evicted_surfaces);
+
     scheduler.Submit(SubmitMode::SwapchainSynced);
+
+    // The worker thread owns the graphics queue while it submits, wait for it to hand over the
+    // frame before presenting on the same queue
+    scheduler.WaitWorker();
     swapchain.Present(present_ready);
 
     // Inform texture runtime about the switch
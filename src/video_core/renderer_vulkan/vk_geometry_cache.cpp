@@ -0,0 +1,169 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#define VULKAN_HPP_NO_CONSTRUCTORS
+#include <cstring>
+#include "common/alignment.h"
+#include "common/hash.h"
+#include "common/microprofile.h"
+#include "video_core/renderer_vulkan/vk_geometry_cache.h"
+#include "video_core/renderer_vulkan/vk_instance.h"
+#include "video_core/renderer_vulkan/vk_task_scheduler.h"
+
+namespace Vulkan {
+
+constexpr u32 GEOMETRY_BUFFER_SIZE = 64 * 1024 * 1024;
+constexpr u32 GEOMETRY_STAGING_SIZE = 16 * 1024 * 1024;
+constexpr u32 GEOMETRY_ALIGNMENT = 4;
+
+// Arrays whose contents changed this many times are considered dynamic and always streamed
+constexpr u32 DYNAMIC_CHANGE_COUNT = 4;
+
+MICROPROFILE_DEFINE(Vulkan_GeometryUpload, "Vulkan", "Geometry Cache Upload", MP_RGB(100, 100, 255));
+
+GeometryCache::GeometryCache(const Instance& instance, TaskScheduler& scheduler)
+    : instance{instance}, scheduler{scheduler},
+      staging{instance, GEOMETRY_STAGING_SIZE, vk::BufferUsageFlagBits::eTransferSrc} {
+
+    const vk::BufferCreateInfo buffer_info = {
+        .size = GEOMETRY_BUFFER_SIZE,
+        .usage = vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eIndexBuffer |
+                 vk::BufferUsageFlagBits::eTransferDst
+    };
+
+    const VmaAllocationCreateInfo alloc_create_info = {
+        .usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE
+    };
+
+    VkBuffer unsafe_buffer = VK_NULL_HANDLE;
+    VkBufferCreateInfo unsafe_buffer_info = static_cast<VkBufferCreateInfo>(buffer_info);
+    VmaAllocationInfo alloc_info;
+    VmaAllocator allocator = instance.GetAllocator();
+
+    vmaCreateBuffer(allocator, &unsafe_buffer_info, &alloc_create_info,
+                    &unsafe_buffer, &allocation, &alloc_info);
+
+    buffer = vk::Buffer{unsafe_buffer};
+    current_slot = scheduler.GetCurrentSlotIndex();
+    staging_bucket_size = GEOMETRY_STAGING_SIZE / SCHEDULER_COMMAND_COUNT;
+}
+
+GeometryCache::~GeometryCache() {
+    if (buffer) {
+        vmaDestroyBuffer(instance.GetAllocator(), static_cast<VkBuffer>(buffer), allocation);
+    }
+}
+
+std::optional<u32> GeometryCache::Upload(PAddr addr, std::span<const u8> data) {
+    SyncSlot();
+
+    const u32 size = static_cast<u32>(data.size());
+    if (size == 0 || size > staging_bucket_size) {
+        return std::nullopt;
+    }
+
+    const u64 key = (static_cast<u64>(addr) << 32) | size;
+    auto it = entries.find(key);
+    if (it != entries.end() && it->second.change_count >= DYNAMIC_CHANGE_COUNT) {
+        return std::nullopt;
+    }
+
+    const u64 hash = Common::ComputeHash64(data.data(), data.size());
+    u32 change_count = 0;
+    if (it != entries.end()) {
+        if (it->second.hash == hash) {
+            return it->second.offset;
+        }
+        change_count = ++it->second.change_count;
+        if (change_count >= DYNAMIC_CHANGE_COUNT) {
+            return std::nullopt;
+        }
+    }
+
+    // Cached regions are never overwritten while the current slot may still reference them.
+    // When the buffer is full fall back to streaming until the next slot and start over there.
+    const u32 buffer_offset = Common::AlignUp(buffer_cursor, GEOMETRY_ALIGNMENT);
+    u32& staging_offset = staging_offsets[current_slot];
+    if (reset_pending || buffer_offset + size > GEOMETRY_BUFFER_SIZE) {
+        reset_pending = true;
+        return std::nullopt;
+    }
+    if (staging_offset + size > staging_bucket_size) {
+        return std::nullopt;
+    }
+
+    MICROPROFILE_SCOPE(Vulkan_GeometryUpload);
+
+    const u32 staging_start = current_slot * staging_bucket_size + staging_offset;
+    std::memcpy(staging.mapped.data() + staging_start, data.data(), size);
+    RecordCopy(staging_start, buffer_offset, size);
+
+    staging_offset = Common::AlignUp(staging_offset + size, GEOMETRY_ALIGNMENT);
+    buffer_cursor = buffer_offset + size;
+    entries.insert_or_assign(key, Entry{hash, buffer_offset, change_count});
+
+    return buffer_offset;
+}
+
+void GeometryCache::SyncSlot() {
+    const u32 slot = scheduler.GetCurrentSlotIndex();
+    if (slot == current_slot) {
+        return;
+    }
+
+    // The scheduler waits for a slot to finish before reusing it, so its staging memory is free
+    current_slot = slot;
+    staging_offsets[slot] = 0;
+
+    if (reset_pending) {
+        entries.clear();
+        buffer_cursor = 0;
+        reset_pending = false;
+    }
+}
+
+void GeometryCache::RecordCopy(u32 staging_offset, u32 buffer_offset, u32 size) {
+    VmaAllocator allocator = instance.GetAllocator();
+    vmaFlushAllocation(allocator, staging.allocation, staging_offset, size);
+
+    // Regions are reused after the cache wraps around, wait for older draws reading from them
+    const vk::BufferMemoryBarrier write_barrier = {
+        .srcAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead,
+        .dstAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buffer,
+        .offset = buffer_offset,
+        .size = size
+    };
+
+    const vk::BufferCopy copy_region = {
+        .srcOffset = staging_offset,
+        .dstOffset = buffer_offset,
+        .size = size
+    };
+
+    const vk::BufferMemoryBarrier read_barrier = {
+        .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+        .dstAccessMask = vk::AccessFlagBits::eVertexAttributeRead | vk::AccessFlagBits::eIndexRead,
+        .srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED,
+        .buffer = buffer,
+        .offset = buffer_offset,
+        .size = size
+    };
+
+    scheduler.RecordUpload([src = staging.buffer, dst = buffer, write_barrier, copy_region,
+                            read_barrier](vk::CommandBuffer command_buffer) {
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eVertexInput,
+                                       vk::PipelineStageFlagBits::eTransfer,
+                                       vk::DependencyFlagBits::eByRegion, {}, write_barrier, {});
+        command_buffer.copyBuffer(src, dst, copy_region);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                       vk::PipelineStageFlagBits::eVertexInput,
+                                       vk::DependencyFlagBits::eByRegion, {}, read_barrier, {});
+    });
+}
+
+} // namespace Vulkan
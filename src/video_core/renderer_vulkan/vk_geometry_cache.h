@@ -0,0 +1,71 @@
+// Copyright 2022 Citra Emulator Project
+// Licensed under GPLv2 or any later version
+// Refer to the license.txt file included.
+
+#pragma once
+
+#include <array>
+#include <optional>
+#include <span>
+#include <unordered_map>
+#include "common/common_types.h"
+#include "video_core/renderer_vulkan/vk_stream_buffer.h"
+
+namespace Vulkan {
+
+class Instance;
+class TaskScheduler;
+
+/**
+ * Device local cache for guest vertex and index arrays used by accelerated draws.
+ * Arrays are keyed by their physical address and size and validated against a hash of their
+ * contents, so static geometry is uploaded once and then drawn straight from device memory.
+ */
+class GeometryCache {
+public:
+    GeometryCache(const Instance& instance, TaskScheduler& scheduler);
+    ~GeometryCache();
+
+    /**
+     * Returns the offset of the guest array in the cache buffer, uploading it if it is not
+     * cached or its contents changed. Returns std::nullopt when the array cannot be cached
+     * in the current command slot, in which case the caller should stream it instead.
+     */
+    std::optional<u32> Upload(PAddr addr, std::span<const u8> data);
+
+    /// Returns the Vulkan buffer handle
+    vk::Buffer GetHandle() const {
+        return buffer;
+    }
+
+private:
+    struct Entry {
+        u64 hash;
+        u32 offset;
+        u32 change_count;
+    };
+
+    /// Resets per slot state when the scheduler moved on to a new command slot
+    void SyncSlot();
+
+    /// Records a copy of the staged data to the cache buffer
+    void RecordCopy(u32 staging_offset, u32 buffer_offset, u32 size);
+
+private:
+    const Instance& instance;
+    TaskScheduler& scheduler;
+    StagingBuffer staging;
+
+    vk::Buffer buffer{};
+    VmaAllocation allocation{};
+    u32 buffer_cursor = 0;
+    bool reset_pending = false;
+
+    u32 current_slot = 0;
+    u32 staging_bucket_size = 0;
+    std::array<u32, SCHEDULER_COMMAND_COUNT> staging_offsets{};
+
+    std::unordered_map<u64, Entry> entries;
+};
+
+} // namespace Vulkan
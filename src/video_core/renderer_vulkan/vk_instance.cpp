@@ -129,12 +129,12 @@ bool Instance::CreateDevice() {
     }
 
     // Helper lambda for adding extensions
-    std::array<const char*, 6> enabled_extensions;
+    std::array<const char*, 7> enabled_extensions;
     u32 enabled_extension_count = 0;
 
     auto AddExtension = [&](std::string_view name) -> bool {
         auto result = std::find_if(extension_list.begin(), extension_list.end(), [&](const auto& prop) {
-            return name.compare(prop.extensionName.data());
+            return name.compare(prop.extensionName.data()) == 0;
         });
 
         if (result != extension_list.end()) {
@@ -148,10 +148,11 @@ bool Instance::CreateDevice() {
     };
 
     AddExtension(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
-    AddExtension(VK_EXT_DEPTH_CLIP_CONTROL_EXTENSION_NAME);
+    depth_clip_control = AddExtension(VK_EXT_DEPTH_CLIP_CONTROL_EXTENSION_NAME);
     timeline_semaphores = AddExtension(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
     extended_dynamic_state = AddExtension(VK_EXT_EXTENDED_DYNAMIC_STATE_EXTENSION_NAME);
     push_descriptors = AddExtension(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    memory_budget = AddExtension(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
 
     // Search queue families for graphics and present queues
     auto family_properties = physical_device.getQueueFamilyProperties();
@@ -205,7 +206,7 @@ bool Instance::CreateDevice() {
     };
 
     const u32 queue_count = graphics_queue_family_index != present_queue_family_index ? 2u : 1u;
-    const vk::StructureChain device_chain = {
+    vk::StructureChain device_chain = {
         vk::DeviceCreateInfo{
             .queueCreateInfoCount = queue_count,
             .pQueueCreateInfos = queue_infos.data(),
@@ -233,6 +234,17 @@ bool Instance::CreateDevice() {
         feature_chain.get<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>()
     };
 
+    // Feature structs of unsupported extensions must not be passed to the driver
+    if (!depth_clip_control) {
+        device_chain.unlink<vk::PhysicalDeviceDepthClipControlFeaturesEXT>();
+    }
+    if (!extended_dynamic_state) {
+        device_chain.unlink<vk::PhysicalDeviceExtendedDynamicStateFeaturesEXT>();
+    }
+    if (!timeline_semaphores) {
+        device_chain.unlink<vk::PhysicalDeviceTimelineSemaphoreFeaturesKHR>();
+    }
+
     // Create logical device
     device = physical_device.createDevice(device_chain.get());
     VULKAN_HPP_DEFAULT_DISPATCHER.init(device);
@@ -252,6 +264,7 @@ void Instance::CreateAllocator() {
     };
 
     const VmaAllocatorCreateInfo allocator_info = {
+        .flags = memory_budget ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_BUDGET_BIT : 0u,
         .physicalDevice = physical_device,
         .device = device,
         .pVulkanFunctions = &functions,
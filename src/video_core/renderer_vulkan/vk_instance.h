@@ -67,6 +67,11 @@ public:
         return present_queue;
     }
 
+    /// Returns true when VK_EXT_depth_clip_control is supported
+    bool IsDepthClipControlSupported() const {
+        return depth_clip_control;
+    }
+
     /// Returns true when VK_KHR_timeline_semaphore is supported
     bool IsTimelineSemaphoreSupported() const {
         return timeline_semaphores;
@@ -82,6 +87,11 @@ public:
         return push_descriptors;
     }
 
+    /// Returns true when VK_EXT_memory_budget is supported
+    bool IsMemoryBudgetSupported() const {
+        return memory_budget;
+    }
+
     /// Returns the vendor ID of the physical device
     u32 GetVendorID() const {
         return device_properties.vendorID;
@@ -121,9 +131,11 @@ private:
     u32 present_queue_family_index = 0;
     u32 graphics_queue_family_index = 0;
 
+    bool depth_clip_control = false;
     bool timeline_semaphores = false;
     bool extended_dynamic_state = false;
     bool push_descriptors = false;
+    bool memory_budget = false;
 };
 
 } // namespace Vulkan
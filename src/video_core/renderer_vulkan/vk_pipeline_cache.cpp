@@ -21,6 +21,7 @@ struct Bindings {
 };
 
 constexpr u32 RASTERIZER_SET_COUNT = 4;
+constexpr u32 PUSH_DESCRIPTOR_SET = 0;
 constexpr static std::array RASTERIZER_SETS = {
     Bindings{
         // Utility set
@@ -136,7 +137,8 @@ vk::ShaderStageFlagBits ToVkShaderStage(std::size_t index) {
 }
 
 PipelineCache::PipelineCache(const Instance& instance, TaskScheduler& scheduler, RenderpassCache& renderpass_cache)
-    : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache} {
+    : instance{instance}, scheduler{scheduler}, renderpass_cache{renderpass_cache},
+      use_push_descriptors{instance.IsPushDescriptorsSupported()} {
     descriptor_dirty.fill(true);
 
     LoadDiskCache();
@@ -178,6 +180,7 @@ PipelineCache::~PipelineCache() {
 }
 
 void PipelineCache::BindPipeline(const PipelineInfo& info) {
+    SyncCommandBuffer();
     ApplyDynamic(info);
 
     u64 shader_hash = 0;
@@ -198,8 +201,9 @@ void PipelineCache::BindPipeline(const PipelineInfo& info) {
     }
 
     if (it->second != current_pipeline) {
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-        command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, it->second);
+        scheduler.Record([pipeline = it->second](vk::CommandBuffer command_buffer) {
+            command_buffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pipeline);
+        });
         current_pipeline = it->second;
     }
 
@@ -294,19 +298,38 @@ void PipelineCache::BindSampler(u32 binding, vk::Sampler sampler) {
 }
 
 void PipelineCache::SetViewport(float x, float y, float width, float height) {
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.setViewport(0, vk::Viewport{x, y, width, height, 0.f, 1.f});
+    const vk::Viewport viewport{x, y, width, height, 0.f, 1.f};
+    scheduler.Record([viewport](vk::CommandBuffer command_buffer) {
+        command_buffer.setViewport(0, viewport);
+    });
 }
 
 void PipelineCache::SetScissor(s32 x, s32 y, u32 width, u32 height) {
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.setScissor(0, vk::Rect2D{{x, y}, {width, height}});
+    const vk::Rect2D scissor{{x, y}, {width, height}};
+    scheduler.Record([scissor](vk::CommandBuffer command_buffer) {
+        command_buffer.setScissor(0, scissor);
+    });
 }
 
 void PipelineCache::MarkDescriptorSetsDirty() {
     descriptor_dirty.fill(true);
+    descriptor_bound.fill(false);
     current_pipeline = VK_NULL_HANDLE;
-    descriptor_cache.clear();
+}
+
+void PipelineCache::SyncCommandBuffer() {
+    const u64 fence_counter = scheduler.GetCurrentFenceCounter();
+    if (fence_counter == current_fence_counter) {
+        return;
+    }
+
+    // Nothing is bound in a fresh command buffer. The descriptor pool of the new slot was also
+    // reset by the scheduler, so none of the cached sets are usable anymore.
+    current_fence_counter = fence_counter;
+    MarkDescriptorSetsDirty();
+    for (auto& cache : descriptor_cache) {
+        cache.clear();
+    }
     for (auto& bank : descriptor_bank) {
         bank.clear();
     }
@@ -314,8 +337,10 @@ void PipelineCache::MarkDescriptorSetsDirty() {
 
 void PipelineCache::ApplyDynamic(const PipelineInfo& info) {
     if (instance.IsExtendedDynamicStateSupported()) {
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-        command_buffer.setPrimitiveTopologyEXT(PicaToVK::PrimitiveTopology(info.rasterization.topology));
+        const vk::PrimitiveTopology topology = PicaToVK::PrimitiveTopology(info.rasterization.topology);
+        scheduler.Record([topology](vk::CommandBuffer command_buffer) {
+            command_buffer.setPrimitiveTopologyEXT(topology);
+        });
     }
 }
 
@@ -328,7 +353,8 @@ void PipelineCache::SetBinding(u32 set, u32 binding, DescriptorData data) {
 
 void PipelineCache::BuildLayout() {
     std::array<vk::DescriptorSetLayoutBinding, MAX_DESCRIPTORS> set_bindings;
-    std::array<vk::DescriptorUpdateTemplateEntry, MAX_DESCRIPTORS> update_entries;
+    std::array<std::array<vk::DescriptorUpdateTemplateEntry, MAX_DESCRIPTORS>, RASTERIZER_SET_COUNT>
+        update_entries;
 
     vk::Device device = instance.GetDevice();
     for (u32 i = 0; i < RASTERIZER_SET_COUNT; i++) {
@@ -342,7 +368,7 @@ void PipelineCache::BuildLayout() {
                 .stageFlags = ToVkStageFlags(type)
             };
 
-            update_entries[j] = vk::DescriptorUpdateTemplateEntry{
+            update_entries[i][j] = vk::DescriptorUpdateTemplateEntry{
                 .dstBinding = j,
                 .dstArrayElement = 0,
                 .descriptorCount = 1,
@@ -352,23 +378,16 @@ void PipelineCache::BuildLayout() {
             };
         }
 
+        const bool is_push_set = use_push_descriptors && i == PUSH_DESCRIPTOR_SET;
         const vk::DescriptorSetLayoutCreateInfo layout_info = {
+            .flags = is_push_set ? vk::DescriptorSetLayoutCreateFlagBits::ePushDescriptorKHR
+                                 : vk::DescriptorSetLayoutCreateFlags{},
             .bindingCount = set.binding_count,
             .pBindings = set_bindings.data()
         };
 
         // Create descriptor set layout
         descriptor_set_layouts[i] = device.createDescriptorSetLayout(layout_info);
-
-        const vk::DescriptorUpdateTemplateCreateInfo template_info = {
-            .descriptorUpdateEntryCount = set.binding_count,
-            .pDescriptorUpdateEntries = update_entries.data(),
-            .templateType = vk::DescriptorUpdateTemplateType::eDescriptorSet,
-            .descriptorSetLayout = descriptor_set_layouts[i]
-        };
-
-        // Create descriptor set update template
-        update_templates[i] = device.createDescriptorUpdateTemplate(template_info);
     }
 
     const vk::PipelineLayoutCreateInfo layout_info = {
@@ -379,6 +398,24 @@ void PipelineCache::BuildLayout() {
     };
 
     layout = device.createPipelineLayout(layout_info);
+
+    // Push descriptor templates reference the pipeline layout, so create them afterwards
+    for (u32 i = 0; i < RASTERIZER_SET_COUNT; i++) {
+        const bool is_push_set = use_push_descriptors && i == PUSH_DESCRIPTOR_SET;
+        const vk::DescriptorUpdateTemplateCreateInfo template_info = {
+            .descriptorUpdateEntryCount = RASTERIZER_SETS[i].binding_count,
+            .pDescriptorUpdateEntries = update_entries[i].data(),
+            .templateType = is_push_set ? vk::DescriptorUpdateTemplateType::ePushDescriptorsKHR
+                                        : vk::DescriptorUpdateTemplateType::eDescriptorSet,
+            .descriptorSetLayout = descriptor_set_layouts[i],
+            .pipelineBindPoint = vk::PipelineBindPoint::eGraphics,
+            .pipelineLayout = layout,
+            .set = i
+        };
+
+        // Create descriptor set update template
+        update_templates[i] = device.createDescriptorUpdateTemplate(template_info);
+    }
 }
 
 vk::Pipeline PipelineCache::BuildPipeline(const PipelineInfo& info) {
@@ -492,7 +529,7 @@ vk::Pipeline PipelineCache::BuildPipeline(const PipelineInfo& info) {
     };
 
     const vk::PipelineViewportStateCreateInfo viewport_info = {
-        .pNext = &depth_clip_control,
+        .pNext = instance.IsDepthClipControlSupported() ? &depth_clip_control : nullptr,
         .viewportCount = 1,
         .pViewports = &viewport,
         .scissorCount = 1,
@@ -571,40 +608,76 @@ vk::Pipeline PipelineCache::BuildPipeline(const PipelineInfo& info) {
 void PipelineCache::BindDescriptorSets() {
     static std::array<vk::DescriptorSetLayout, DESCRIPTOR_BANK_SIZE> layouts{};
     vk::Device device = instance.GetDevice();
-
     for (u32 i = 0; i < RASTERIZER_SET_COUNT; i++) {
-        if (descriptor_dirty[i]) {
-            const std::size_t data_size = RASTERIZER_SETS[i].binding_count * sizeof(DescriptorData);
-            const u64 data_hash = Common::ComputeHash64(update_data[i].data(), data_size);
-
-            auto [it, new_descriptor_set] = descriptor_cache.try_emplace(data_hash, vk::DescriptorSet{});
-            if (new_descriptor_set) {
-                if (descriptor_bank[i].empty()) {
-                    layouts.fill(descriptor_set_layouts[i]);
-
-                    const vk::DescriptorSetAllocateInfo alloc_info = {
-                        .descriptorPool = scheduler.GetDescriptorPool(),
-                        .descriptorSetCount = DESCRIPTOR_BANK_SIZE,
-                        .pSetLayouts = layouts.data()
-                    };
-
-                    descriptor_bank[i] = device.allocateDescriptorSets(alloc_info);
-                }
-
-                it->second = descriptor_bank[i].back();
-                device.updateDescriptorSetWithTemplate(it->second, update_templates[i], update_data[i][0]);
-                descriptor_bank[i].pop_back();
+        if (!descriptor_dirty[i]) {
+            continue;
+        }
+
+        descriptor_dirty[i] = false;
+        descriptor_bound[i] = false;
+
+        if (use_push_descriptors && i == PUSH_DESCRIPTOR_SET) {
+            scheduler.Record([update_template = update_templates[i], layout = layout, set = i,
+                              data = update_data[i]](vk::CommandBuffer command_buffer) {
+                command_buffer.pushDescriptorSetWithTemplateKHR(update_template, layout, set,
+                                                                data[0]);
+            });
+            descriptor_bound[i] = true;
+            continue;
+        }
+
+        // Reuse a set with identical contents if one was already written in this slot
+        const std::size_t data_size = RASTERIZER_SETS[i].binding_count * sizeof(DescriptorData);
+        const u64 data_hash = Common::ComputeHash64(update_data[i].data(), data_size);
+
+        auto [it, new_descriptor_set] = descriptor_cache[i].try_emplace(data_hash);
+        if (!new_descriptor_set &&
+            std::memcmp(it->second.data.data(), update_data[i].data(), data_size) == 0) {
+            if (descriptor_sets[i] == it->second.set) {
+                descriptor_bound[i] = true;
             }
+            descriptor_sets[i] = it->second.set;
+            continue;
+        }
+
+        if (descriptor_bank[i].empty()) {
+            layouts.fill(descriptor_set_layouts[i]);
 
-            descriptor_sets[i] = it->second;
-            descriptor_dirty[i] = false;
+            const vk::DescriptorSetAllocateInfo alloc_info = {
+                .descriptorPool = scheduler.GetDescriptorPool(),
+                .descriptorSetCount = DESCRIPTOR_BANK_SIZE,
+                .pSetLayouts = layouts.data()
+            };
+
+            descriptor_bank[i] = device.allocateDescriptorSets(alloc_info);
         }
+
+        it->second.data = update_data[i];
+        it->second.set = descriptor_bank[i].back();
+        device.updateDescriptorSetWithTemplate(it->second.set, update_templates[i], update_data[i][0]);
+        descriptor_bank[i].pop_back();
+        descriptor_sets[i] = it->second.set;
     }
 
-    // Bind the descriptor sets
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0, RASTERIZER_SET_COUNT,
-                                      descriptor_sets.data(), 0, nullptr);
+    // Only rebind the range of sets that actually changed
+    u32 first = 0;
+    while (first < RASTERIZER_SET_COUNT && descriptor_bound[first]) {
+        first++;
+    }
+
+    u32 last = RASTERIZER_SET_COUNT;
+    while (last > first && descriptor_bound[last - 1]) {
+        last--;
+    }
+
+    if (first < last) {
+        scheduler.Record([layout = layout, first, count = last - first,
+                          sets = descriptor_sets](vk::CommandBuffer command_buffer) {
+            command_buffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, first,
+                                              count, sets.data() + first, 0, nullptr);
+        });
+        std::fill(descriptor_bound.begin() + first, descriptor_bound.begin() + last, true);
+    }
 }
 
 void PipelineCache::LoadDiskCache() {
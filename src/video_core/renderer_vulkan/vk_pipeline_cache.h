@@ -200,6 +200,9 @@ public:
     void MarkDescriptorSetsDirty();
 
 private:
+    /// Resets the bound state when recording moved to a new command buffer
+    void SyncCommandBuffer();
+
     /// Binds a resource to the provided binding
     void SetBinding(u32 set, u32 binding, DescriptorData data);
 
@@ -248,9 +251,23 @@ private:
     // Current data for the descriptor sets
     std::array<DescriptorSetData, MAX_DESCRIPTOR_SETS> update_data{};
     std::array<bool, MAX_DESCRIPTOR_SETS> descriptor_dirty{};
+    std::array<bool, MAX_DESCRIPTOR_SETS> descriptor_bound{};
     std::array<vk::DescriptorSet, MAX_DESCRIPTOR_SETS> descriptor_sets{};
     std::array<std::vector<vk::DescriptorSet>, MAX_DESCRIPTOR_SETS> descriptor_bank;
-    std::unordered_map<u64, vk::DescriptorSet, Common::IdentityHash<u64>> descriptor_cache;
+
+    // Descriptor sets allocated from the descriptor pool of the current command slot,
+    // keyed by the hash of their contents
+    struct CachedDescriptorSet {
+        DescriptorSetData data;
+        vk::DescriptorSet set;
+    };
+    std::array<std::unordered_map<u64, CachedDescriptorSet, Common::IdentityHash<u64>>,
+               MAX_DESCRIPTOR_SETS>
+        descriptor_cache;
+
+    // The utility set changes every draw, so it is pushed when VK_KHR_push_descriptor is available
+    bool use_push_descriptors = false;
+    u64 current_fence_counter = 0;
 
     // Bound shader modules
     enum ProgramType : u32 {
@@ -3,6 +3,7 @@
 // Refer to the license.txt file included.
 
 #define VULKAN_HPP_NO_CONSTRUCTORS
+#include <algorithm>
 #include "common/alignment.h"
 #include "common/logging/log.h"
 #include "common/math_util.h"
@@ -118,15 +119,17 @@ RasterizerVulkan::RasterizerVulkan(Frontend::EmuWindow& emu_window, const Instan
       texture_buffer{instance, scheduler, TEXTURE_BUFFER_SIZE, vk::BufferUsageFlagBits::eUniformTexelBuffer,
                     TEXTURE_BUFFER_FORMATS},
       texture_lf_buffer{instance, scheduler, TEXTURE_BUFFER_SIZE, vk::BufferUsageFlagBits::eUniformTexelBuffer,
-                        TEXTURE_BUFFER_LF_FORMATS} {
+                        TEXTURE_BUFFER_LF_FORMATS},
+      geometry_cache{instance, scheduler} {
 
     // Create a 1x1 clear texture to use in the NULL case,
     default_texture = runtime.Allocate(1, 1, VideoCore::PixelFormat::RGBA8,
                                        VideoCore::TextureType::Texture2D);
-    runtime.Transition(scheduler.GetUploadCommandBuffer(), default_texture,
+    runtime.Transition(default_texture,
                        vk::ImageLayout::eShaderReadOnlyOptimal, 0, 1);
 
     uniform_block_data.lighting_lut_dirty.fill(true);
+    Pica::g_state.vs.uniforms_dirty.MarkAll();
 
     uniform_buffer_alignment = instance.UniformMinAlignment();
     uniform_size_aligned_vs =
@@ -344,6 +347,8 @@ void RasterizerVulkan::SetupVertexArray(u32 vs_input_size, u32 vs_input_index_mi
     VertexLayout layout{};
     std::array<bool, 16> enable_attributes{};
     std::array<u64, 16> binding_offsets{};
+    std::array<vk::Buffer, 16> buffers;
+    buffers.fill(vertex_buffer.GetHandle());
 
     u32 buffer_offset = 0;
     for (const auto& loader : vertex_attributes.attribute_loaders) {
@@ -387,7 +392,7 @@ void RasterizerVulkan::SetupVertexArray(u32 vs_input_size, u32 vs_input_index_mi
         const u32 data_size = loader.byte_count * vertex_num;
 
         res_cache.FlushRegion(data_addr, data_size, nullptr);
-        std::memcpy(array_ptr, VideoCore::g_memory->GetPhysicalPointer(data_addr), data_size);
+        const u8* data = VideoCore::g_memory->GetPhysicalPointer(data_addr);
 
         // Create the binding associated with this loader
         VertexBinding& binding = layout.bindings.at(layout.binding_count);
@@ -395,7 +400,15 @@ void RasterizerVulkan::SetupVertexArray(u32 vs_input_size, u32 vs_input_index_mi
         binding.fixed.Assign(0);
         binding.stride.Assign(loader.byte_count);
 
-        // Keep track of the binding offsets so we can bind the vertex buffer later
+        // Keep track of the binding offsets so we can bind the vertex buffer later.
+        // Unchanged arrays are drawn directly from the geometry cache.
+        if (const auto cached_offset = geometry_cache.Upload(data_addr, {data, data_size})) {
+            buffers[layout.binding_count] = geometry_cache.GetHandle();
+            binding_offsets[layout.binding_count++] = *cached_offset;
+            continue;
+        }
+
+        std::memcpy(array_ptr, data, data_size);
         binding_offsets[layout.binding_count++] = array_offset + buffer_offset;
         array_ptr += data_size;
         buffer_offset += data_size;
@@ -440,14 +453,13 @@ void RasterizerVulkan::SetupVertexArray(u32 vs_input_size, u32 vs_input_index_mi
     }
 
     pipeline_info.vertex_layout = layout;
-    vertex_buffer.Commit(vs_input_size);
-
-    std::array<vk::Buffer, 16> buffers;
-    buffers.fill(vertex_buffer.GetHandle());
+    vertex_buffer.Commit(buffer_offset + offset);
 
     // Bind the vertex buffers with all the bindings
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.bindVertexBuffers(0, layout.binding_count, buffers.data(), binding_offsets.data());
+    scheduler.Record([binding_count = static_cast<u32>(layout.binding_count), buffers,
+                      binding_offsets](vk::CommandBuffer command_buffer) {
+        command_buffer.bindVertexBuffers(0, binding_count, buffers.data(), binding_offsets.data());
+    });
 }
 
 bool RasterizerVulkan::SetupVertexShader() {
@@ -503,7 +515,7 @@ bool RasterizerVulkan::AccelerateDrawBatchInternal(bool is_indexed) {
     SetupVertexArray(vs_input_size, vs_input_index_min, vs_input_index_max);
     pipeline_cache.BindPipeline(pipeline_info);
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
+    const u32 num_vertices = regs.pipeline.num_vertices;
     if (is_indexed) {
         bool index_u16 = regs.pipeline.index_array.format != 0;
         const u64 index_buffer_size = regs.pipeline.num_vertices * (index_u16 ? 2 : 1);
@@ -513,22 +525,36 @@ bool RasterizerVulkan::AccelerateDrawBatchInternal(bool is_indexed) {
             return false;
         }
 
-        const u8* index_data = VideoCore::g_memory->GetPhysicalPointer(
-            regs.pipeline.vertex_attributes.GetPhysicalBaseAddress() +
-            regs.pipeline.index_array.offset);
-
-        // Upload index buffer data to the GPU
-        auto [index_ptr, index_offset, _] = index_buffer.Map(index_buffer_size, 4);
-        std::memcpy(index_ptr, index_data, index_buffer_size);
-        index_buffer.Commit(index_buffer_size);
-
-        vk::IndexType index_type = index_u16 ? vk::IndexType::eUint16 : vk::IndexType::eUint8EXT;
-        command_buffer.bindIndexBuffer(index_buffer.GetHandle(), index_offset, index_type);
+        const PAddr index_address = regs.pipeline.vertex_attributes.GetPhysicalBaseAddress() +
+                                    regs.pipeline.index_array.offset;
+        const u8* index_data = VideoCore::g_memory->GetPhysicalPointer(index_address);
+
+        // Upload index buffer data to the GPU, unless the cached copy is still valid
+        const vk::IndexType index_type = index_u16 ? vk::IndexType::eUint16 : vk::IndexType::eUint8EXT;
+        const std::span<const u8> index_span{index_data, index_buffer_size};
+        vk::Buffer bound_index_buffer{};
+        u32 bound_index_offset = 0;
+        if (const auto cached_offset = geometry_cache.Upload(index_address, index_span)) {
+            bound_index_buffer = geometry_cache.GetHandle();
+            bound_index_offset = *cached_offset;
+        } else {
+            auto [index_ptr, index_offset, _] = index_buffer.Map(index_buffer_size, 4);
+            std::memcpy(index_ptr, index_data, index_buffer_size);
+            index_buffer.Commit(index_buffer_size);
+            bound_index_buffer = index_buffer.GetHandle();
+            bound_index_offset = index_offset;
+        }
 
         // Submit draw
-        command_buffer.drawIndexed(regs.pipeline.num_vertices, 1, 0, 0, 0);
+        scheduler.Record([bound_index_buffer, bound_index_offset, index_type,
+                          num_vertices](vk::CommandBuffer command_buffer) {
+            command_buffer.bindIndexBuffer(bound_index_buffer, bound_index_offset, index_type);
+            command_buffer.drawIndexed(num_vertices, 1, 0, 0, 0);
+        });
     } else {
-        command_buffer.draw(regs.pipeline.num_vertices, 1, 0, 0);
+        scheduler.Record([num_vertices](vk::CommandBuffer command_buffer) {
+            command_buffer.draw(num_vertices, 1, 0, 0);
+        });
     }
 
     return true;
@@ -678,8 +704,6 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
         }
     };
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-
     // Sync and bind the texture surfaces
     const auto pica_textures = regs.texturing.GetTextures();
     for (unsigned texture_index = 0; texture_index < pica_textures.size(); ++texture_index) {
@@ -725,7 +749,7 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
 
                     auto surface = res_cache.GetTextureCube(config);
                     if (surface != nullptr) {
-                        runtime.Transition(command_buffer, surface->alloc,
+                        runtime.Transition(surface->alloc,
                                            vk::ImageLayout::eShaderReadOnlyOptimal,
                                            0, surface->alloc.levels, 0, 6);
                         pipeline_cache.BindTexture(3, surface->alloc.image_view);
@@ -746,7 +770,7 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
 
             auto surface = res_cache.GetTextureSurface(texture);
             if (surface != nullptr) {
-                runtime.Transition(command_buffer, surface->alloc,
+                runtime.Transition(surface->alloc,
                                    vk::ImageLayout::eShaderReadOnlyOptimal,
                                    0, surface->alloc.levels);
                 CheckBarrier(surface->alloc.image_view, texture_index);
@@ -801,14 +825,21 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
         it->second = CreateFramebuffer(framebuffer_info);
     }
 
+    // Switching render targets finishes rendering to the previous ones, copy those
+    // the guest usually reads back while the GPU is still busy
+    if (it->second != current_framebuffer) {
+        res_cache.QueueReadbacks();
+        current_framebuffer = it->second;
+    }
+
     if (color_surface) {
-        runtime.Transition(command_buffer, color_surface->alloc,
+        runtime.Transition(color_surface->alloc,
                            vk::ImageLayout::eColorAttachmentOptimal,
                            0, color_surface->alloc.levels);
     }
 
     if (depth_surface) {
-        runtime.Transition(command_buffer, depth_surface->alloc,
+        runtime.Transition(depth_surface->alloc,
                            vk::ImageLayout::eDepthStencilAttachmentOptimal,
                            0, depth_surface->alloc.levels);
     }
@@ -841,8 +872,10 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
         // Bind the vertex buffer at the current mapped offset. This effectively means
         // that when base_vertex is zero the GPU will start drawing from the current mapped
         // offset not the start of the buffer.
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-        command_buffer.bindVertexBuffers(0, vertex_buffer.GetHandle(), vertex_buffer.GetBufferOffset());
+        scheduler.Record([buffer = vertex_buffer.GetHandle(),
+                          offset = vertex_buffer.GetBufferOffset()](vk::CommandBuffer command_buffer) {
+            command_buffer.bindVertexBuffers(0, buffer, offset);
+        });
 
         const u32 max_vertices = VERTEX_BUFFER_SIZE / sizeof(HardwareVertex);
         const u32 batch_size = static_cast<u32>(vertex_batch.size());
@@ -855,7 +888,9 @@ bool RasterizerVulkan::Draw(bool accelerate, bool is_indexed) {
             std::memcpy(array_ptr, vertex_batch.data() + base_vertex, vertex_size);
             vertex_buffer.Commit(vertex_size);
 
-            command_buffer.draw(vertices, 1, base_vertex, 0);
+            scheduler.Record([vertices, base_vertex](vk::CommandBuffer command_buffer) {
+                command_buffer.draw(vertices, 1, base_vertex, 0);
+            });
         }
     }
 
@@ -1620,12 +1655,38 @@ vk::Framebuffer RasterizerVulkan::CreateFramebuffer(const FramebufferInfo& info)
 }
 
 void RasterizerVulkan::FlushBuffers() {
+    res_cache.QueueReadbacks();
+
+    // Release recycled textures first, then evict surfaces if that was not enough
+    const std::vector<vk::ImageView> destroyed_views = runtime.TrimRecycler();
+    if (!destroyed_views.empty()) {
+        vk::Device device = instance.GetDevice();
+        std::erase_if(framebuffers, [&](const auto& pair) {
+            const auto& [info, framebuffer] = pair;
+            const bool is_destroyed = std::ranges::any_of(destroyed_views, [&](vk::ImageView view) {
+                return view == info.color || view == info.depth;
+            });
+
+            if (is_destroyed) {
+                device.destroyFramebuffer(framebuffer);
+            }
+            return is_destroyed;
+        });
+
+        current_framebuffer = vk::Framebuffer{};
+    }
+
     vertex_buffer.Flush();
     uniform_buffer.Flush();
     index_buffer.Flush();
     texture_buffer.Flush();
     texture_lf_buffer.Flush();
     pipeline_cache.MarkDescriptorSetsDirty();
+    vs_uniform_slot = SCHEDULER_COMMAND_COUNT;
+}
+
+void RasterizerVulkan::TickFrame() {
+    res_cache.TickFrame();
 }
 
 void RasterizerVulkan::SetShader() {
@@ -1649,9 +1710,12 @@ void RasterizerVulkan::SyncClipCoef() {
 void RasterizerVulkan::SyncCullMode() {
     const auto& regs = Pica::g_state.regs;
     if (instance.IsExtendedDynamicStateSupported()) {
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-        command_buffer.setCullModeEXT(PicaToVK::CullMode(regs.rasterizer.cull_mode));
-        command_buffer.setFrontFaceEXT(PicaToVK::FrontFace(regs.rasterizer.cull_mode));
+        scheduler.Record([cull_mode = PicaToVK::CullMode(regs.rasterizer.cull_mode),
+                          front_face = PicaToVK::FrontFace(regs.rasterizer.cull_mode)](
+                             vk::CommandBuffer command_buffer) {
+            command_buffer.setCullModeEXT(cull_mode);
+            command_buffer.setFrontFaceEXT(front_face);
+        });
     }
 
     pipeline_info.rasterization.cull_mode.Assign(regs.rasterizer.cull_mode);
@@ -1694,8 +1758,9 @@ void RasterizerVulkan::SyncBlendColor() {
     auto blend_color =
         PicaToVK::ColorRGBA8(Pica::g_state.regs.framebuffer.output_merger.blend_const.raw);
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.setBlendConstants(blend_color.AsArray());
+    scheduler.Record([blend_color](vk::CommandBuffer command_buffer) {
+        command_buffer.setBlendConstants(blend_color.AsArray());
+    });
 }
 
 void RasterizerVulkan::SyncFogColor() {
@@ -1761,8 +1826,10 @@ void RasterizerVulkan::SyncStencilWriteMask() {
             ? static_cast<u32>(regs.framebuffer.output_merger.stencil_test.write_mask)
             : 0;
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.setStencilWriteMask(vk::StencilFaceFlagBits::eFrontAndBack, pipeline_info.depth_stencil.stencil_write_mask);
+    scheduler.Record([write_mask = pipeline_info.depth_stencil.stencil_write_mask](
+                         vk::CommandBuffer command_buffer) {
+        command_buffer.setStencilWriteMask(vk::StencilFaceFlagBits::eFrontAndBack, write_mask);
+    });
 }
 
 void RasterizerVulkan::SyncDepthWriteMask() {
@@ -1772,8 +1839,9 @@ void RasterizerVulkan::SyncDepthWriteMask() {
             regs.framebuffer.output_merger.depth_write_enable);
 
     if (instance.IsExtendedDynamicStateSupported()) {
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-        command_buffer.setDepthWriteEnableEXT(write_enable);
+        scheduler.Record([write_enable](vk::CommandBuffer command_buffer) {
+            command_buffer.setDepthWriteEnableEXT(write_enable);
+        });
     }
 
     pipeline_info.depth_stencil.depth_write_enable.Assign(write_enable);
@@ -1786,17 +1854,24 @@ void RasterizerVulkan::SyncStencilTest() {
             regs.framebuffer.framebuffer.depth_format == Pica::FramebufferRegs::DepthFormat::D24S8;
     const auto& stencil_test = regs.framebuffer.output_merger.stencil_test;
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.setStencilCompareMask(vk::StencilFaceFlagBits::eFrontAndBack, stencil_test.input_mask);
-    command_buffer.setStencilReference(vk::StencilFaceFlagBits::eFrontAndBack, stencil_test.reference_value);
+    const u32 compare_mask = stencil_test.input_mask;
+    const u32 reference = stencil_test.reference_value;
+    scheduler.Record([compare_mask, reference](vk::CommandBuffer command_buffer) {
+        command_buffer.setStencilCompareMask(vk::StencilFaceFlagBits::eFrontAndBack, compare_mask);
+        command_buffer.setStencilReference(vk::StencilFaceFlagBits::eFrontAndBack, reference);
+    });
 
     if (instance.IsExtendedDynamicStateSupported()) {
-        command_buffer.setStencilTestEnableEXT(test_enable);
-        command_buffer.setStencilOpEXT(vk::StencilFaceFlagBits::eFrontAndBack,
-                                       PicaToVK::StencilOp(stencil_test.action_stencil_fail),
-                                       PicaToVK::StencilOp(stencil_test.action_depth_pass),
-                                       PicaToVK::StencilOp(stencil_test.action_depth_fail),
-                                       PicaToVK::CompareFunc(stencil_test.func));
+        scheduler.Record([test_enable,
+                          fail_op = PicaToVK::StencilOp(stencil_test.action_stencil_fail),
+                          pass_op = PicaToVK::StencilOp(stencil_test.action_depth_pass),
+                          depth_fail_op = PicaToVK::StencilOp(stencil_test.action_depth_fail),
+                          compare_op = PicaToVK::CompareFunc(stencil_test.func)](
+                             vk::CommandBuffer command_buffer) {
+            command_buffer.setStencilTestEnableEXT(test_enable);
+            command_buffer.setStencilOpEXT(vk::StencilFaceFlagBits::eFrontAndBack, fail_op,
+                                           pass_op, depth_fail_op, compare_op);
+        });
     }
 
     pipeline_info.depth_stencil.stencil_test_enable.Assign(test_enable);
@@ -1818,9 +1893,11 @@ void RasterizerVulkan::SyncDepthTest() {
             : Pica::FramebufferRegs::CompareFunc::Always;
 
     if (instance.IsExtendedDynamicStateSupported()) {
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-        command_buffer.setDepthCompareOpEXT(PicaToVK::CompareFunc(compare_op));
-        command_buffer.setDepthTestEnableEXT(test_enabled);
+        scheduler.Record([depth_compare_op = PicaToVK::CompareFunc(compare_op),
+                          test_enabled](vk::CommandBuffer command_buffer) {
+            command_buffer.setDepthCompareOpEXT(depth_compare_op);
+            command_buffer.setDepthTestEnableEXT(test_enabled);
+        });
     }
 
     pipeline_info.depth_stencil.depth_test_enable.Assign(test_enabled);
@@ -2119,7 +2196,14 @@ void RasterizerVulkan::SyncAndUploadLUTs() {
 }
 
 void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
-    const bool sync_vs = accelerate_draw;
+    // Only convert the uniform rows that changed. The previous upload is reused as long as it
+    // lives in the stream buffer bucket of the current command slot.
+    bool sync_vs = false;
+    if (accelerate_draw) {
+        const bool vs_dirty =
+            vs_uniform_data.uniforms.SyncDirtyFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
+        sync_vs = vs_dirty || vs_uniform_slot != scheduler.GetCurrentSlotIndex();
+    }
     const bool sync_fs = uniform_block_data.dirty;
 
     if (!sync_vs && !sync_fs) {
@@ -2132,11 +2216,11 @@ void RasterizerVulkan::UploadUniforms(bool accelerate_draw) {
                                                              static_cast<u32>(uniform_buffer_alignment));
 
     if (sync_vs) {
-        Pica::Shader::VSUniformData vs_uniforms;
-        vs_uniforms.uniforms.SetFromRegs(Pica::g_state.regs.vs, Pica::g_state.vs);
-        std::memcpy(uniforms + used_bytes, &vs_uniforms, sizeof(vs_uniforms));
+        std::memcpy(uniforms + used_bytes, &vs_uniform_data, sizeof(vs_uniform_data));
 
-        pipeline_cache.BindBuffer(0, uniform_buffer.GetHandle(), offset + used_bytes, sizeof(vs_uniforms));
+        pipeline_cache.BindBuffer(0, uniform_buffer.GetHandle(), offset + used_bytes,
+                                  sizeof(vs_uniform_data));
+        vs_uniform_slot = scheduler.GetCurrentSlotIndex();
         used_bytes += static_cast<u32>(uniform_size_aligned_vs);
     }
 
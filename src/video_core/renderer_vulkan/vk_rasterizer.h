@@ -9,6 +9,7 @@
 #include "video_core/rasterizer_accelerated.h"
 #include "video_core/regs_lighting.h"
 #include "video_core/regs_texturing.h"
+#include "video_core/renderer_vulkan/vk_geometry_cache.h"
 #include "video_core/renderer_vulkan/vk_stream_buffer.h"
 #include "video_core/renderer_vulkan/vk_pipeline_cache.h"
 #include "video_core/renderer_vulkan/vk_texture_runtime.h"
@@ -106,9 +107,19 @@ public:
     /// Sync fixed function pipeline state
     void SyncFixedState();
 
-    /// Flushes all rasterizer owned buffers
+    /// Flushes all rasterizer owned buffers, queues pending surface readbacks and
+    /// releases recycled textures when over the memory budget
     void FlushBuffers();
 
+    /// Advances the texture cache to the next presented frame, evicting surfaces when over
+    /// the memory budget
+    void TickFrame();
+
+    /// Returns the residency counters of the texture cache
+    const VideoCore::CacheStats& GetCacheStats() const {
+        return res_cache.GetStats();
+    }
+
 private:
     /// Syncs the clip enabled status to match the PICA register
     void SyncClipEnabled();
@@ -287,18 +298,23 @@ private:
         bool dirty = true;
     } uniform_block_data = {};
 
+    Pica::Shader::VSUniformData vs_uniform_data{};
+    u32 vs_uniform_slot = SCHEDULER_COMMAND_COUNT; ///< Command slot of the last VS uniform upload
+
     std::array<bool, 16> hw_enabled_attributes{};
 
     std::array<SamplerInfo, 3> texture_samplers;
     SamplerInfo texture_cube_sampler;
     std::unordered_map<SamplerInfo, vk::Sampler> samplers;
     std::unordered_map<FramebufferInfo, vk::Framebuffer> framebuffers;
+    vk::Framebuffer current_framebuffer{}; ///< Framebuffer of the last draw
 
     StreamBuffer vertex_buffer;
     StreamBuffer uniform_buffer;
     StreamBuffer index_buffer;
     StreamBuffer texture_buffer;
     StreamBuffer texture_lf_buffer;
+    GeometryCache geometry_cache;
     PipelineInfo pipeline_info;
     std::size_t uniform_buffer_alignment;
     std::size_t uniform_size_aligned_vs;
@@ -80,12 +80,24 @@ void RenderpassCache::EnterRenderpass(const vk::RenderPassBeginInfo begin_info)
         return;
     }
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    if (active_renderpass) {
-        command_buffer.endRenderPass();
+    // The clear values are referenced by pointer, copy them so they outlive the caller
+    ASSERT(begin_info.clearValueCount <= 1);
+    vk::ClearValue clear_value{};
+    if (begin_info.clearValueCount > 0) {
+        clear_value = begin_info.pClearValues[0];
     }
 
-    command_buffer.beginRenderPass(begin_info, vk::SubpassContents::eInline);
+    scheduler.Record([end_active = static_cast<bool>(active_renderpass), begin_info,
+                      clear_value](vk::CommandBuffer command_buffer) {
+        if (end_active) {
+            command_buffer.endRenderPass();
+        }
+
+        vk::RenderPassBeginInfo info = begin_info;
+        info.pClearValues = info.clearValueCount > 0 ? &clear_value : nullptr;
+        command_buffer.beginRenderPass(info, vk::SubpassContents::eInline);
+    });
+
     active_renderpass = begin_info.renderPass;
 }
 
@@ -94,8 +106,10 @@ void RenderpassCache::ExitRenderpass() {
         return;
     }
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    command_buffer.endRenderPass();
+    scheduler.Record([](vk::CommandBuffer command_buffer) {
+        command_buffer.endRenderPass();
+    });
+
     active_renderpass = VK_NULL_HANDLE;
 }
 
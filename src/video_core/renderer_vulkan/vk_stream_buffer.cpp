@@ -39,16 +39,21 @@ inline auto ToVkAccessStageFlags(vk::BufferUsageFlagBits usage) {
     return result;
 }
 
-StagingBuffer::StagingBuffer(const Instance& instance, u32 size, vk::BufferUsageFlags usage)
+StagingBuffer::StagingBuffer(const Instance& instance, u32 size, vk::BufferUsageFlags usage,
+                             bool readback)
     : instance{instance} {
     const vk::BufferCreateInfo buffer_info = {
         .size = size,
         .usage = usage
     };
 
+    // Readback buffers are read by the CPU so prefer cached memory for them
+    const VmaAllocationCreateFlags access_flags = readback ?
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT :
+            VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+
     const VmaAllocationCreateInfo alloc_create_info = {
-        .flags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT |
-                VMA_ALLOCATION_CREATE_MAPPED_BIT,
+        .flags = access_flags | VMA_ALLOCATION_CREATE_MAPPED_BIT,
         .usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST
     };
 
@@ -151,7 +156,6 @@ void StreamBuffer::Flush() {
     ASSERT(flush_size <= bucket_size);
 
     if (flush_size > 0) {
-        vk::CommandBuffer command_buffer = scheduler.GetUploadCommandBuffer();
         VmaAllocator allocator = instance.GetAllocator();
 
         const u32 flush_start = current_bucket * bucket_size;
@@ -162,7 +166,6 @@ void StreamBuffer::Flush() {
         };
 
         vmaFlushAllocation(allocator, allocation, flush_start, flush_size);
-        command_buffer.copyBuffer(staging.buffer, buffer, copy_region);
 
         // Add pipeline barrier for the flushed region
         auto [access_mask, stage_mask] = ToVkAccessStageFlags(usage);
@@ -176,12 +179,18 @@ void StreamBuffer::Flush() {
             .size = flush_size
         };
 
-        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, stage_mask,
-                                       vk::DependencyFlagBits::eByRegion, {}, buffer_barrier, {});
+        scheduler.RecordUpload([src = staging.buffer, dst = buffer, copy_region,
+                                dst_stage = stage_mask,
+                                buffer_barrier](vk::CommandBuffer command_buffer) {
+            command_buffer.copyBuffer(src, dst, copy_region);
+            command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer, dst_stage,
+                                           vk::DependencyFlagBits::eByRegion, {},
+                                           buffer_barrier, {});
+        });
     }
 
     // Reset the offset of the next bucket
-    const u32 next_bucket = (current_bucket + 1) % SCHEDULER_COMMAND_COUNT;
+    const u32 next_bucket = scheduler.GetNextSlotIndex();
     buckets[next_bucket].offset = 0;
     buckets[next_bucket].invalid = true;
 }
@@ -22,7 +22,8 @@ struct LockedRegion {
 };
 
 struct StagingBuffer {
-    StagingBuffer(const Instance& instance, u32 size, vk::BufferUsageFlags usage);
+    StagingBuffer(const Instance& instance, u32 size, vk::BufferUsageFlags usage,
+                  bool readback = false);
     ~StagingBuffer();
 
     const Instance& instance;
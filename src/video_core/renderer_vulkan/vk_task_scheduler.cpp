@@ -3,14 +3,17 @@
 // Refer to the license.txt file included.
 
 #define VULKAN_HPP_NO_CONSTRUCTORS
+#include <algorithm>
 #include "common/assert.h"
 #include "common/logging/log.h"
+#include "common/thread.h"
 #include "video_core/renderer_vulkan/vk_task_scheduler.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 
 namespace Vulkan {
 
-TaskScheduler::TaskScheduler(const Instance& instance) : instance{instance} {
+TaskScheduler::TaskScheduler(const Instance& instance, u32 frames_in_flight)
+    : instance{instance}, slot_count{std::clamp(frames_in_flight, 1u, SCHEDULER_COMMAND_COUNT)} {
     vk::Device device = instance.GetDevice();
     const vk::CommandPoolCreateInfo command_pool_info = {
         .flags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer,
@@ -65,17 +68,21 @@ TaskScheduler::TaskScheduler(const Instance& instance) : instance{instance} {
         };
     }
 
-    const vk::CommandBufferBeginInfo begin_info = {
-        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
-    };
+    // Begin first command. The command buffers are begun by the worker thread when it
+    // receives the first chunk of the slot.
+    commands[current_command].fence_counter = next_fence_counter++;
 
-    // Begin first command
-    auto& command = commands[current_command];
-    command.render_command_buffer.begin(begin_info);
-    command.fence_counter = next_fence_counter++;
+    AcquireNewChunk();
+    worker_thread = std::jthread([this](std::stop_token stop_token) {
+        WorkerThread(stop_token);
+    });
 }
 
 TaskScheduler::~TaskScheduler() {
+    WaitWorker();
+    worker_thread.request_stop();
+    worker_thread.join();
+
     vk::Device device = instance.GetDevice();
     device.waitIdle();
 
@@ -94,61 +101,218 @@ TaskScheduler::~TaskScheduler() {
 }
 
 void TaskScheduler::Synchronize(u32 slot) {
-    const auto& command = commands[slot];
+    auto& command = commands[slot];
+    if (command.submitted) {
+        WaitFence(command.fence_counter);
+        command.submitted = false;
+    }
+
     vk::Device device = instance.GetDevice();
+    device.resetFences(command.fence);
+    device.resetDescriptorPool(command.descriptor_pool);
+}
 
-    u32 completed_counter = completed_fence_counter;
-    if (instance.IsTimelineSemaphoreSupported()) {
-        completed_counter = device.getSemaphoreCounterValue(timeline);
+void TaskScheduler::WaitFence(u64 counter) {
+    if (counter <= completed_fence_counter) {
+        return;
     }
 
-    if (command.fence_counter > completed_counter) {
-        if (instance.IsTimelineSemaphoreSupported()) {
-            const vk::SemaphoreWaitInfo wait_info = {
-                .semaphoreCount = 1,
-                .pSemaphores = &timeline,
-                .pValues = &command.fence_counter
-            };
+    ASSERT_MSG(counter < commands[current_command].fence_counter,
+               "Waiting for fence counter {} that has not been submitted", counter);
 
-            if (device.waitSemaphores(wait_info, UINT64_MAX) != vk::Result::eSuccess) {
-                LOG_ERROR(Render_Vulkan, "Waiting for fence counter {} failed!", command.fence_counter);
-                UNREACHABLE();
-            }
+    // The worker thread might not have handed the submission to the driver yet
+    WaitSubmitted(counter);
 
-        } else if (device.waitForFences(command.fence, true, UINT64_MAX) != vk::Result::eSuccess) {
-            LOG_ERROR(Render_Vulkan, "Waiting for fence counter {} failed!", command.fence_counter);
+    vk::Device device = instance.GetDevice();
+    if (instance.IsTimelineSemaphoreSupported()) {
+        const vk::SemaphoreWaitInfo wait_info = {
+            .semaphoreCount = 1,
+            .pSemaphores = &timeline,
+            .pValues = &counter
+        };
+
+        if (device.waitSemaphores(wait_info, UINT64_MAX) != vk::Result::eSuccess) {
+            LOG_ERROR(Render_Vulkan, "Waiting for fence counter {} failed!", counter);
             UNREACHABLE();
         }
 
-        completed_fence_counter = command.fence_counter;
+        completed_fence_counter = counter;
+        return;
     }
 
-    device.resetFences(command.fence);
-    device.resetDescriptorPool(command.descriptor_pool);
+    for (const auto& command : commands) {
+        if (command.submitted && command.fence_counter == counter) {
+            if (device.waitForFences(command.fence, true, UINT64_MAX) != vk::Result::eSuccess) {
+                LOG_ERROR(Render_Vulkan, "Waiting for fence counter {} failed!", counter);
+                UNREACHABLE();
+            }
+
+            completed_fence_counter = counter;
+            return;
+        }
+    }
+
+    // The slot was already recycled, which only happens after its fence was waited on
+    completed_fence_counter = counter;
 }
 
-void TaskScheduler::WaitFence(u32 counter) {
-    for (u32 i = 0; i < SCHEDULER_COMMAND_COUNT; i++) {
-        if (commands[i].fence_counter == counter) {
-            return Synchronize(i);
+bool TaskScheduler::IsFenceSignaled(u64 counter) {
+    if (counter <= completed_fence_counter) {
+        return true;
+    }
+
+    if (counter > submitted_fence_counter.load(std::memory_order_acquire)) {
+        return false;
+    }
+
+    vk::Device device = instance.GetDevice();
+    if (instance.IsTimelineSemaphoreSupported()) {
+        completed_fence_counter = device.getSemaphoreCounterValue(timeline);
+        return counter <= completed_fence_counter;
+    }
+
+    for (const auto& command : commands) {
+        if (command.submitted && command.fence_counter == counter) {
+            if (device.getFenceStatus(command.fence) != vk::Result::eSuccess) {
+                return false;
+            }
+
+            completed_fence_counter = counter;
+            return true;
         }
     }
 
-    LOG_CRITICAL(Render_Vulkan,"Invalid fence counter {}!", counter);
-    UNREACHABLE();
+    return counter < commands[current_command].fence_counter;
 }
 
 void TaskScheduler::Submit(SubmitMode mode) {
-    const auto& command = commands[current_command];
-    command.render_command_buffer.end();
-    if (command.use_upload_buffer) {
-        command.upload_command_buffer.end();
+    auto& command = commands[current_command];
+    chunk->MarkSubmit(mode, command.fence_counter, command.use_upload_buffer);
+    DispatchWork();
+
+    command.submitted = true;
+
+    // Block host until the GPU completes this submission. Later submissions are not waited on.
+    if (True(mode & SubmitMode::Flush)) {
+        WaitFence(command.fence_counter);
+    }
+
+    // Switch to next cmdbuffer.
+    if (False(mode & SubmitMode::Shutdown)) {
+        SwitchSlot();
+    } else {
+        WaitWorker();
+    }
+}
+
+void TaskScheduler::DispatchWork() {
+    if (chunk->Empty() && !chunk->submit) {
+        return;
     }
 
+    chunk->slot = current_command;
+    {
+        std::scoped_lock lock{work_mutex};
+        dispatched_chunks++;
+        work_queue.push(std::move(chunk));
+    }
+
+    work_cv.notify_one();
+    AcquireNewChunk();
+}
+
+void TaskScheduler::WaitWorker() {
+    DispatchWork();
+
+    std::unique_lock lock{work_mutex};
+    processed_cv.wait(lock, [this] { return processed_chunks == dispatched_chunks; });
+}
+
+void TaskScheduler::WaitSubmitted(u64 counter) {
+    if (counter <= submitted_fence_counter.load(std::memory_order_acquire)) {
+        return;
+    }
+
+    std::unique_lock lock{work_mutex};
+    processed_cv.wait(lock, [this, counter] {
+        return counter <= submitted_fence_counter.load(std::memory_order_acquire);
+    });
+}
+
+void TaskScheduler::AcquireNewChunk() {
+    std::scoped_lock lock{reserve_mutex};
+    if (chunk_reserve.empty()) {
+        chunk = std::make_unique<CommandChunk>();
+        return;
+    }
+
+    chunk = std::move(chunk_reserve.back());
+    chunk_reserve.pop_back();
+}
+
+void TaskScheduler::WorkerThread(std::stop_token stop_token) {
+    Common::SetCurrentThreadName("VulkanWorker");
+
+    while (!stop_token.stop_requested()) {
+        std::unique_ptr<CommandChunk> work;
+        {
+            std::unique_lock lock{work_mutex};
+            if (!work_cv.wait(lock, stop_token, [this] { return !work_queue.empty(); })) {
+                return;
+            }
+
+            work = std::move(work_queue.front());
+            work_queue.pop();
+        }
+
+        ExecuteChunk(*work);
+        {
+            std::scoped_lock lock{reserve_mutex};
+            chunk_reserve.push_back(std::move(work));
+        }
+        {
+            std::scoped_lock lock{work_mutex};
+            processed_chunks++;
+        }
+
+        processed_cv.notify_all();
+    }
+}
+
+void TaskScheduler::ExecuteChunk(CommandChunk& chunk) {
+    auto& command = commands[chunk.slot];
+    if (!command.recording) {
+        const vk::CommandBufferBeginInfo begin_info = {
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
+        };
+
+        // The upload buffer is always begun so its state matches the render buffer. It is only
+        // submitted when upload commands were recorded to it.
+        command.render_command_buffer.begin(begin_info);
+        command.upload_command_buffer.begin(begin_info);
+        command.recording = true;
+    }
+
+    chunk.ExecuteAll(command.render_command_buffer, command.upload_command_buffer);
+
+    if (chunk.submit) {
+        SubmitExecution(chunk.slot, chunk.submit_mode, chunk.submit_fence_counter,
+                        chunk.submit_upload_buffer);
+        chunk.submit = false;
+    }
+}
+
+void TaskScheduler::SubmitExecution(u32 slot, SubmitMode mode, u64 fence_counter,
+                                    bool use_upload_buffer) {
+    auto& command = commands[slot];
+    command.render_command_buffer.end();
+    command.upload_command_buffer.end();
+    command.recording = false;
+
     u32 command_buffer_count = 0;
     std::array<vk::CommandBuffer, 2> command_buffers;
 
-    if (command.use_upload_buffer) {
+    if (use_upload_buffer) {
         command_buffers[command_buffer_count++] = command.upload_command_buffer;
     }
 
@@ -156,12 +320,14 @@ void TaskScheduler::Submit(SubmitMode mode) {
 
     const bool swapchain_sync = True(mode & SubmitMode::SwapchainSynced);
     if (instance.IsTimelineSemaphoreSupported()) {
-        const u32 wait_semaphore_count = swapchain_sync ? 2u : 1u;
-        const std::array wait_values{command.fence_counter - 1, 1ul};
-        const std::array wait_semaphores{timeline, command.image_acquired};
+        // Submissions on the same queue are already ordered by their pipeline barriers, so only
+        // the swapchain image has to be waited on. The timeline value identifies this submission.
+        const u32 wait_semaphore_count = swapchain_sync ? 1u : 0u;
+        const std::array<u64, 1> wait_values{0};
+        const std::array wait_semaphores{command.image_acquired};
 
         const u32 signal_semaphore_count = swapchain_sync ? 2u : 1u;
-        const std::array signal_values{command.fence_counter, 0ul};
+        const std::array<u64, 2> signal_values{fence_counter, 0};
         const std::array signal_semaphores{timeline, command.present_ready};
 
         const vk::TimelineSemaphoreSubmitInfoKHR timeline_si = {
@@ -171,8 +337,7 @@ void TaskScheduler::Submit(SubmitMode mode) {
             .pSignalSemaphoreValues = signal_values.data()
         };
 
-        const std::array<vk::PipelineStageFlags, 2> wait_stage_masks = {
-            vk::PipelineStageFlagBits::eAllCommands,
+        const std::array<vk::PipelineStageFlags, 1> wait_stage_masks = {
             vk::PipelineStageFlagBits::eColorAttachmentOutput,
         };
 
@@ -210,15 +375,7 @@ void TaskScheduler::Submit(SubmitMode mode) {
         queue.submit(submit_info, command.fence);
     }
 
-    // Block host until the GPU catches up
-    if (True(mode & SubmitMode::Flush)) {
-        Synchronize(current_command);
-    }
-
-    // Switch to next cmdbuffer.
-    if (False(mode & SubmitMode::Shutdown)) {
-        SwitchSlot();
-    }
+    submitted_fence_counter.store(fence_counter, std::memory_order_release);
 }
 
 u64 TaskScheduler::GetFenceCounter() const {
@@ -230,35 +387,30 @@ u64 TaskScheduler::GetFenceCounter() const {
     return completed_fence_counter;
 }
 
-vk::CommandBuffer TaskScheduler::GetUploadCommandBuffer() {
-    auto& command = commands[current_command];
-    if (!command.use_upload_buffer) {
-        const vk::CommandBufferBeginInfo begin_info = {
-            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
-        };
-
-        command.upload_command_buffer.begin(begin_info);
-        command.use_upload_buffer = true;
-    }
-
-    return command.upload_command_buffer;
-}
-
 void TaskScheduler::SwitchSlot() {
-    current_command = (current_command + 1) % SCHEDULER_COMMAND_COUNT;
+    current_command = GetNextSlotIndex();
     auto& command = commands[current_command];
 
     // Wait for the GPU to finish with all resources for this command.
     Synchronize(current_command);
 
-    const vk::CommandBufferBeginInfo begin_info = {
-        .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit
-    };
-
-    // Begin the next command buffer.
-    command.render_command_buffer.begin(begin_info);
     command.fence_counter = next_fence_counter++;
     command.use_upload_buffer = false;
 }
 
+void TaskScheduler::CommandChunk::ExecuteAll(vk::CommandBuffer render_cmdbuf,
+                                             vk::CommandBuffer upload_cmdbuf) {
+    auto command = first;
+    while (command != nullptr) {
+        auto next = command->GetNext();
+        command->Execute(render_cmdbuf, upload_cmdbuf);
+        command->~Command();
+        command = next;
+    }
+
+    command_offset = 0;
+    first = nullptr;
+    last = nullptr;
+}
+
 }  // namespace Vulkan
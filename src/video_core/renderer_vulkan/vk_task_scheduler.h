@@ -4,11 +4,22 @@
 
 #pragma once
 
-#include <memory>
 #include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
 #include <functional>
-#include "common/common_types.h"
+#include <memory>
+#include <mutex>
+#include <new>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+#include "common/alignment.h"
+#include "common/assert.h"
 #include "common/common_funcs.h"
+#include "common/common_types.h"
 #include "video_core/renderer_vulkan/vk_common.h"
 
 namespace Vulkan {
@@ -24,31 +35,70 @@ enum class SubmitMode : u8 {
 
 DECLARE_ENUM_FLAG_OPERATORS(SubmitMode);
 
+/**
+ * Owns the command buffers of every frame in flight. Commands are recorded as closures on the
+ * emulation thread and translated into Vulkan calls on a dedicated worker thread, which also
+ * submits them to the graphics queue. Only the worker thread touches the command buffers.
+ */
 class TaskScheduler {
 public:
-    TaskScheduler(const Instance& instance);
+    /**
+     * @param frames_in_flight Number of command slots the CPU may record ahead of the GPU.
+     * Clamped to [1, SCHEDULER_COMMAND_COUNT].
+     */
+    explicit TaskScheduler(const Instance& instance, u32 frames_in_flight = SCHEDULER_COMMAND_COUNT);
     ~TaskScheduler();
 
-    /// Blocks the host until the current command completes execution
-    void Synchronize(u32 slot);
+    /// Blocks the host until the GPU completes the submission with the provided fence counter
+    void WaitFence(u64 counter);
 
-    /// Waits for the fence counter to be reached by the GPU
-    void WaitFence(u32 counter);
+    /// Returns true when the GPU has completed the submission with the provided fence counter
+    bool IsFenceSignaled(u64 counter);
 
-    /// Submits the current command to the graphics queue
+    /// Hands the current command to the worker thread for submission to the graphics queue
     void Submit(SubmitMode mode);
 
     /// Returns the last completed fence counter
     u64 GetFenceCounter() const;
 
-    /// Returns the command buffer used for early upload operations.
-    vk::CommandBuffer GetUploadCommandBuffer();
+    /// Returns the fence counter that the command currently being recorded will signal
+    u64 GetCurrentFenceCounter() const {
+        return commands[current_command].fence_counter;
+    }
+
+    /**
+     * Records a command to the render command buffer of the current slot. The command is
+     * executed later by the worker thread, so it must capture everything it needs by value.
+     * @param command Callable with the signature void(vk::CommandBuffer)
+     */
+    template <typename T>
+    void Record(T&& command) {
+        RecordCommand([command = std::forward<T>(command)](vk::CommandBuffer render_cmdbuf,
+                                                           vk::CommandBuffer) {
+            command(render_cmdbuf);
+        });
+    }
 
-    /// Returns the command buffer used for rendering
-    vk::CommandBuffer GetRenderCommandBuffer() const {
-        return commands[current_command].render_command_buffer;
+    /**
+     * Records a command to the upload command buffer of the current slot, which is submitted
+     * before the render command buffer.
+     * @param command Callable with the signature void(vk::CommandBuffer)
+     */
+    template <typename T>
+    void RecordUpload(T&& command) {
+        commands[current_command].use_upload_buffer = true;
+        RecordCommand([command = std::forward<T>(command)](vk::CommandBuffer,
+                                                           vk::CommandBuffer upload_cmdbuf) {
+            command(upload_cmdbuf);
+        });
     }
 
+    /// Sends the recorded commands to the worker thread without submitting them
+    void DispatchWork();
+
+    /// Blocks the host until the worker thread has processed all dispatched commands
+    void WaitWorker();
+
     /// Returns the current descriptor pool
     vk::DescriptorPool GetDescriptorPool() const {
         return commands[current_command].descriptor_pool;
@@ -59,6 +109,16 @@ public:
         return current_command;
     }
 
+    /// Returns the index of the command slot that will be used after the next submission
+    u32 GetNextSlotIndex() const {
+        return (current_command + 1) % slot_count;
+    }
+
+    /// Returns the number of command slots in use
+    u32 GetSlotCount() const {
+        return slot_count;
+    }
+
     vk::Semaphore GetImageAcquiredSemaphore() const {
         return commands[current_command].image_acquired;
     }
@@ -68,16 +128,142 @@ public:
     }
 
 private:
+    /// A block of recorded commands, replayed in order on the command buffers of a slot
+    class CommandChunk final {
+    public:
+        /// Replays all recorded commands and destroys them
+        void ExecuteAll(vk::CommandBuffer render_cmdbuf, vk::CommandBuffer upload_cmdbuf);
+
+        /// Moves the command into the chunk, returns false when the chunk is full
+        template <typename T>
+        bool Record(T& command) {
+            using FuncType = TypedCommand<T>;
+            static_assert(sizeof(FuncType) < CHUNK_SIZE, "Command is too large");
+
+            const std::size_t offset = Common::AlignUp(command_offset, alignof(FuncType));
+            if (offset + sizeof(FuncType) > CHUNK_SIZE) {
+                return false;
+            }
+
+            Command* const current_last = last;
+            last = new (data.data() + offset) FuncType(std::move(command));
+
+            if (current_last) {
+                current_last->SetNext(last);
+            } else {
+                first = last;
+            }
+
+            command_offset = offset + sizeof(FuncType);
+            return true;
+        }
+
+        /// Marks the chunk as the last one of its slot
+        void MarkSubmit(SubmitMode mode, u64 fence_counter, bool use_upload_buffer) {
+            submit = true;
+            submit_mode = mode;
+            submit_fence_counter = fence_counter;
+            submit_upload_buffer = use_upload_buffer;
+        }
+
+        bool Empty() const {
+            return command_offset == 0;
+        }
+
+    public:
+        u32 slot = 0;
+        bool submit = false;
+        bool submit_upload_buffer = false;
+        SubmitMode submit_mode{};
+        u64 submit_fence_counter = 0;
+
+    private:
+        class Command {
+        public:
+            virtual ~Command() = default;
+
+            virtual void Execute(vk::CommandBuffer render_cmdbuf,
+                                 vk::CommandBuffer upload_cmdbuf) const = 0;
+
+            Command* GetNext() const {
+                return next;
+            }
+
+            void SetNext(Command* next_) {
+                next = next_;
+            }
+
+        private:
+            Command* next = nullptr;
+        };
+
+        template <typename T>
+        class TypedCommand final : public Command {
+        public:
+            explicit TypedCommand(T&& command_) : command{std::move(command_)} {}
+            ~TypedCommand() override = default;
+
+            TypedCommand(TypedCommand&&) = delete;
+            TypedCommand& operator=(TypedCommand&&) = delete;
+
+            void Execute(vk::CommandBuffer render_cmdbuf,
+                         vk::CommandBuffer upload_cmdbuf) const override {
+                command(render_cmdbuf, upload_cmdbuf);
+            }
+
+        private:
+            T command;
+        };
+
+        static constexpr std::size_t CHUNK_SIZE = 0x8000;
+
+        Command* first = nullptr;
+        Command* last = nullptr;
+        std::size_t command_offset = 0;
+        alignas(std::max_align_t) std::array<u8, CHUNK_SIZE> data{};
+    };
+
+    /// Appends the command to the current chunk, dispatching it when full
+    template <typename T>
+    void RecordCommand(T&& command) {
+        if (!chunk->Record(command)) {
+            DispatchWork();
+            const bool recorded = chunk->Record(command);
+            ASSERT(recorded);
+        }
+    }
+
+    /// Blocks the host until the provided slot completes execution and recycles its resources
+    void Synchronize(u32 slot);
+
     /// Activates the next command slot and optionally waits for its completion
     void SwitchSlot();
 
+    /// Returns a cleared chunk from the reserve or allocates a new one
+    void AcquireNewChunk();
+
+    /// Translates dispatched chunks into command buffer calls
+    void WorkerThread(std::stop_token stop_token);
+
+    /// Replays the chunk on the command buffers of its slot and submits them when requested
+    void ExecuteChunk(CommandChunk& chunk);
+
+    /// Ends the command buffers of the slot and submits them to the graphics queue
+    void SubmitExecution(u32 slot, SubmitMode mode, u64 fence_counter, bool use_upload_buffer);
+
+    /// Blocks the host until the worker thread has submitted the provided fence counter
+    void WaitSubmitted(u64 counter);
+
 private:
     const Instance& instance;
+    u32 slot_count;
     u64 next_fence_counter = 1;
     u64 completed_fence_counter = 0;
 
     struct ExecutionSlot {
         bool use_upload_buffer = false;
+        bool submitted = false;
+        bool recording = false; ///< Only accessed by the worker thread
         u64 fence_counter = 0;
         vk::Semaphore image_acquired;
         vk::Semaphore present_ready;
@@ -91,6 +277,19 @@ private:
     vk::Semaphore timeline{};
     std::array<ExecutionSlot, SCHEDULER_COMMAND_COUNT> commands{};
     u32 current_command = 0;
+
+    // Worker thread state
+    std::unique_ptr<CommandChunk> chunk;
+    std::queue<std::unique_ptr<CommandChunk>> work_queue;
+    std::vector<std::unique_ptr<CommandChunk>> chunk_reserve;
+    std::mutex work_mutex;
+    std::mutex reserve_mutex;
+    std::condition_variable_any work_cv;
+    std::condition_variable processed_cv;
+    u64 dispatched_chunks = 0;
+    u64 processed_chunks = 0;
+    std::atomic<u64> submitted_fence_counter = 0;
+    std::jthread worker_thread;
 };
 
 }  // namespace Vulkan
@@ -3,6 +3,8 @@
 // Refer to the license.txt file included.
 
 #define VULKAN_HPP_NO_CONSTRUCTORS
+#include <algorithm>
+#include "core/settings.h"
 #include "video_core/rasterizer_cache/utils.h"
 #include "video_core/renderer_vulkan/vk_instance.h"
 #include "video_core/renderer_vulkan/vk_renderpass_cache.h"
@@ -72,6 +74,7 @@ vk::FormatFeatureFlagBits ToVkFormatFeatures(VideoCore::SurfaceType type) {
 }
 
 constexpr u32 STAGING_BUFFER_SIZE = 16 * 1024 * 1024;
+constexpr u64 MAX_RECYCLED_READBACK_SIZE = 64 * 1024 * 1024;
 
 TextureRuntime::TextureRuntime(const Instance& instance, TaskScheduler& scheduler,
                                RenderpassCache& renderpass_cache)
@@ -89,9 +92,9 @@ TextureRuntime::~TextureRuntime() {
     vk::Device device = instance.GetDevice();
     device.waitIdle();
 
-    for (const auto& [key, alloc] : texture_recycler) {
-        vmaDestroyImage(allocator, alloc.image, alloc.allocation);
-        device.destroyImageView(alloc.image_view);
+    for (const auto& [key, recycled] : texture_recycler) {
+        vmaDestroyImage(allocator, recycled.alloc.image, recycled.alloc.allocation);
+        device.destroyImageView(recycled.alloc.image_view);
     }
 
     for (const auto& [key, framebuffer] : clear_framebuffers) {
@@ -135,7 +138,7 @@ ImageAlloc TextureRuntime::Allocate(u32 width, u32 height, VideoCore::PixelForma
 
     // Attempt to recycle an unused allocation
     if (auto it = texture_recycler.find(key); it != texture_recycler.end()) {
-        ImageAlloc alloc = std::move(it->second);
+        ImageAlloc alloc = std::move(it->second.alloc);
         texture_recycler.erase(it);
         return alloc;
     }
@@ -203,7 +206,125 @@ ImageAlloc TextureRuntime::Allocate(u32 width, u32 height, VideoCore::PixelForma
 }
 
 void TextureRuntime::Recycle(const VideoCore::HostTextureTag tag, ImageAlloc&& alloc) {
-    texture_recycler.emplace(tag, std::move(alloc));
+    texture_recycler.emplace(tag, RecycledImage{
+        .alloc = std::move(alloc),
+        .fence_counter = scheduler.GetCurrentFenceCounter()
+    });
+}
+
+u64 TextureRuntime::GetMemoryOverBudget() const {
+    VmaAllocator allocator = instance.GetAllocator();
+
+    const VkPhysicalDeviceMemoryProperties* properties{};
+    vmaGetMemoryProperties(allocator, &properties);
+
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator, budgets.data());
+
+    // Only device local heaps hold textures. Without VK_EXT_memory_budget VMA
+    // estimates the budget from the heap size and its own allocations
+    u64 usage = 0;
+    u64 budget = 0;
+    for (u32 i = 0; i < properties->memoryHeapCount; i++) {
+        if (properties->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            usage += budgets[i].usage;
+            budget += budgets[i].budget;
+        }
+    }
+
+    const u64 percent = std::clamp<u16>(Settings::values.vram_budget, 10, 100);
+    const u64 allowed = budget * percent / 100;
+    return usage > allowed ? usage - allowed : 0;
+}
+
+std::vector<vk::ImageView> TextureRuntime::TrimRecycler() {
+    std::vector<vk::ImageView> destroyed_views;
+    u64 over_budget = GetMemoryOverBudget();
+    if (over_budget == 0) {
+        return destroyed_views;
+    }
+
+    // Destroy images in the order they were recycled, skipping those still in use by the GPU
+    std::vector<decltype(texture_recycler)::iterator> candidates;
+    for (auto it = texture_recycler.begin(); it != texture_recycler.end(); it++) {
+        if (scheduler.IsFenceSignaled(it->second.fence_counter)) {
+            candidates.push_back(it);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->second.fence_counter < rhs->second.fence_counter;
+    });
+
+    VmaAllocator allocator = instance.GetAllocator();
+    vk::Device device = instance.GetDevice();
+    for (const auto& it : candidates) {
+        if (over_budget == 0) {
+            break;
+        }
+
+        const ImageAlloc& alloc = it->second.alloc;
+        VmaAllocationInfo alloc_info{};
+        vmaGetAllocationInfo(allocator, alloc.allocation, &alloc_info);
+        over_budget -= std::min<u64>(over_budget, alloc_info.size);
+
+        if (auto fb_it = clear_framebuffers.find(alloc.image_view); fb_it != clear_framebuffers.end()) {
+            device.destroyFramebuffer(fb_it->second);
+            clear_framebuffers.erase(fb_it);
+        }
+
+        destroyed_views.push_back(alloc.image_view);
+        device.destroyImageView(alloc.image_view);
+        vmaDestroyImage(allocator, alloc.image, alloc.allocation);
+        texture_recycler.erase(it);
+    }
+
+    return destroyed_views;
+}
+
+std::unique_ptr<StagingBuffer> TextureRuntime::AllocateReadback(u32 size) {
+    // Reuse the smallest recycled buffer that can hold the readback
+    if (auto it = readback_recycler.lower_bound(size); it != readback_recycler.end()) {
+        std::unique_ptr<StagingBuffer> buffer = std::move(it->second.buffer);
+        readback_recycler_size -= it->first;
+        readback_recycler.erase(it);
+        return buffer;
+    }
+
+    return std::make_unique<StagingBuffer>(instance, size, vk::BufferUsageFlagBits::eTransferDst,
+                                           true);
+}
+
+void TextureRuntime::RecycleReadback(std::unique_ptr<StagingBuffer>&& buffer) {
+    const u32 size = static_cast<u32>(buffer->mapped.size());
+    readback_recycler.emplace(size, RecycledReadback{
+        .buffer = std::move(buffer),
+        .fence_counter = scheduler.GetCurrentFenceCounter()
+    });
+    readback_recycler_size += size;
+    if (readback_recycler_size <= MAX_RECYCLED_READBACK_SIZE) {
+        return;
+    }
+
+    // Destroy buffers in the order they were recycled, skipping those still in use by the GPU
+    std::vector<decltype(readback_recycler)::iterator> candidates;
+    for (auto it = readback_recycler.begin(); it != readback_recycler.end(); it++) {
+        if (scheduler.IsFenceSignaled(it->second.fence_counter)) {
+            candidates.push_back(it);
+        }
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const auto& lhs, const auto& rhs) {
+        return lhs->second.fence_counter < rhs->second.fence_counter;
+    });
+
+    for (const auto& it : candidates) {
+        if (readback_recycler_size <= MAX_RECYCLED_READBACK_SIZE) {
+            break;
+        }
+        readback_recycler_size -= it->first;
+        readback_recycler.erase(it);
+    }
 }
 
 void TextureRuntime::FormatConvert(VideoCore::PixelFormat format,  bool upload,
@@ -228,8 +349,7 @@ bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
     const vk::ImageAspectFlags aspect = ToVkAspect(surface.type);
     renderpass_cache.ExitRenderpass();
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    Transition(command_buffer, surface.alloc, vk::ImageLayout::eTransferDstOptimal,
+    Transition(surface.alloc, vk::ImageLayout::eTransferDstOptimal,
                0, surface.alloc.levels, 0, surface.texture_type == VideoCore::TextureType::CubeMap ? 6 : 1);
 
     vk::ClearValue clear_value{};
@@ -254,13 +374,17 @@ bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
             .layerCount = 1
         };
 
-        if (aspect & vk::ImageAspectFlagBits::eColor) {
-            command_buffer.clearColorImage(surface.alloc.image, vk::ImageLayout::eTransferDstOptimal,
-                                           clear_value.color, range);
-        } else if (aspect & vk::ImageAspectFlagBits::eDepth || aspect & vk::ImageAspectFlagBits::eStencil) {
-            command_buffer.clearDepthStencilImage(surface.alloc.image, vk::ImageLayout::eTransferDstOptimal,
-                                                  clear_value.depthStencil, range);
-        }
+        scheduler.Record([image = surface.alloc.image, aspect, clear_value,
+                          range](vk::CommandBuffer command_buffer) {
+            if (aspect & vk::ImageAspectFlagBits::eColor) {
+                command_buffer.clearColorImage(image, vk::ImageLayout::eTransferDstOptimal,
+                                               clear_value.color, range);
+            } else if (aspect & vk::ImageAspectFlagBits::eDepth ||
+                       aspect & vk::ImageAspectFlagBits::eStencil) {
+                command_buffer.clearDepthStencilImage(image, vk::ImageLayout::eTransferDstOptimal,
+                                                      clear_value.depthStencil, range);
+            }
+        });
     } else {
         // For partial clears we begin a clear renderpass with the appropriate render area
         vk::RenderPass clear_renderpass{};
@@ -268,11 +392,11 @@ bool TextureRuntime::ClearTexture(Surface& surface, const VideoCore::TextureClea
         if (aspect & vk::ImageAspectFlagBits::eColor) {
             clear_renderpass = renderpass_cache.GetRenderpass(surface.pixel_format,
                                                               VideoCore::PixelFormat::Invalid, true);
-            Transition(command_buffer, alloc, vk::ImageLayout::eColorAttachmentOptimal, 0, alloc.levels);
+            Transition(alloc, vk::ImageLayout::eColorAttachmentOptimal, 0, alloc.levels);
         } else if (aspect & vk::ImageAspectFlagBits::eDepth || aspect & vk::ImageAspectFlagBits::eStencil) {
             clear_renderpass = renderpass_cache.GetRenderpass(VideoCore::PixelFormat::Invalid,
                                                               surface.pixel_format, true);
-            Transition(command_buffer, alloc, vk::ImageLayout::eDepthStencilAttachmentOptimal, 0, alloc.levels);
+            Transition(alloc, vk::ImageLayout::eDepthStencilAttachmentOptimal, 0, alloc.levels);
         }
 
         auto [it, new_framebuffer] = clear_framebuffers.try_emplace(alloc.image_view, vk::Framebuffer{});
@@ -329,12 +453,14 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest, const VideoCor
         .extent = {copy.extent.width, copy.extent.height, 1}
     };
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    Transition(command_buffer, source.alloc, vk::ImageLayout::eTransferSrcOptimal, 0, source.alloc.levels);
-    Transition(command_buffer, dest.alloc, vk::ImageLayout::eTransferDstOptimal, 0, dest.alloc.levels);
+    Transition(source.alloc, vk::ImageLayout::eTransferSrcOptimal, 0, source.alloc.levels);
+    Transition(dest.alloc, vk::ImageLayout::eTransferDstOptimal, 0, dest.alloc.levels);
 
-    command_buffer.copyImage(source.alloc.image, vk::ImageLayout::eTransferSrcOptimal,
-                             dest.alloc.image, vk::ImageLayout::eTransferDstOptimal, image_copy);
+    scheduler.Record([src_image = source.alloc.image, dst_image = dest.alloc.image,
+                      image_copy](vk::CommandBuffer command_buffer) {
+        command_buffer.copyImage(src_image, vk::ImageLayout::eTransferSrcOptimal,
+                                 dst_image, vk::ImageLayout::eTransferDstOptimal, image_copy);
+    });
 
     return true;
 }
@@ -342,10 +468,9 @@ bool TextureRuntime::CopyTextures(Surface& source, Surface& dest, const VideoCor
 bool TextureRuntime::BlitTextures(Surface& source, Surface& dest, const VideoCore::TextureBlit& blit) {
     renderpass_cache.ExitRenderpass();
 
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
-    Transition(command_buffer, source.alloc, vk::ImageLayout::eTransferSrcOptimal,
+    Transition(source.alloc, vk::ImageLayout::eTransferSrcOptimal,
                0, source.alloc.levels, 0, source.texture_type == VideoCore::TextureType::CubeMap ? 6 : 1);
-    Transition(command_buffer, dest.alloc, vk::ImageLayout::eTransferDstOptimal,
+    Transition(dest.alloc, vk::ImageLayout::eTransferDstOptimal,
                0, dest.alloc.levels, 0, dest.texture_type == VideoCore::TextureType::CubeMap ? 6 : 1);
 
     const std::array source_offsets = {
@@ -375,9 +500,12 @@ bool TextureRuntime::BlitTextures(Surface& source, Surface& dest, const VideoCor
       .dstOffsets = dest_offsets
     };
 
-    command_buffer.blitImage(source.alloc.image, vk::ImageLayout::eTransferSrcOptimal,
-                             dest.alloc.image, vk::ImageLayout::eTransferDstOptimal,
-                             blit_area, vk::Filter::eLinear);
+    scheduler.Record([src_image = source.alloc.image, dst_image = dest.alloc.image,
+                      blit_area](vk::CommandBuffer command_buffer) {
+        command_buffer.blitImage(src_image, vk::ImageLayout::eTransferSrcOptimal,
+                                 dst_image, vk::ImageLayout::eTransferDstOptimal,
+                                 blit_area, vk::Filter::eLinear);
+    });
 
     return true;
 }
@@ -391,10 +519,9 @@ void TextureRuntime::GenerateMipmaps(Surface& surface, u32 max_level) {
 
     const u32 levels = std::bit_width(std::max(surface.width, surface.height));
     vk::ImageAspectFlags aspect = ToVkAspect(surface.type);
-    vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
     for (u32 i = 1; i < levels; i++) {
-        Transition(command_buffer, surface.alloc, vk::ImageLayout::eTransferSrcOptimal, i - 1, 1);
-        Transition(command_buffer, surface.alloc, vk::ImageLayout::eTransferDstOptimal, i, 1);
+        Transition(surface.alloc, vk::ImageLayout::eTransferSrcOptimal, i - 1, 1);
+        Transition(surface.alloc, vk::ImageLayout::eTransferDstOptimal, i, 1);
 
         const std::array source_offsets = {
             vk::Offset3D{0, 0, 0},
@@ -424,15 +551,16 @@ void TextureRuntime::GenerateMipmaps(Surface& surface, u32 max_level) {
           .dstOffsets = dest_offsets
         };
 
-        command_buffer.blitImage(surface.alloc.image, vk::ImageLayout::eTransferSrcOptimal,
-                                 surface.alloc.image, vk::ImageLayout::eTransferDstOptimal,
-                                 blit_area, vk::Filter::eLinear);
+        scheduler.Record([image = surface.alloc.image, blit_area](vk::CommandBuffer command_buffer) {
+            command_buffer.blitImage(image, vk::ImageLayout::eTransferSrcOptimal,
+                                     image, vk::ImageLayout::eTransferDstOptimal,
+                                     blit_area, vk::Filter::eLinear);
+        });
     }
 }
 
-void TextureRuntime::Transition(vk::CommandBuffer command_buffer, ImageAlloc& alloc,
-                                vk::ImageLayout new_layout, u32 level, u32 level_count,
-                                u32 layer, u32 layer_count) {
+void TextureRuntime::Transition(ImageAlloc& alloc, vk::ImageLayout new_layout, u32 level,
+                                u32 level_count, u32 layer, u32 layer_count) {
     if (new_layout == alloc.layout || !alloc.image) {
         return;
     }
@@ -519,9 +647,11 @@ void TextureRuntime::Transition(vk::CommandBuffer command_buffer, ImageAlloc& al
         }
     };
 
-    command_buffer.pipelineBarrier(source.stage, dest.stage,
-                                   vk::DependencyFlagBits::eByRegion,
-                                   {}, {}, barrier);
+    scheduler.Record([src_stage = source.stage, dst_stage = dest.stage,
+                      barrier](vk::CommandBuffer command_buffer) {
+        command_buffer.pipelineBarrier(src_stage, dst_stage, vk::DependencyFlagBits::eByRegion,
+                                       {}, {}, barrier);
+    });
 
     alloc.layout = new_layout;
 }
@@ -546,6 +676,11 @@ Surface::~Surface() {
 
         runtime.Recycle(tag, std::move(alloc));
     }
+
+    // A readback might still be in flight, recycled buffers are only written by later copies
+    if (readback_buffer) {
+        runtime.RecycleReadback(std::move(readback_buffer));
+    }
 }
 
 MICROPROFILE_DEFINE(Vulkan_Upload, "VulkanSurface", "Texture Upload", MP_RGB(128, 192, 64));
@@ -558,7 +693,6 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload, const StagingDa
     if (is_scaled) {
         ScaledUpload(upload);
     } else {
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
         const VideoCore::Rect2D rect = upload.texture_rect;
         const vk::BufferImageCopy copy_region = {
             .bufferOffset = staging.buffer_offset,
@@ -574,11 +708,13 @@ void Surface::Upload(const VideoCore::BufferTextureCopy& upload, const StagingDa
             .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1}
         };
 
-        runtime.Transition(command_buffer, alloc, vk::ImageLayout::eTransferDstOptimal, 0, alloc.levels,
+        runtime.Transition(alloc, vk::ImageLayout::eTransferDstOptimal, 0, alloc.levels,
                            0, texture_type == VideoCore::TextureType::CubeMap ? 6 : 1);
-        command_buffer.copyBufferToImage(staging.buffer, alloc.image,
-                                         vk::ImageLayout::eTransferDstOptimal,
-                                         copy_region);
+        scheduler.Record([buffer = staging.buffer, image = alloc.image,
+                          copy_region](vk::CommandBuffer command_buffer) {
+            command_buffer.copyBufferToImage(buffer, image, vk::ImageLayout::eTransferDstOptimal,
+                                             copy_region);
+        });
     }
 
     InvalidateAllWatcher();
@@ -601,7 +737,6 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download, const Stagi
         u32 region_count = 0;
         std::array<vk::BufferImageCopy, 2> copy_regions;
 
-        vk::CommandBuffer command_buffer = scheduler.GetRenderCommandBuffer();
         const VideoCore::Rect2D rect = download.texture_rect;
         vk::BufferImageCopy copy_region = {
             .bufferOffset = staging.buffer_offset,
@@ -631,18 +766,111 @@ void Surface::Download(const VideoCore::BufferTextureCopy& download, const Stagi
             }
         }
 
-        runtime.Transition(command_buffer, alloc, vk::ImageLayout::eTransferSrcOptimal, download.texture_level, 1);
+        runtime.Transition(alloc, vk::ImageLayout::eTransferSrcOptimal, download.texture_level, 1);
 
         // Copy pixel data to the staging buffer
-        command_buffer.copyImageToBuffer(alloc.image, vk::ImageLayout::eTransferSrcOptimal,
-                                         staging.buffer, region_count, copy_regions.data());
+        scheduler.Record([image = alloc.image, buffer = staging.buffer, region_count,
+                          copy_regions](vk::CommandBuffer command_buffer) {
+            command_buffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal,
+                                             buffer, region_count, copy_regions.data());
+        });
 
+        // Lock this data until the slot is reused. The submission switches slots, so the
+        // offset must be claimed on the slot that recorded the copy
+        runtime.staging_offsets[scheduler.GetCurrentSlotIndex()] += staging.size;
+
+        // Flush waits only on this submission, older slots may still be executing
         scheduler.Submit(SubmitMode::Flush);
+        runtime.OnSlotSwitch(scheduler.GetCurrentSlotIndex());
     }
+}
 
-    // Lock this data until the next scheduler switch
-    const u32 current_slot = scheduler.GetCurrentSlotIndex();
-    runtime.staging_offsets[current_slot] += staging.size;
+MICROPROFILE_DEFINE(Vulkan_Readback, "VulkanSurface", "Texture Readback", MP_RGB(128, 64, 192));
+bool Surface::QueueReadback(const VideoCore::BufferTextureCopy& readback) {
+    MICROPROFILE_SCOPE(Vulkan_Readback);
+
+    // Scaled surfaces and depth-stencil downloads are not supported by Download either
+    if (res_scale != 1 || readback.texture_level != 0 ||
+        (alloc.aspect & vk::ImageAspectFlagBits::eStencil)) {
+        return false;
+    }
+
+    // Size the buffer for the entire surface so it can be reused for any region
+    const u32 bytes_per_pixel = VideoCore::GetBytesPerPixel(pixel_format);
+    if (!readback_buffer) {
+        readback_buffer = runtime.AllocateReadback(width * height * bytes_per_pixel);
+    }
+
+    runtime.renderpass_cache.ExitRenderpass();
+
+    const VideoCore::Rect2D rect = readback.texture_rect;
+    const vk::ImageAspectFlags aspect = (alloc.aspect & vk::ImageAspectFlagBits::eColor) ?
+            vk::ImageAspectFlags{vk::ImageAspectFlagBits::eColor} :
+            vk::ImageAspectFlags{vk::ImageAspectFlagBits::eDepth};
+
+    const vk::BufferImageCopy copy_region = {
+        .bufferOffset = 0,
+        .bufferRowLength = rect.GetWidth(),
+        .bufferImageHeight = rect.GetHeight(),
+        .imageSubresource = {
+            .aspectMask = aspect,
+            .mipLevel = 0,
+            .baseArrayLayer = 0,
+            .layerCount = 1
+        },
+        .imageOffset = {static_cast<s32>(rect.left), static_cast<s32>(rect.bottom), 0},
+        .imageExtent = {rect.GetWidth(), rect.GetHeight(), 1}
+    };
+
+    runtime.Transition(alloc, vk::ImageLayout::eTransferSrcOptimal, 0, 1);
+
+    scheduler.Record([image = alloc.image, buffer = readback_buffer->buffer,
+                      copy_region](vk::CommandBuffer command_buffer) {
+        // An older readback to the same buffer may still be executing
+        const vk::MemoryBarrier write_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eTransferWrite
+        };
+
+        const vk::MemoryBarrier host_barrier = {
+            .srcAccessMask = vk::AccessFlagBits::eTransferWrite,
+            .dstAccessMask = vk::AccessFlagBits::eHostRead
+        };
+
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                       vk::PipelineStageFlagBits::eTransfer,
+                                       vk::DependencyFlagBits::eByRegion,
+                                       write_barrier, {}, {});
+        command_buffer.copyImageToBuffer(image, vk::ImageLayout::eTransferSrcOptimal,
+                                         buffer, copy_region);
+        command_buffer.pipelineBarrier(vk::PipelineStageFlagBits::eTransfer,
+                                       vk::PipelineStageFlagBits::eHost,
+                                       vk::DependencyFlagBits::eByRegion,
+                                       host_barrier, {}, {});
+    });
+
+    readback_fence_counter = scheduler.GetCurrentFenceCounter();
+    readback_size = rect.GetWidth() * rect.GetHeight() * bytes_per_pixel;
+    return true;
+}
+
+std::span<std::byte> Surface::ReadbackData() {
+    MICROPROFILE_SCOPE(Vulkan_Readback);
+
+    if (!readback_buffer) {
+        return {};
+    }
+
+    // The copy was recorded to the current slot, so it has to be submitted first
+    if (readback_fence_counter == scheduler.GetCurrentFenceCounter()) {
+        scheduler.Submit(SubmitMode::Flush);
+        runtime.OnSlotSwitch(scheduler.GetCurrentSlotIndex());
+    } else if (!scheduler.IsFenceSignaled(readback_fence_counter)) {
+        scheduler.WaitFence(readback_fence_counter);
+    }
+
+    vmaInvalidateAllocation(instance.GetAllocator(), readback_buffer->allocation, 0, readback_size);
+    return readback_buffer->mapped.first(readback_size);
 }
 
 void Surface::ScaledDownload(const VideoCore::BufferTextureCopy& download) {
@@ -3,8 +3,10 @@
 // Refer to the license.txt file included.
 
 #pragma once
+#include <map>
 #include <span>
 #include <set>
+#include <vector>
 #include <vulkan/vulkan_hash.hpp>
 #include "video_core/rasterizer_cache/rasterizer_cache.h"
 #include "video_core/rasterizer_cache/surface_base.h"
@@ -30,6 +32,16 @@ struct ImageAlloc {
     u32 levels = 1;
 };
 
+struct RecycledImage {
+    ImageAlloc alloc;
+    u64 fence_counter = 0; ///< Fence of the last submission that might use the image
+};
+
+struct RecycledReadback {
+    std::unique_ptr<StagingBuffer> buffer;
+    u64 fence_counter = 0; ///< Fence of the last submission that might write to the buffer
+};
+
 class Instance;
 class RenderpassCache;
 class Surface;
@@ -55,13 +67,26 @@ public:
     /// Takes back ownership of the allocation for recycling
     void Recycle(const VideoCore::HostTextureTag tag, ImageAlloc&& alloc);
 
+    /// Returns the amount of device memory in bytes used above the configured budget
+    [[nodiscard]] u64 GetMemoryOverBudget() const;
+
+    /// Destroys the least recently recycled images the GPU is done with until memory usage
+    /// fits the budget. Returns the views of the destroyed images
+    std::vector<vk::ImageView> TrimRecycler();
+
+    /// Returns a host visible buffer of at least size bytes for asynchronous readbacks
+    [[nodiscard]] std::unique_ptr<StagingBuffer> AllocateReadback(u32 size);
+
+    /// Takes back ownership of the readback buffer for recycling. The least recently recycled
+    /// buffers the GPU is done with are destroyed when the recycled buffers grow too large
+    void RecycleReadback(std::unique_ptr<StagingBuffer>&& buffer);
+
     /// Performs required format convertions on the staging data
     void FormatConvert(VideoCore::PixelFormat format,  bool upload,
                        std::span<std::byte> source, std::span<std::byte> dest);
 
-    /// Transitions the mip level range of the surface to new_layout
-    void Transition(vk::CommandBuffer command_buffer, ImageAlloc& alloc,
-                    vk::ImageLayout new_layout, u32 level, u32 level_count,
+    /// Records a transition of the mip level range of the surface to new_layout
+    void Transition(ImageAlloc& alloc, vk::ImageLayout new_layout, u32 level, u32 level_count,
                     u32 layer = 0, u32 layer_count = 1);
 
     /// Fills the rectangle of the texture with the clear value provided
@@ -97,7 +122,9 @@ private:
     RenderpassCache& renderpass_cache;
     std::array<std::unique_ptr<StagingBuffer>, SCHEDULER_COMMAND_COUNT> staging_buffers;
     std::array<u32, SCHEDULER_COMMAND_COUNT> staging_offsets{};
-    std::unordered_multimap<VideoCore::HostTextureTag, ImageAlloc> texture_recycler;
+    std::unordered_multimap<VideoCore::HostTextureTag, RecycledImage> texture_recycler;
+    std::multimap<u32, RecycledReadback> readback_recycler;
+    u64 readback_recycler_size = 0;
     std::unordered_map<vk::ImageView, vk::Framebuffer> clear_framebuffers;
 };
 
@@ -114,6 +141,13 @@ public:
     /// Downloads pixel data to staging from a rectangle region of the surface texture
     void Download(const VideoCore::BufferTextureCopy& download, const StagingData& staging);
 
+    /// Records a copy of a rectangle region of the surface texture to host memory without
+    /// waiting for it. Returns false if the region cannot be read back asynchronously
+    bool QueueReadback(const VideoCore::BufferTextureCopy& readback);
+
+    /// Returns the pixel data of the last queued readback, waiting for the copy if needed
+    std::span<std::byte> ReadbackData();
+
 private:
     /// Downloads scaled image by downscaling the requested rectangle
     void ScaledDownload(const VideoCore::BufferTextureCopy& download);
@@ -131,6 +165,10 @@ private:
 
     ImageAlloc alloc{};
     vk::Format internal_format = vk::Format::eUndefined;
+
+    std::unique_ptr<StagingBuffer> readback_buffer;
+    u64 readback_fence_counter = 0;
+    u32 readback_size = 0;
 };
 
 struct Traits {
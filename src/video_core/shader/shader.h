@@ -4,6 +4,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <cstddef>
 #include <functional>
@@ -280,6 +281,34 @@ struct ShaderSetup {
         const void* cached_shader = nullptr;
     } engine_data;
 
+    /// Tracks which uniforms changed since the hardware renderer last uploaded them
+    struct UniformsDirty {
+        u32 float_begin = 0;
+        u32 float_end = 96;
+        bool bools = true;
+        bool ints = true;
+
+        bool Any() const {
+            return float_begin < float_end || bools || ints;
+        }
+
+        void MarkAll() {
+            *this = {};
+        }
+
+        void Clear() {
+            float_begin = 96;
+            float_end = 0;
+            bools = false;
+            ints = false;
+        }
+    } uniforms_dirty;
+
+    void MarkFloatUniformDirty(u32 index) {
+        uniforms_dirty.float_begin = std::min(uniforms_dirty.float_begin, index);
+        uniforms_dirty.float_end = std::max(uniforms_dirty.float_end, index + 1);
+    }
+
     void MarkProgramCodeDirty() {
         program_code_hash_dirty = true;
     }
@@ -320,6 +349,9 @@ private:
         ar& swizzle_data_hash_dirty;
         ar& program_code_hash;
         ar& swizzle_data_hash;
+        if (Archive::is_loading::value) {
+            uniforms_dirty.MarkAll();
+        }
     }
 };
 
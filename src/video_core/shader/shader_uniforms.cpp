@@ -22,4 +22,33 @@ void PicaUniformsData::SetFromRegs(const Pica::ShaderRegs& regs, const Pica::Sha
                    });
 }
 
+bool PicaUniformsData::SyncDirtyFromRegs(const Pica::ShaderRegs& regs,
+                                         Pica::Shader::ShaderSetup& setup) {
+    auto& dirty = setup.uniforms_dirty;
+    if (!dirty.Any()) {
+        return false;
+    }
+
+    if (dirty.bools) {
+        std::transform(std::begin(setup.uniforms.b), std::end(setup.uniforms.b),
+                       std::begin(bools),
+                       [](bool value) -> BoolAligned { return {value ? 1 : 0}; });
+    }
+    if (dirty.ints) {
+        std::transform(std::begin(regs.int_uniforms), std::end(regs.int_uniforms), std::begin(i),
+                       [](const auto& value) -> Common::Vec4u {
+                           return {value.x.Value(), value.y.Value(), value.z.Value(),
+                                   value.w.Value()};
+                       });
+    }
+    for (u32 index = dirty.float_begin; index < dirty.float_end; ++index) {
+        const auto& value = setup.uniforms.f[index];
+        f[index] = {value.x.ToFloat32(), value.y.ToFloat32(), value.z.ToFloat32(),
+                    value.w.ToFloat32()};
+    }
+
+    dirty.Clear();
+    return true;
+}
+
 } // namespace Pica::Shader
@@ -78,6 +78,12 @@ static_assert(sizeof(UniformData) < 16384,
 struct PicaUniformsData {
     void SetFromRegs(const ShaderRegs& regs, const ShaderSetup& setup);
 
+    /**
+     * Updates only the uniforms marked dirty in the shader setup and clears the dirty state.
+     * @returns true if any uniform was updated.
+     */
+    bool SyncDirtyFromRegs(const ShaderRegs& regs, ShaderSetup& setup);
+
     struct BoolAligned {
         alignas(16) int b;
     };